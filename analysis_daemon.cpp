@@ -0,0 +1,268 @@
+#include "analysis_daemon.h"
+#include "analysis_pipeline.h"
+#include "solver/SolverProcess.h"
+#include "logging/Logger.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <chrono>
+#include <filesystem>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Remove the socket file of an earlier run that is no longer served; anything
+// else at the path (a regular file, a live daemon's socket) is left alone
+int removeStaleSocket(const std::string& socket_path, const sockaddr_un& address) {
+    struct stat status;
+    if (lstat(socket_path.c_str(), &status) != 0) {
+        if (errno == ENOENT) return 0;
+        std::cerr << "エラー: ソケットのパスを確認できませんでした: " << socket_path
+                  << " (" << std::strerror(errno) << ")" << std::endl;
+        return 1;
+    }
+    if (!S_ISSOCK(status.st_mode)) {
+        std::cerr << "エラー: ソケットではないファイルが存在します: " << socket_path << std::endl;
+        return 1;
+    }
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        std::cerr << "エラー: ソケットを作成できませんでした: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    int connected = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    int error = errno;
+    close(probe);
+    if (connected == 0) {
+        std::cerr << "エラー: 別のデーモンが待ち受けています: " << socket_path << std::endl;
+        return 1;
+    }
+    if (error != ECONNREFUSED) {
+        std::cerr << "エラー: ソケットの状態を確認できませんでした: " << socket_path
+                  << " (" << std::strerror(error) << ")" << std::endl;
+        return 1;
+    }
+    if (unlink(socket_path.c_str()) != 0 && errno != ENOENT) {
+        std::cerr << "エラー: 古いソケットを削除できませんでした: " << socket_path
+                  << " (" << std::strerror(errno) << ")" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+AnalysisDaemon::AnalysisDaemon()
+    : jobs_(0)
+    , running_(false)
+{
+}
+
+AnalysisDaemon::~AnalysisDaemon() {
+}
+
+void AnalysisDaemon::setCacheCapacity(std::size_t capacity) {
+    model_cache_.setCapacity(capacity);
+}
+
+int AnalysisDaemon::run(const std::string& socket_path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "エラー: ソケットのパスが長すぎます: " << socket_path << std::endl;
+        return 1;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    // A stale socket file of an earlier run would make bind fail
+    if (removeStaleSocket(socket_path, address) != 0) {
+        return 1;
+    }
+    // Close-on-exec, so neither the listener nor a client leaks into the solver
+    // and meshing children and keeps the socket alive after the daemon exits
+    int server = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (server < 0) {
+        std::cerr << "エラー: ソケットを作成できませんでした: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 8) != 0) {
+        std::cerr << "エラー: ソケットを待ち受けできませんでした: " << socket_path
+                  << " (" << std::strerror(errno) << ")" << std::endl;
+        close(server);
+        return 1;
+    }
+
+    if (model_cache_.initialize() != 0) {
+        close(server);
+        unlink(socket_path.c_str());
+        return 1;
+    }
+    std::cout << "デーモンを起動しました: " << socket_path
+              << " (キャッシュ容量 " << model_cache_.getCapacity() << " モデル)" << std::endl;
+
+    running_ = true;
+    while (running_) {
+        int client = accept4(server, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "エラー: 接続を受け付けできませんでした: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        serveConnection(client);
+        close(client);
+    }
+
+    close(server);
+    unlink(socket_path.c_str());
+    model_cache_.finalize();
+    std::cout << "デーモンを終了しました (" << jobs_ << " ジョブ)" << std::endl;
+    return 0;
+}
+
+void AnalysisDaemon::serveConnection(int client) {
+    std::string buffer;
+    char chunk[4096];
+    while (running_) {
+        ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) break;
+        buffer.append(chunk, static_cast<std::size_t>(received));
+
+        std::size_t newline;
+        while (running_ && (newline = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                handleRequest(client, line);
+            }
+        }
+    }
+}
+
+void AnalysisDaemon::handleRequest(int client, const std::string& line) {
+    nlohmann::json request;
+    try {
+        request = nlohmann::json::parse(line);
+    } catch (const std::exception& e) {
+        send(client, {{"status", "error"}, {"message", std::string("invalid JSON: ") + e.what()}});
+        return;
+    }
+    if (!request.is_object()) {
+        send(client, {{"status", "error"}, {"message", "request must be a JSON object"}});
+        return;
+    }
+
+    std::string command = request.value("command", std::string("run"));
+    if (command == "stats") {
+        send(client, getStatistics());
+    } else if (command == "shutdown") {
+        send(client, {{"status", "shutdown"}, {"jobs", jobs_}});
+        running_ = false;
+    } else if (command == "run") {
+        runJob(client, request);
+    } else {
+        send(client, {{"status", "error"}, {"message", "unknown command: " + command}});
+    }
+}
+
+void AnalysisDaemon::runJob(int client, const nlohmann::json& request) {
+    std::size_t job = ++jobs_;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // Relative paths of the job, including the outputs, are taken from its working directory
+    std::error_code ec;
+    std::filesystem::path previous = std::filesystem::current_path(ec);
+    std::string workdir = request.value("workdir", std::string());
+    if (!workdir.empty()) {
+        std::filesystem::current_path(workdir, ec);
+        if (ec) {
+            send(client, {{"job", job}, {"status", "error"},
+                          {"message", "cannot enter workdir " + workdir + ": " + ec.message()}});
+            return;
+        }
+    }
+
+    // The logging level of a job lasts for that job only
+    LogLevel previous_level = Logger::instance().getLevel();
+    int result = EXIT_FAILURE;
+    std::map<std::string, std::string> outputs;
+    try {
+        if (!request.contains("config")) {
+            throw std::runtime_error("missing \"config\"");
+        }
+        const nlohmann::json& config_json = request["config"];
+        SimulationConfig config = config_json.is_string()
+            ? SimulationConfig::fromJsonFile(config_json.get<std::string>())
+            : SimulationConfig::fromJson(config_json);
+        LogLevel log_level;
+        if (!parseLogLevel(config.logging.level, log_level)) {
+            throw std::runtime_error("unknown logging.level: " + config.logging.level);
+        }
+        Logger::instance().setLevel(log_level);
+
+        std::cout << "ジョブ " << job << " を開始します: " << config.step_file << std::endl;
+        SolverProcess::resetCancel();
+        PipelineProgress progress = [&](const std::string& stage, const std::string& status,
+                                        const nlohmann::json& detail) {
+            nlohmann::json message = {{"job", job}, {"stage", stage}, {"status", status}, {"elapsed_ms", elapsed()}};
+            if (!detail.is_null()) {
+                message["progress"] = detail;
+            }
+            // Nobody is waiting for the results once the client has gone
+            if (!send(client, message)) {
+                SolverProcess::cancel();
+            }
+        };
+        result = runAnalysisPipeline(config, progress, outputs, &model_cache_);
+    } catch (const std::exception& e) {
+        std::cerr << "エラー: ジョブ " << job << ": " << e.what() << std::endl;
+        send(client, {{"job", job}, {"status", "error"}, {"message", e.what()}});
+        Logger::instance().setLevel(previous_level);
+        std::filesystem::current_path(previous, ec);
+        return;
+    }
+    Logger::instance().setLevel(previous_level);
+    std::filesystem::current_path(previous, ec);
+
+    std::cout << "ジョブ " << job << " 完了 (" << elapsed() << " ms)" << std::endl;
+    send(client, {{"job", job}, {"status", result == 0 ? "done" : "failed"}, {"result", result},
+                  {"outputs", outputs}, {"elapsed_ms", elapsed()}});
+}
+
+nlohmann::json AnalysisDaemon::getStatistics() const {
+    const ModelCacheStatistics& statistics = model_cache_.getStatistics();
+    return {
+        {"status", "stats"},
+        {"jobs", jobs_},
+        {"models", model_cache_.getSize()},
+        {"capacity", model_cache_.getCapacity()},
+        {"mesh_hits", statistics.mesh_hits},
+        {"geometry_hits", statistics.geometry_hits},
+        {"misses", statistics.misses},
+        {"evictions", statistics.evictions}
+    };
+}
+
+bool AnalysisDaemon::send(int client, const nlohmann::json& message) {
+    std::string line = message.dump() + "\n";
+    const char* data = line.data();
+    std::size_t remaining = line.size();
+    while (remaining > 0) {
+        // A client that went away must not kill the daemon with SIGPIPE
+        ssize_t sent = ::send(client, data, remaining, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        remaining -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef ANALYSIS_DAEMON_H
+#define ANALYSIS_DAEMON_H
+
+#include <string>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include "step2inp/ModelCache.h"
+
+/**
+ * Long-running analysis server on a Unix domain socket.
+ *
+ * gmsh stays initialized and recently used geometries and meshes are kept in a
+ * ModelCache, so repeated jobs on the same STEP file skip import and meshing.
+ * Jobs run one at a time (gmsh is not thread-safe).
+ *
+ * Protocol: newline-delimited JSON in both directions.
+ *   {"config": "<file>" | {...}, "workdir": "<dir>"}   run a job; paths are relative to workdir
+ *   {"command": "stats"}                               cache statistics
+ *   {"command": "shutdown"}                            stop the server
+ * A job answers with one line per stage transition
+ *   {"job": n, "stage": "inp", "status": "started", "elapsed_ms": ...}
+ * followed by
+ *   {"job": n, "status": "done" | "failed", "result": code, "outputs": {...}, "elapsed_ms": ...}
+ */
+class AnalysisDaemon {
+public:
+    AnalysisDaemon();
+    ~AnalysisDaemon();
+
+    // Number of gmsh models (STEP files) kept alive
+    void setCacheCapacity(std::size_t capacity);
+
+    // Serve requests on socket_path until a shutdown request
+    int run(const std::string& socket_path);
+
+private:
+    void serveConnection(int client);
+    void handleRequest(int client, const std::string& line);
+    void runJob(int client, const nlohmann::json& request);
+    nlohmann::json getStatistics() const;
+
+    static bool send(int client, const nlohmann::json& message);
+
+    ModelCache model_cache_;
+    std::size_t jobs_;
+    bool running_;
+};
+
+#endif // ANALYSIS_DAEMON_H
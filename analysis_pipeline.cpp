@@ -0,0 +1,504 @@
+#include "analysis_pipeline.h"
+#include "frd2vtu.h"
+#include "solver/SolverCache.h"
+#include "solver/SolverProcess.h"
+#include <iostream>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+// Identity of a unit-load solution: every input that changes it plus the FRD it produced
+std::string describeUnitLoadSolution(const SimulationConfig& config,
+                                     const std::vector<UnitLoadCase>& unit_cases,
+                                     const std::string& frd_file) {
+    std::error_code ec;
+    nlohmann::json key;
+    key["step_file"] = config.step_file;
+    key["step_size"] = std::filesystem::file_size(config.step_file, ec);
+    key["step_mtime"] = std::filesystem::last_write_time(config.step_file, ec).time_since_epoch().count();
+    key["mesh"] = config.mesh;
+    key["resources"] = config.resources;  // The budget may coarsen the mesh
+    key["solver"] = config.solver;
+    key["constraints"] = config.constraints;
+    key["materials"] = config.materials;
+    key["cases"] = nlohmann::json::array();
+    for (const auto& unit_case : unit_cases) {
+        key["cases"].push_back({unit_case.step, unit_case.surface_number, unit_case.axis});
+    }
+    key["frd_size"] = std::filesystem::file_size(frd_file, ec);
+    key["frd_mtime"] = std::filesystem::last_write_time(frd_file, ec).time_since_epoch().count();
+    return key.dump();
+}
+
+// Resource use and outcome of one solver run, kept next to its results
+void writeRunSummary(const std::string& filename, const SolverConfig& solver, const SolverRunSummary& run) {
+    nlohmann::json summary = {
+        {"command", solver.command},
+        {"exit_code", run.exit_code},
+        {"cancelled", run.cancelled},
+        {"timed_out", run.timed_out},
+        {"memory_exceeded", run.memory_exceeded},
+        {"wall_seconds", run.wall_seconds},
+        {"peak_rss_mb", run.peak_rss_kb / 1024.0},
+        {"steps", run.steps},
+        {"increments", run.increments},
+        {"iterations", run.iterations},
+        {"timeout_seconds", solver.timeout_seconds},
+        {"memory_limit_mb", solver.memory_limit_mb}
+    };
+    std::ofstream file(filename);
+    file << summary.dump(2) << "\n";
+    if (!file.good()) {
+        std::cerr << "警告: 実行サマリーを書き込めませんでした: " << filename << std::endl;
+    }
+}
+
+} // namespace
+
+int resolveConfigFaces(SimulationConfig& config, ModelCache* model_cache) {
+    auto toSelector = [](const FaceSelectConfig& select) {
+        FaceSelector selector;
+        selector.point = select.point;
+        selector.box = select.box;
+        selector.normal = select.normal;
+        selector.plane_point = select.plane_point;
+        selector.plane_normal = select.plane_normal;
+        selector.tolerance = select.tolerance;
+        selector.angle_tolerance = select.angle_tolerance;
+        return selector;
+    };
+
+    std::vector<FaceSelector> selectors;
+    for (const auto& fixed_face : config.constraints.fixed_faces) {
+        if (!fixed_face.select.empty()) {
+            selectors.push_back(toSelector(fixed_face.select));
+        } else if (fixed_face.surface_id <= 0) {
+            std::cerr << "エラー: " << fixed_face.name << " に surface_id または select を指定してください" << std::endl;
+            return 1;
+        }
+    }
+    for (const auto& load : config.loads.applied_loads) {
+        if (!load.select.empty()) {
+            selectors.push_back(toSelector(load.select));
+        } else if (load.surface_id <= 0) {
+            std::cerr << "エラー: " << load.name << " に surface_id または select を指定してください" << std::endl;
+            return 1;
+        }
+    }
+    if (config.constraints.fixed_faces.empty() && config.loads.applied_loads.empty() &&
+        config.mesh.refinement.surfaces.empty() && config.mesh.shell.surfaces.empty()) {
+        return 0;
+    }
+    for (const auto& selector : selectors) {
+        if (!selector.isValid()) {
+            std::cerr << "エラー: select の指定が不正です (point/normal は3要素, box は6要素)" << std::endl;
+            return 1;
+        }
+    }
+
+    Step2Inp resolver;
+    resolver.setModelCache(model_cache);
+    std::vector<std::vector<int>> surfaces;
+    if (resolver.resolveFaces(config.step_file, selectors, surfaces) != 0) {
+        return 1;
+    }
+
+    // Faces given by number are numbered as in the STEP file; an assembly is
+    // renumbered when its bodies are fragmented
+    const MeshGenerator& generator = resolver.getMeshGenerator();
+    auto mapSurfaces = [&generator](std::vector<int>& surface_ids) {
+        for (int& surface_id : surface_ids) {
+            if (generator.mapImportedSurface(surface_id, surface_id) != 0) return 1;
+        }
+        return 0;
+    };
+    if (mapSurfaces(config.mesh.refinement.surfaces) != 0 || mapSurfaces(config.mesh.shell.surfaces) != 0) {
+        return 1;
+    }
+
+    // A fixed selection may cover several faces; a load needs exactly one
+    std::size_t next = 0;
+    std::vector<FixedFace> fixed_faces;
+    for (auto fixed_face : config.constraints.fixed_faces) {
+        if (fixed_face.select.empty()) {
+            if (generator.mapImportedSurface(fixed_face.surface_id, fixed_face.surface_id) != 0) {
+                return 1;
+            }
+            fixed_faces.push_back(fixed_face);
+            continue;
+        }
+        const std::vector<int>& matches = surfaces[next++];
+        if (matches.empty()) {
+            std::cerr << "エラー: " << fixed_face.name << " に一致する面がありません" << std::endl;
+            return 1;
+        }
+        for (int surface : matches) {
+            FixedFace resolved = fixed_face;
+            resolved.surface_id = surface;
+            fixed_faces.push_back(resolved);
+        }
+    }
+    config.constraints.fixed_faces = fixed_faces;
+
+    for (auto& load : config.loads.applied_loads) {
+        if (load.select.empty()) {
+            if (generator.mapImportedSurface(load.surface_id, load.surface_id) != 0) {
+                return 1;
+            }
+            continue;
+        }
+        const std::vector<int>& matches = surfaces[next++];
+        if (matches.size() != 1) {
+            std::cerr << "エラー: " << load.name << " は1つの面に一致する必要があります ("
+                      << matches.size() << " 面に一致)" << std::endl;
+            return 1;
+        }
+        load.surface_id = matches[0];
+    }
+    return 0;
+}
+
+int runAnalysisPipeline(SimulationConfig config, const PipelineProgress& progress,
+                        std::map<std::string, std::string>& outputs,
+                        ModelCache* model_cache) {
+    auto notify = [&progress](const std::string& stage, const std::string& status,
+                              const nlohmann::json& detail = nullptr) {
+        if (progress) progress(stage, status, detail);
+    };
+
+    // Without a caller's cache, one for this run lets the conversion reuse the
+    // geometry imported for the face selection instead of importing it again
+    ModelCache run_cache;
+    if (!model_cache) {
+        run_cache.setCapacity(1);
+        if (run_cache.initialize() != 0) {
+            return EXIT_FAILURE;
+        }
+        model_cache = &run_cache;
+    }
+
+    // Turn geometric face selections into surface ids
+    notify("faces", "started");
+    if (resolveConfigFaces(config, model_cache) != 0) {
+        notify("faces", "failed");
+        return EXIT_FAILURE;
+    }
+    notify("faces", "done");
+    
+    std::string step_file = config.step_file;
+    
+    // Create constraint conditions from config
+    std::vector<ConstraintCondition> constraints;
+    for (const auto& fixed_face : config.constraints.fixed_faces) {
+        constraints.push_back(createConstraintCondition(fixed_face.surface_id));
+    }
+    
+    // Create load conditions from config
+    std::vector<LoadCondition> loads;
+    for (const auto& load : config.loads.applied_loads) {
+        std::vector<double> direction = {load.direction.x, load.direction.y, load.direction.z};
+        loads.push_back(createLoadCondition(load.surface_id, load.magnitude, direction));
+        if (load.distribution != "nodal" && load.distribution != "pressure") {
+            std::cerr << "エラー: 不明な荷重分布です: " << load.distribution << std::endl;
+            return EXIT_FAILURE;
+        }
+        loads.back().pressure = load.distribution == "pressure";
+    }
+    
+    if (constraints.empty() && loads.empty()) {
+        std::cerr << "エラー: 設定ファイルに境界条件が指定されていません。" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Step2Inp converter;
+    converter.setModelCache(model_cache);
+    RenumberingMethod renumbering;
+    if (!NodeRenumberer::parseMethod(config.mesh.renumbering, renumbering)) {
+        std::cerr << "エラー: 不明な節点番号付け方式です: " << config.mesh.renumbering << std::endl;
+        return EXIT_FAILURE;
+    }
+    converter.getNodeRenumberer().setMethod(renumbering);
+    converter.getMeshGenerator().setWorkers(config.mesh.workers);
+    converter.getMeshGenerator().setCharacteristicLength(config.mesh.min_element_size, config.mesh.max_element_size);
+    converter.getMeshGenerator().setMeshOrder(config.mesh.order);
+    const RefinementConfig& refinement = config.mesh.refinement;
+    if (refinement.enabled) {
+        // Stress concentrates at the supports and load introductions, so refine there
+        // instead of shrinking the mesh everywhere
+        double size = refinement.size > 0 ? refinement.size : config.mesh.min_element_size;
+        std::vector<int> fixed_surfaces, load_surfaces;
+        for (const auto& constraint : constraints) {
+            fixed_surfaces.push_back(constraint.surface_number);
+        }
+        for (const auto& load : loads) {
+            load_surfaces.push_back(load.surface_number);
+        }
+        MeshGenerator& generator = converter.getMeshGenerator();
+        if (refinement.constraints) {
+            generator.addRefinement(fixed_surfaces, size, refinement.distance_min, refinement.distance_max);
+        }
+        if (refinement.loads) {
+            generator.addRefinement(load_surfaces, size, refinement.distance_min, refinement.distance_max);
+        }
+        generator.addRefinement(refinement.surfaces, size, refinement.distance_min, refinement.distance_max);
+        generator.setCurvatureRefinement(refinement.curvature_points);
+    }
+    const ShellConfig& shell = config.mesh.shell;
+    if (shell.enabled) {
+        if (shell.surfaces.empty()) {
+            std::cerr << "エラー: シェルモデルにする面 (mesh.shell.surfaces) が指定されていません" << std::endl;
+            return EXIT_FAILURE;
+        }
+        converter.getMeshGenerator().setShellSurfaces(shell.surfaces, shell.thickness, shell.quads);
+    }
+    const SymmetryConfig& symmetry = config.mesh.symmetry;
+    if (symmetry.enabled) {
+        converter.setSymmetry(true);
+        converter.getSymmetryReducer().setMaxPlanes(symmetry.max_planes);
+        converter.getSymmetryReducer().setTolerance(symmetry.tolerance);
+    }
+    // The solver limits double as the mesh budget unless one is given
+    double memory_budget = config.resources.memory_mb > 0 ? config.resources.memory_mb : config.solver.memory_limit_mb;
+    double time_budget = config.resources.time_seconds > 0 ? config.resources.time_seconds : config.solver.timeout_seconds;
+    converter.getMeshGenerator().setResourceBudget(memory_budget, time_budget);
+    converter.setPlanOnly(config.resources.plan_only);
+    for (const auto& material : config.materials) {
+        for (int volume : material.volumes) {
+            converter.getMaterialSetter().setVolumeMaterial(
+                volume, {material.name, material.youngs_modulus, material.poisson_ratio});
+        }
+    }
+
+    // Get base filename for subsequent operations
+    std::filesystem::path path(step_file);
+    std::string base_name = path.stem().string();
+    std::string inp_file = base_name + ".inp";
+    std::string frd_file = base_name + ".frd";
+    std::string vtu_file = base_name + ".vtu";
+    std::string vtp_file = base_name + ".vtp";
+    std::string pvtu_file = base_name + ".pvtu";
+    std::string strc_file = base_name + ".strc";
+    std::string cases_file = base_name + ".cases";
+    std::string sym_file = base_name + ".sym";
+
+    // Result conversion options
+    FrdConvertOptions convert_options;
+    convert_options.write_volume = config.output.volume;
+    convert_options.partitions = config.output.partitions;
+    convert_options.fields = config.output.fields;
+    convert_options.step = config.output.step;
+    for (const auto& [name, precision] : config.output.precision) {
+        FieldEncoding encoding;
+        if (!FieldEncoder::parsePrecision(precision.type, encoding.precision)) {
+            std::cerr << "エラー: 不明な出力精度です: " << precision.type << std::endl;
+            return EXIT_FAILURE;
+        }
+        encoding.tolerance = precision.tolerance;
+        encoding.relative = precision.relative;
+        convert_options.encodings[name] = encoding;
+    }
+    if (config.output.surface) {
+        convert_options.surface_filename = vtp_file;
+        convert_options.linear_surface = config.output.linear_surface;
+    }
+    if (config.output.columnar) {
+        convert_options.columnar_filename = strc_file;
+    }
+
+    // Load-case superposition: applied_loads become weights of cached unit-load steps
+    std::vector<UnitLoadCase> unit_cases;
+    bool reuse_unit_solution = false;
+    if (config.superposition.enabled) {
+        unit_cases = LoadConditionSetter::createUnitLoadCases(loads);
+        converter.getLoadConditionSetter().setUnitLoadCases(true);
+        for (const auto& unit_case : unit_cases) {
+            convert_options.load_cases.push_back({unit_case.step, LoadConditionSetter::getUnitLoadWeight(unit_case, loads)});
+        }
+
+        std::ifstream cases(cases_file);
+        std::string cached_key;
+        std::getline(cases, cached_key);
+        reuse_unit_solution = std::filesystem::exists(frd_file) &&
+                              cached_key == describeUnitLoadSolution(config, unit_cases, frd_file);
+    }
+
+    if (config.resources.plan_only) {
+        std::cout << "Plan: Estimating solver resources..." << std::endl;
+        notify("plan", "started");
+        if (converter.convert(step_file, constraints, loads) != 0) {
+            notify("plan", "failed");
+            return EXIT_FAILURE;
+        }
+        const ResourceEstimate& estimate = converter.getMeshGenerator().getResourceEstimate();
+        nlohmann::json plan = {
+            {"order", estimate.order},
+            {"shell", shell.enabled},
+            {"symmetry_planes", converter.getSymmetryReducer().getPlanes().size()},
+            {"size_scale", estimate.size_scale},
+            {"min_element_size", config.mesh.min_element_size * estimate.size_scale},
+            {"max_element_size", config.mesh.max_element_size * estimate.size_scale},
+            {"nodes", estimate.nodes},
+            {"elements", estimate.elements},
+            {"dofs", estimate.dofs},
+            {"nonzeros", estimate.nonzeros},
+            {"memory_mb", estimate.memory_mb},
+            {"solve_seconds", estimate.solve_seconds},
+            {"memory_budget_mb", memory_budget},
+            {"time_budget_seconds", time_budget},
+            {"fits", estimate.fits}
+        };
+        std::string plan_file = base_name + ".plan.json";
+        std::ofstream(plan_file) << plan.dump(2) << "\n";
+        outputs["plan"] = std::filesystem::absolute(plan_file).string();
+        std::cout << "  - Plan file: " << plan_file << std::endl;
+        notify("plan", estimate.fits ? "done" : "failed", plan);
+        return estimate.fits ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (reuse_unit_solution) {
+        std::cout << "Step 1-2: Reusing unit load solutions from " << frd_file << std::endl;
+        notify("solve", "reused");
+    } else {
+        // Step 1: Convert STEP to INP
+        std::cout << "Step 1: Converting STEP to INP..." << std::endl;
+        notify("inp", "started");
+        std::size_t mesh_hits = model_cache ? model_cache->getStatistics().mesh_hits : 0;
+        int result = converter.convert(step_file, constraints, loads);
+        if (result != 0) {
+            std::cerr << "エラー: STEP to INP conversion failed" << std::endl;
+            notify("inp", "failed");
+            return result;
+        }
+        if (model_cache && model_cache->getStatistics().mesh_hits > mesh_hits) {
+            notify("mesh", "cached");
+        }
+        notify("inp", "done");
+
+        // Step 2: Run CalculiX analysis, unless the same deck was solved before
+        SolverCache solver_cache;
+        std::string solver_key;
+        if (!config.solver.cache_directory.empty() &&
+            solver_cache.open(config.solver.cache_directory,
+                              static_cast<std::uintmax_t>(config.solver.cache_size_mb * 1024 * 1024)) == 0) {
+            solver_key = SolverCache::computeKey(inp_file, SolverCache::describeSolver(config.solver.command));
+        }
+        if (!solver_key.empty() && solver_cache.fetch(solver_key, base_name)) {
+            std::cout << "Step 2: Reusing cached CalculiX results (" << solver_key << ")" << std::endl;
+            notify("solve", "cached");
+        } else {
+            std::cout << "Step 2: Running CalculiX analysis..." << std::endl;
+            notify("solve", "started");
+            // Unlink old outputs first: they may be hard links into the cache
+            std::error_code ec;
+            std::filesystem::remove(frd_file, ec);
+            std::filesystem::remove(base_name + ".dat", ec);
+            SolverProcess solver;
+            solver.setTimeout(config.solver.timeout_seconds);
+            solver.setMemoryLimit(static_cast<std::size_t>(config.solver.memory_limit_mb));
+            solver.setProgressCallback([&notify](const SolverProgress& position) {
+                notify("solve", "progress", {
+                    {"step", position.step},
+                    {"increment", position.increment},
+                    {"attempt", position.attempt},
+                    {"iteration", position.iteration},
+                    {"total_time", position.total_time},
+                    {"phase", position.phase}
+                });
+            });
+            result = solver.run(config.solver.command, base_name);
+            const SolverRunSummary& run = solver.getSummary();
+            std::cout << "  ソルバー: " << run.wall_seconds << " 秒, 最大RSS " << run.peak_rss_kb / 1024 << " MB, "
+                      << run.steps << " ステップ, " << run.increments << " インクリメント, "
+                      << run.iterations << " 反復" << std::endl;
+            writeRunSummary(base_name + ".run.json", config.solver, run);
+            outputs["run"] = std::filesystem::absolute(base_name + ".run.json").string();
+            if (result != 0) {
+                std::cerr << "エラー: CalculiX analysis failed" << std::endl;
+                notify("solve", "failed");
+                return result;
+            }
+            if (!solver_key.empty() && std::filesystem::exists(frd_file)) {
+                solver_cache.store(solver_key, base_name);
+            }
+            notify("solve", "done");
+        }
+        if (!solver_key.empty()) {
+            const SolverCacheStatistics& statistics = solver_cache.getStatistics();
+            std::cout << "  ソルバーキャッシュ: ヒット率 " << 100.0 * statistics.getHitRate() << "% ("
+                      << statistics.hits << "/" << statistics.hits + statistics.misses << "), "
+                      << statistics.entries << " エントリ, " << statistics.bytes / (1024 * 1024) << " MB" << std::endl;
+        }
+
+        if (config.superposition.enabled && std::filesystem::exists(frd_file)) {
+            std::ofstream cases(cases_file);
+            cases << describeUnitLoadSolution(config, unit_cases, frd_file) << "\n";
+        }
+    }
+
+    // Check if FRD file was generated
+    if (!std::filesystem::exists(frd_file)) {
+        std::cerr << "エラー: FRD file was not generated: " << frd_file << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    // Step 3: Convert FRD to VTU
+    std::cout << "Step 3: Converting FRD to VTU..." << std::endl;
+    notify("vtu", "started");
+    // A model reduced by symmetry is mirrored back to the full part
+    if (readMirrorPlanes(sym_file, convert_options.mirror_planes) != 0) {
+        notify("vtu", "failed");
+        return EXIT_FAILURE;
+    }
+    int result = convertFrdToVtu(frd_file, vtu_file, convert_options);
+    if (result == EXIT_SUCCESS) {
+        notify("vtu", "done");
+        auto addOutput = [&outputs](const std::string& kind, const std::string& file) {
+            outputs[kind] = std::filesystem::absolute(file).string();
+        };
+        std::cout << "Analysis pipeline completed successfully!" << std::endl;
+        std::cout << "Generated files:" << std::endl;
+        std::cout << "  - INP file: " << inp_file << std::endl;
+        addOutput("inp", inp_file);
+        const std::string& mesh_file = converter.getInpWriter().getMeshFile();
+        if (!mesh_file.empty()) {
+            std::cout << "  - Mesh file: " << mesh_file << std::endl;
+            addOutput("mesh", mesh_file);
+        }
+        if (renumbering != RenumberingMethod::None) {
+            std::cout << "  - Renumbering map: " << base_name << ".renum" << std::endl;
+            addOutput("renum", base_name + ".renum");
+        }
+        if (!convert_options.mirror_planes.empty()) {
+            std::cout << "  - Symmetry planes: " << sym_file << " (" << convert_options.mirror_planes.size() << " planes)" << std::endl;
+            addOutput("sym", sym_file);
+        }
+        std::cout << "  - FRD file: " << frd_file << std::endl;
+        addOutput("frd", frd_file);
+        if (config.superposition.enabled) {
+            std::cout << "  - Unit load cases: " << cases_file << " (" << unit_cases.size() << " steps)" << std::endl;
+            addOutput("cases", cases_file);
+        }
+        if (config.output.volume && config.output.partitions > 1) {
+            std::cout << "  - PVTU file: " << pvtu_file << " (" << config.output.partitions << " pieces)" << std::endl;
+            addOutput("pvtu", pvtu_file);
+        } else if (config.output.volume) {
+            std::cout << "  - VTU file: " << vtu_file << std::endl;
+            addOutput("vtu", vtu_file);
+        }
+        if (config.output.surface) {
+            std::cout << "  - VTP file: " << vtp_file << std::endl;
+            addOutput("vtp", vtp_file);
+        }
+        if (config.output.columnar) {
+            std::cout << "  - Columnar file: " << strc_file << std::endl;
+            addOutput("strc", strc_file);
+        }
+    } else {
+        std::cerr << "エラー: FRD to VTU conversion failed" << std::endl;
+        notify("vtu", "failed");
+    }
+
+    return result;
+}
@@ -0,0 +1,39 @@
+#ifndef ANALYSIS_PIPELINE_H
+#define ANALYSIS_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include "simulation_config.h"
+#include "step2inp.h"
+
+/**
+ * Stage notification of a pipeline run, e.g. ("inp", "started"), ("mesh", "cached"),
+ * ("solve", "reused"), ("vtu", "done") or (<stage>, "failed"). While the solver runs,
+ * ("solve", "progress") carries its step/increment/iteration in detail; detail is null otherwise.
+ */
+using PipelineProgress = std::function<void(const std::string& stage, const std::string& status,
+                                            const nlohmann::json& detail)>;
+
+/**
+ * Resolve geometric face selections of the config to surface ids, and map the
+ * surface ids given by number from the STEP file's numbering to the model's
+ * @param model_cache Live gmsh models to take the geometry from; may be null
+ * @return 0 on success, non-zero on error
+ */
+int resolveConfigFaces(SimulationConfig& config, ModelCache* model_cache = nullptr);
+
+/**
+ * Run STEP -> INP -> CalculiX -> VTU for one configuration in the current directory
+ * @param config Simulation configuration
+ * @param progress Called at every stage transition; may be empty
+ * @param outputs Receives the generated files by kind ("inp", "frd", "vtu", "run", ...)
+ * @param model_cache Live gmsh models to reuse geometry and meshes from; may be null
+ * @return 0 on success, non-zero on error
+ */
+int runAnalysisPipeline(SimulationConfig config, const PipelineProgress& progress,
+                        std::map<std::string, std::string>& outputs,
+                        ModelCache* model_cache = nullptr);
+
+#endif // ANALYSIS_PIPELINE_H
@@ -0,0 +1,311 @@
+#include "batch_converter.h"
+#include "parallel/TaskScheduler.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <glob.h>
+
+namespace {
+
+// Admits work while the running amount plus the new one fits the capacity;
+// work larger than the capacity runs alone
+class Admission {
+public:
+    explicit Admission(double capacity) : capacity_(capacity), in_use_(0.0) {}
+
+    void acquire(double amount) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        released_.wait(lock, [&] { return in_use_ <= 0.0 || in_use_ + amount <= capacity_; });
+        in_use_ += amount;
+    }
+
+    void release(double amount) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_use_ -= amount;
+        }
+        released_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable released_;
+    double capacity_;
+    double in_use_;
+};
+
+// Memory of a conversion: the parsed results and the VTK grid each hold about
+// as many bytes as the FRD text
+double estimateMemoryMb(std::uintmax_t frd_bytes) {
+    return 2.0 * static_cast<double>(frd_bytes) / (1024.0 * 1024.0);
+}
+
+bool isNewerThan(const std::string& output, const std::filesystem::file_time_type& input_time) {
+    std::error_code error;
+    auto output_time = std::filesystem::last_write_time(output, error);
+    return !error && output_time >= input_time;
+}
+
+} // namespace
+
+double BatchStatistics::getFilesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(converted) / seconds : 0.0;
+}
+
+double BatchStatistics::getMegabytesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+BatchConverter::BatchConverter()
+    : surface_(false)
+    , columnar_(false)
+    , jobs_(0)
+    , io_jobs_(2)
+    , memory_limit_mb_(0.0)
+    , force_(false)
+{
+}
+
+BatchConverter::~BatchConverter() {
+}
+
+void BatchConverter::setOptions(const FrdConvertOptions& options) {
+    options_ = options;
+}
+
+void BatchConverter::setSurface(bool surface) {
+    surface_ = surface;
+}
+
+void BatchConverter::setColumnar(bool columnar) {
+    columnar_ = columnar;
+}
+
+void BatchConverter::setOutputDirectory(const std::string& directory) {
+    output_directory_ = directory;
+}
+
+void BatchConverter::setInputRoot(const std::string& directory) {
+    input_root_ = directory;
+}
+
+void BatchConverter::setJobs(int jobs) {
+    jobs_ = jobs;
+}
+
+void BatchConverter::setIoJobs(int io_jobs) {
+    io_jobs_ = io_jobs;
+}
+
+void BatchConverter::setMemoryLimit(double memory_mb) {
+    memory_limit_mb_ = memory_mb;
+}
+
+void BatchConverter::setForce(bool force) {
+    force_ = force;
+}
+
+const BatchStatistics& BatchConverter::getStatistics() const {
+    return statistics_;
+}
+
+int BatchConverter::collectInputs(const std::string& pattern, bool recursive, std::vector<std::string>& frd_files) {
+    frd_files.clear();
+    std::error_code error;
+    if (std::filesystem::is_directory(pattern, error)) {
+        auto addFile = [&](const std::filesystem::directory_entry& entry) {
+            if (entry.is_regular_file(error) && entry.path().extension() == ".frd") {
+                frd_files.push_back(entry.path().string());
+            }
+        };
+        if (recursive) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(pattern, error)) addFile(entry);
+        } else {
+            for (const auto& entry : std::filesystem::directory_iterator(pattern, error)) addFile(entry);
+        }
+        if (error) {
+            std::cerr << "エラー: ディレクトリを読み込めませんでした: " << pattern << " (" << error.message() << ")" << std::endl;
+            return 1;
+        }
+    } else {
+        glob_t matches;
+        int result = glob(pattern.c_str(), 0, nullptr, &matches);
+        if (result != 0 && result != GLOB_NOMATCH) {
+            std::cerr << "エラー: パターンを展開できませんでした: " << pattern << std::endl;
+            return 1;
+        }
+        for (std::size_t i = 0; result == 0 && i < matches.gl_pathc; ++i) {
+            if (std::filesystem::is_regular_file(matches.gl_pathv[i], error)) {
+                frd_files.push_back(matches.gl_pathv[i]);
+            }
+        }
+        globfree(&matches);
+    }
+    std::sort(frd_files.begin(), frd_files.end());
+    return 0;
+}
+
+BatchConverter::Outputs BatchConverter::getOutputs(const std::string& frd_file) const {
+    std::filesystem::path base = std::filesystem::path(frd_file).parent_path();
+    if (!output_directory_.empty()) {
+        std::filesystem::path relative;
+        if (!input_root_.empty()) {
+            relative = base.lexically_proximate(input_root_);
+            if (relative == "." || (!relative.empty() && *relative.begin() == "..")) relative.clear();
+        }
+        base = std::filesystem::path(output_directory_) / relative;
+    }
+    base /= std::filesystem::path(frd_file).stem();
+
+    Outputs outputs;
+    outputs.vtu = base.string() + ".vtu";
+    if (surface_) outputs.vtp = base.string() + ".vtp";
+    if (columnar_) outputs.strc = base.string() + ".strc";
+    return outputs;
+}
+
+bool BatchConverter::isUpToDate(const std::string& frd_file, const Outputs& outputs) const {
+    std::error_code error;
+    auto input_time = std::filesystem::last_write_time(frd_file, error);
+    if (error) return false;
+    // A reduced model is mirrored with its .sym file, so a newer one invalidates the outputs too
+    std::string sym_file = std::filesystem::path(frd_file).replace_extension(".sym").string();
+    auto sym_time = std::filesystem::last_write_time(sym_file, error);
+    if (!error) input_time = std::max(input_time, sym_time);
+
+    if (options_.write_volume) {
+        std::string volume = options_.partitions > 1
+            ? std::filesystem::path(outputs.vtu).replace_extension(".pvtu").string() : outputs.vtu;
+        if (!isNewerThan(volume, input_time)) return false;
+    }
+    if (!outputs.vtp.empty() && !isNewerThan(outputs.vtp, input_time)) return false;
+    if (!outputs.strc.empty() && !isNewerThan(outputs.strc, input_time)) return false;
+    return true;
+}
+
+int BatchConverter::run(const std::vector<std::string>& frd_files) {
+    statistics_ = BatchStatistics();
+    auto start = std::chrono::steady_clock::now();
+
+    // Two inputs with one output (a.frd of two directories) would overwrite each other
+    std::map<std::string, std::string> output_inputs;
+    for (const auto& frd_file : frd_files) {
+        std::string output = std::filesystem::path(getOutputs(frd_file).vtu).lexically_normal().string();
+        auto [it, inserted] = output_inputs.emplace(output, frd_file);
+        if (!inserted) {
+            std::cerr << "エラー: 出力ファイル名が重複します: " << it->second << ", " << frd_file
+                      << " -> " << output << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> pending;
+    for (const auto& frd_file : frd_files) {
+        if (!force_ && isUpToDate(frd_file, getOutputs(frd_file))) {
+            ++statistics_.skipped;
+        } else {
+            pending.push_back(frd_file);
+        }
+    }
+    std::cout << "FRDファイル " << frd_files.size() << " 件 (変換 " << pending.size()
+              << " 件, 最新のためスキップ " << statistics_.skipped << " 件)" << std::endl;
+    if (!output_directory_.empty()) {
+        std::set<std::string> directories;
+        for (const auto& frd_file : pending) {
+            directories.insert(std::filesystem::path(getOutputs(frd_file).vtu).parent_path().string());
+        }
+        for (const auto& directory : directories) {
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+            if (error) {
+                std::cerr << "エラー: 出力ディレクトリを作成できませんでした: " << directory
+                          << " (" << error.message() << ")" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Job threads of their own rather than scheduler tasks: a job blocks while
+    // it waits for memory or the disk, which must not stall the scheduler workers
+    std::size_t jobs = jobs_ > 0 ? static_cast<std::size_t>(jobs_) : TaskScheduler::instance().getThreadCount();
+    jobs = std::max<std::size_t>(1, std::min(jobs, pending.size()));
+    Admission memory(memory_limit_mb_ > 0.0 ? memory_limit_mb_ : 1e300);
+    Admission reading(static_cast<double>(std::max(1, io_jobs_)));
+    std::mutex report_mutex;
+    std::atomic<std::size_t> next(0);
+
+    auto convertFiles = [&]() {
+        for (std::size_t i = next++; i < pending.size(); i = next++) {
+            const std::string& frd_file = pending[i];
+            Outputs outputs = getOutputs(frd_file);
+            std::error_code error;
+            std::uintmax_t frd_bytes = std::filesystem::file_size(frd_file, error);
+            if (error) frd_bytes = 0;
+            double memory_mb = estimateMemoryMb(frd_bytes);
+            auto file_start = std::chrono::steady_clock::now();
+
+            memory.acquire(memory_mb);
+            FrdReadOptions read_options;
+            read_options.fields = options_.fields;
+            read_options.step = options_.step;
+            read_options.load_cases = options_.load_cases;
+            FrdResults results;
+            reading.acquire(1.0);
+            int result = readFrd(frd_file, read_options, results);
+            reading.release(1.0);
+
+            std::vector<MirrorPlane> planes;
+            if (result == 0) {
+                result = readMirrorPlanes(std::filesystem::path(frd_file).replace_extension(".sym").string(), planes);
+            }
+            if (result == 0) {
+                mirrorResults(results, planes);
+                FrdConvertOptions options = options_;
+                options.surface_filename = outputs.vtp;
+                options.columnar_filename = outputs.strc;
+                result = convertFrdResultsToVtu(results, outputs.vtu, options);
+            }
+            results = FrdResults();
+            memory.release(memory_mb);
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - file_start).count();
+            std::lock_guard<std::mutex> lock(report_mutex);
+            if (result == 0) {
+                ++statistics_.converted;
+                statistics_.bytes += frd_bytes;
+                std::cout << "[" << statistics_.converted + statistics_.failed << "/" << pending.size() << "] "
+                          << frd_file << " -> " << outputs.vtu << " (" << std::fixed << std::setprecision(2)
+                          << seconds << " s)" << std::defaultfloat << std::endl;
+            } else {
+                ++statistics_.failed;
+                std::cerr << "[" << statistics_.converted + statistics_.failed << "/" << pending.size() << "] "
+                          << "エラー: 変換に失敗しました: " << frd_file << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t j = 1; j < jobs; ++j) {
+        threads.emplace_back(convertFiles);
+    }
+    convertFiles();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    statistics_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "変換完了: " << statistics_.converted << " 件, スキップ " << statistics_.skipped
+              << " 件, 失敗 " << statistics_.failed << " 件 (" << std::fixed << std::setprecision(2)
+              << statistics_.seconds << " s, " << statistics_.getFilesPerSecond() << " files/s, "
+              << statistics_.getMegabytesPerSecond() << " MB/s)" << std::defaultfloat << std::endl;
+    return statistics_.failed > 0 ? 1 : 0;
+}
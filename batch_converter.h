@@ -0,0 +1,84 @@
+#ifndef BATCH_CONVERTER_H
+#define BATCH_CONVERTER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "frd2vtu.h"
+
+// Outcome of a batch run
+struct BatchStatistics {
+    std::size_t converted = 0;
+    std::size_t skipped = 0;         // Outputs newer than the FRD file
+    std::size_t failed = 0;
+    std::size_t bytes = 0;           // FRD bytes of the converted files
+    double seconds = 0.0;
+
+    double getFilesPerSecond() const;
+    double getMegabytesPerSecond() const;
+};
+
+/**
+ * Convert every FRD file of a result directory to VTU.
+ *
+ * Several files are converted at once, each on its own job thread; the
+ * conversions themselves share the TaskScheduler. Reading is limited to a few
+ * files at a time so that concurrent jobs do not thrash the disk, and a job
+ * starts only while the estimated memory of the running ones fits the limit.
+ * Files whose outputs are newer than the FRD (and its .sym file) are skipped.
+ */
+class BatchConverter {
+public:
+    BatchConverter();
+    ~BatchConverter();
+
+    // Conversion of each file; the output file names are set per file
+    void setOptions(const FrdConvertOptions& options);
+    // Also write the exterior surface (.vtp) and the columnar file (.strc)
+    void setSurface(bool surface);
+    void setColumnar(bool columnar);
+    // Directory of the outputs; empty writes them next to each FRD file
+    void setOutputDirectory(const std::string& directory);
+    // Directory the inputs were collected from; their subdirectories are
+    // repeated under the output directory
+    void setInputRoot(const std::string& directory);
+    // Files converted at once; 0 uses the scheduler thread count
+    void setJobs(int jobs);
+    // Files read at once
+    void setIoJobs(int io_jobs);
+    // Memory of the running conversions in MB; 0 disables the limit
+    void setMemoryLimit(double memory_mb);
+    // Convert files whose outputs are up to date too
+    void setForce(bool force);
+
+    // FRD files of a directory (recursive if asked) or of a glob pattern, sorted
+    static int collectInputs(const std::string& pattern, bool recursive, std::vector<std::string>& frd_files);
+
+    // Convert the files; 0 if none failed
+    int run(const std::vector<std::string>& frd_files);
+
+    const BatchStatistics& getStatistics() const;
+
+private:
+    struct Outputs {
+        std::string vtu;
+        std::string vtp;
+        std::string strc;
+    };
+
+    Outputs getOutputs(const std::string& frd_file) const;
+    bool isUpToDate(const std::string& frd_file, const Outputs& outputs) const;
+
+    FrdConvertOptions options_;
+    bool surface_;
+    bool columnar_;
+    std::string output_directory_;
+    std::string input_root_;
+    int jobs_;
+    int io_jobs_;
+    double memory_limit_mb_;
+    bool force_;
+    BatchStatistics statistics_;
+};
+
+#endif // BATCH_CONVERTER_H
@@ -1,197 +1,261 @@
 #include "frd2vtu.h"
+#include "frd2vtu/SurfaceExtractor.h"
+#include "frd2vtu/ColumnarResultFile.h"
+#include "frd2vtu/MeshPartitioner.h"
+#include "parallel/TaskScheduler.h"
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkPoints.h>
 #include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkFieldData.h>
 #include <vtkPointData.h>
 #include <vtkXMLUnstructuredGridWriter.h>
+#include <vtkXMLPolyDataWriter.h>
 #include <vtkCellType.h>
 
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
-#include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <filesystem>
 
-// 文字列の先頭と末尾の空白を削除するヘルパー関数
-void trim(std::string& s) {
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch) {
-        return !std::isspace(ch);
-    }));
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](unsigned char ch) {
-        return !std::isspace(ch);
-    }).base(), s.end());
+namespace {
+
+// VTK cell of an FRD element type
+struct FrdCellType {
+    int frd_type;
+    std::size_t nodes;
+    int vtk_type;
+    const int* order;  // FRD position of each VTK node; nullptr if the orders agree
+};
+
+// FRD lists the mid-side nodes of the top face after the vertical edges
+const int kHexahedron20Order[20] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 16, 17, 18, 19, 12, 13, 14, 15};
+const int kWedge15Order[15] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 13, 14, 9, 10, 11};
+
+const FrdCellType kFrdCellTypes[] = {
+    {1, 8, VTK_HEXAHEDRON, nullptr},
+    {2, 6, VTK_WEDGE, nullptr},
+    {3, 4, VTK_TETRA, nullptr},
+    {4, 20, VTK_QUADRATIC_HEXAHEDRON, kHexahedron20Order},  // Expanded S8 shells
+    {5, 15, VTK_QUADRATIC_WEDGE, kWedge15Order},            // Expanded S6 shells
+    {6, 10, VTK_QUADRATIC_TETRA, nullptr},
+    {7, 3, VTK_TRIANGLE, nullptr},
+    {8, 6, VTK_QUADRATIC_TRIANGLE, nullptr},
+    {9, 4, VTK_QUAD, nullptr},
+    {10, 8, VTK_QUADRATIC_QUAD, nullptr},
+};
+
+} // namespace
+
+// von Mises = sqrt(0.5 * ((s1-s2)^2 + (s2-s3)^2 + (s3-s1)^2 + 6*(s4^2 + s5^2 + s6^2)))
+double vonMisesOf(double s1, double s2, double s3, double s4, double s5, double s6) {
+    return std::sqrt(0.5 * (
+        (s1 - s2) * (s1 - s2) +
+        (s2 - s3) * (s2 - s3) +
+        (s3 - s1) * (s3 - s1) +
+        6.0 * (s4 * s4 + s5 * s5 + s6 * s6)
+    ));
 }
 
 int convertFrdToVtu(const std::string& frd_filename, const std::string& vtu_filename) {
+    return convertFrdToVtu(frd_filename, vtu_filename, FrdConvertOptions());
+}
 
-    std::ifstream frd_file(frd_filename);
-    if (!frd_file.is_open()) {
+int convertFrdToVtu(const std::string& frd_filename, const std::string& vtu_filename,
+                    const FrdConvertOptions& options) {
+    FrdReadOptions read_options;
+    read_options.fields = options.fields;
+    read_options.step = options.step;
+    read_options.load_cases = options.load_cases;
+
+    FrdResults results;
+    if (readFrd(frd_filename, read_options, results) != 0) {
         return EXIT_FAILURE;
     }
+    if (!options.mirror_planes.empty()) {
+        std::size_t reduced_nodes = results.getNumberOfNodes();
+        mirrorResults(results, options.mirror_planes);
+        std::cout << "  対称モデルを展開: 節点 " << reduced_nodes << " -> " << results.getNumberOfNodes() << std::endl;
+    }
+    return convertFrdResultsToVtu(results, vtu_filename, options);
+}
 
-    // --- VTKオブジェクトの準備 ---
+int convertFrdResultsToVtu(const FrdResults& results, const std::string& vtu_filename,
+                           const FrdConvertOptions& options) {
+
+    // --- 節点と要素をUnstructuredGridに設定 ---
     auto points = vtkSmartPointer<vtkPoints>::New();
     auto unstructuredGrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
 
-    // --- 結果データ用配列の準備 ---
-    auto displacement = vtkSmartPointer<vtkDoubleArray>::New();
-    displacement->SetName("Displacement");
-    displacement->SetNumberOfComponents(3);
-
-    auto stress = vtkSmartPointer<vtkDoubleArray>::New();
-    stress->SetName("Stress");
-    stress->SetNumberOfComponents(6); // Sxx, Syy, Szz, Sxy, Syz, Szx
-
-    auto strain = vtkSmartPointer<vtkDoubleArray>::New();
-    strain->SetName("Total_Strain");
-    strain->SetNumberOfComponents(6); // Exx, Eyy, Ezz, Exy, Eyz, Ezx
-
-    auto error = vtkSmartPointer<vtkDoubleArray>::New();
-    error->SetName("Estimation_Error");
-    error->SetNumberOfComponents(1);
-
-    auto vonMisesStress = vtkSmartPointer<vtkDoubleArray>::New();
-    vonMisesStress->SetName("von Mises Stress");
-    vonMisesStress->SetNumberOfComponents(1);
-
-    // --- ファイル解析 ---
-    std::string line;
-    // ファイルの状態を管理する変数
-    enum class ParserState { NONE, NODES, ELEMENTS, DISP, STRESS, STRAIN, ERROR };
-    ParserState state = ParserState::NONE;
-
-    while (std::getline(frd_file, line)) {
-        trim(line);
-        if (line.empty()) continue;
-
-        std::stringstream ss(line);
-        std::string keyword;
-        ss >> keyword;
-
-        // --- 状態遷移の判定 ---
-        if (keyword == "2C") {
-            state = ParserState::NODES;
-            continue;
-        } else if (keyword == "3C") {
-            state = ParserState::ELEMENTS;
-            continue;
-        } else if (keyword == "-4") {
-            std::string result_type;
-            ss >> result_type;
-            if (result_type == "DISP") state = ParserState::DISP;
-            else if (result_type == "STRESS") state = ParserState::STRESS;
-            else if (result_type == "TOSTRAIN") state = ParserState::STRAIN;
-            else if (result_type == "ERROR") state = ParserState::ERROR;
-            else state = ParserState::NONE;
-            continue;
-        } else if (keyword == "-3" || keyword == "9999") { // ブロック終了
-            state = ParserState::NONE;
+    vtkIdType num_points = static_cast<vtkIdType>(results.getNumberOfNodes());
+    points->SetNumberOfPoints(num_points);
+    float* point_data = vtkFloatArray::SafeDownCast(points->GetData())->GetPointer(0);  // vtkPoints store floats
+    TaskScheduler::instance().parallelFor(0, results.coordinates.size(), 65536, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            point_data[i] = static_cast<float>(results.coordinates[i]);
+        }
+    });
+
+    unstructuredGrid->Allocate(static_cast<vtkIdType>(results.getNumberOfCells()));
+    std::vector<vtkIdType> nodeIds;
+    std::size_t skipped = 0;
+    for (std::size_t c = 0; c < results.getNumberOfCells(); ++c) {
+        const std::int64_t* frd_nodes = results.cell_connectivity.data() + results.cell_offsets[c];
+        std::size_t num_nodes = static_cast<std::size_t>(results.cell_offsets[c + 1] - results.cell_offsets[c]);
+
+        // 二次四面体のほか、シェルを展開した二次六面体・二次五面体も変換する
+        const FrdCellType* cell_type = nullptr;
+        for (const FrdCellType& candidate : kFrdCellTypes) {
+            if (candidate.frd_type == results.cell_types[c] && candidate.nodes == num_nodes) cell_type = &candidate;
+        }
+        if (cell_type == nullptr) {
+            ++skipped;
             continue;
         }
+        nodeIds.resize(num_nodes);
+        for (std::size_t k = 0; k < num_nodes; ++k) {
+            nodeIds[k] = frd_nodes[cell_type->order ? cell_type->order[k] : k];
+        }
+        unstructuredGrid->InsertNextCell(cell_type->vtk_type, nodeIds.size(), nodeIds.data());
+    }
+    if (skipped > 0) {
+        std::cerr << "警告: 未対応の要素 " << skipped << " 個を出力しません" << std::endl;
+    }
+    unstructuredGrid->SetPoints(points);
 
-        // --- 各状態に応じたデータ処理 ---
-        if (keyword == "-1") {
-            switch (state) {
-                case ParserState::NODES: {
-                    int nodeId;
-                    double x, y, z;
-                    ss >> nodeId >> x >> y >> z;
-                    points->InsertNextPoint(x, y, z);
-                    break;
-                }
-                case ParserState::ELEMENTS: {
-                    // 要素ヘッダ行は読み飛ばし、次の-2行を読む
-                    if (std::getline(frd_file, line)) {
-                        trim(line);
-                        std::stringstream ss_nodes(line);
-                        std::string nodes_keyword;
-                        ss_nodes >> nodes_keyword; // "-2" を読み飛ばす
-                        
-                        std::vector<vtkIdType> nodeIds;
-                        int nodeId_val;
-                        while (ss_nodes >> nodeId_val) {
-                            // FRDは1-based, VTKは0-basedなので-1する
-                            nodeIds.push_back(nodeId_val - 1);
-                        }
-
-                        // ノード数から要素タイプを判断
-                        if (nodeIds.size() == 10) { // 10ノード -> 二次四面体
-                            unstructuredGrid->InsertNextCell(VTK_QUADRATIC_TETRA, nodeIds.size(), nodeIds.data());
-                        }
-                        // ここに他の要素タイプ（8ノードならVTK_HEXAHEDRONなど）の判定を追加可能
-                    }
-                    break;
-                }
-                case ParserState::DISP: {
-                    int nodeId;
-                    double d1, d2, d3;
-                    ss >> nodeId >> d1 >> d2 >> d3;
-                    displacement->InsertNextTuple3(d1, d2, d3);
-                    break;
-                }
-                case ParserState::STRESS: {
-                    int nodeId;
-                    double s1, s2, s3, s4, s5, s6;
-                    ss >> nodeId >> s1 >> s2 >> s3 >> s4 >> s5 >> s6;
-                    
-                    // MPaからPaに変換（1 MPa = 1e6 Pa）
-                    s1 *= 1e6; s2 *= 1e6; s3 *= 1e6;
-                    s4 *= 1e6; s5 *= 1e6; s6 *= 1e6;
-                    
-                    stress->InsertNextTuple6(s1, s2, s3, s4, s5, s6);
-                    
-                    // von Mises応力を計算
-                    // von Mises = sqrt(0.5 * ((s1-s2)^2 + (s2-s3)^2 + (s3-s1)^2 + 6*(s4^2 + s5^2 + s6^2)))
-                    double vonMises = std::sqrt(0.5 * (
-                        (s1 - s2) * (s1 - s2) + 
-                        (s2 - s3) * (s2 - s3) + 
-                        (s3 - s1) * (s3 - s1) + 
-                        6.0 * (s4 * s4 + s5 * s5 + s6 * s6)
-                    ));
-                    vonMisesStress->InsertNextTuple1(vonMises);
-                    break;
-                }
-                case ParserState::STRAIN: {
-                     int nodeId;
-                    double e1, e2, e3, e4, e5, e6;
-                    ss >> nodeId >> e1 >> e2 >> e3 >> e4 >> e5 >> e6;
-                    strain->InsertNextTuple6(e1, e2, e3, e4, e5, e6);
-                    break;
-                }
-                case ParserState::ERROR: {
-                    int nodeId;
-                    double err_val;
-                    ss >> nodeId >> err_val;
-                    error->InsertNextTuple1(err_val);
-                    break;
-                }
-                default:
-                    break;
+    // --- 結果データ用配列の準備 ---
+    auto toArray = [](const FrdField* field, const char* name, double scale) {
+        auto array = vtkSmartPointer<vtkDoubleArray>::New();
+        array->SetName(name);
+        array->SetNumberOfComponents(field->components);
+        array->SetNumberOfTuples(static_cast<vtkIdType>(field->values.size() / field->components));
+        double* out = array->GetPointer(0);
+        TaskScheduler::instance().parallelFor(0, field->values.size(), 65536, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                out[i] = scale * field->values[i];
             }
-        }
+        });
+        return array;
+    };
+
+    const FrdField* disp_field = results.findField("DISP");
+    const FrdField* stress_field = results.findField("STRESS");
+    const FrdField* strain_field = results.findField("TOSTRAIN");
+    const FrdField* error_field = results.findField("ERROR");
+
+    vtkSmartPointer<vtkDoubleArray> displacement, stress, strain, error, vonMisesStress;
+    if (disp_field) {
+        displacement = toArray(disp_field, "Displacement", 1.0);
     }
-    frd_file.close();
+    if (stress_field) {
+        // MPaからPaに変換（1 MPa = 1e6 Pa）
+        stress = toArray(stress_field, "Stress", 1e6);  // Sxx, Syy, Szz, Sxy, Syz, Szx
 
-    // --- 組み立てたデータをUnstructuredGridに設定 ---
-    unstructuredGrid->SetPoints(points);
+        // von Mises応力を計算
+        vonMisesStress = vtkSmartPointer<vtkDoubleArray>::New();
+        vonMisesStress->SetName("von Mises Stress");
+        vonMisesStress->SetNumberOfComponents(1);
+        vtkIdType tuples = stress->GetNumberOfTuples();
+        vonMisesStress->SetNumberOfTuples(tuples);
+        const double* s = stress->GetPointer(0);
+        double* von_mises = vonMisesStress->GetPointer(0);
+        TaskScheduler::instance().parallelFor(0, static_cast<std::size_t>(tuples), 16384, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                const double* t = s + 6 * i;
+                von_mises[i] = vonMisesOf(t[0], t[1], t[2], t[3], t[4], t[5]);
+            }
+        });
+    }
+    if (strain_field) {
+        strain = toArray(strain_field, "Total_Strain", 1.0);  // Exx, Eyy, Ezz, Exy, Eyz, Ezx
+    }
+    if (error_field) {
+        error = toArray(error_field, "Estimation_Error", 1.0);
+    }
 
-    // 各データ配列をPointDataに追加
-    unstructuredGrid->GetPointData()->AddArray(displacement);
-    unstructuredGrid->GetPointData()->AddArray(stress);
-    unstructuredGrid->GetPointData()->AddArray(strain);
-    unstructuredGrid->GetPointData()->AddArray(error);
-    unstructuredGrid->GetPointData()->AddArray(vonMisesStress);
+    // 読み込んだ結果の配列だけを指定精度に変換してPointDataに追加
+    FieldEncoder encoder;
+    for (const auto& [name, encoding] : options.encodings) {
+        encoder.setEncoding(name, encoding);
+    }
+    auto addField = [&](vtkSmartPointer<vtkDoubleArray>& field) {
+        unstructuredGrid->GetPointData()->AddArray(encoder.encode(field, unstructuredGrid->GetFieldData()));
+        field = nullptr;  // 変換前の倍精度配列を解放
+    };
+    if (displacement) {
+        addField(displacement);
+    }
+    if (stress) {
+        addField(stress);
+    }
+    if (strain) {
+        addField(strain);
+    }
+    if (error) {
+        addField(error);
+    }
+    if (vonMisesStress) {
+        addField(vonMisesStress);
+    }
 
+    for (const auto& report : encoder.getReports()) {
+        if (report.precision == FieldPrecision::Float64) continue;
+        std::cout << "  " << report.name << ": "
+                  << (report.precision == FieldPrecision::Float32 ? "float32" : "quantized")
+                  << ", 最大誤差 " << report.max_error
+                  << ", " << report.bytes_before << " -> " << report.bytes_after << " bytes" << std::endl;
+    }
 
     // --- VTUファイルに書き出し ---
-    auto writer = vtkSmartPointer<vtkXMLUnstructuredGridWriter>::New();
-    writer->SetFileName(vtu_filename.c_str());
-    writer->SetInputData(unstructuredGrid);
-    writer->SetDataModeToAscii(); // テキスト形式で出力
-    writer->Write();
+    if (options.write_volume && options.partitions > 1) {
+        // 大規模モデル向けにN分割して.pvtuで束ねる
+        MeshPartitioner partitioner;
+        partitioner.setNumberOfParts(options.partitions);
+        std::vector<int> cell_parts;
+        if (partitioner.partition(unstructuredGrid, cell_parts) != 0) {
+            return EXIT_FAILURE;
+        }
+        const PartitionQuality& quality = partitioner.getQuality();
+        std::cout << "  分割数 " << quality.parts << ": エッジカット " << quality.edge_cut
+                  << ", 不均衡 " << quality.imbalance << std::endl;
+
+        std::string pvtu_filename = std::filesystem::path(vtu_filename).replace_extension(".pvtu").string();
+        if (MeshPartitioner::writePieces(unstructuredGrid, cell_parts, quality.parts, pvtu_filename) != 0) {
+            return EXIT_FAILURE;
+        }
+    } else if (options.write_volume) {
+        auto writer = vtkSmartPointer<vtkXMLUnstructuredGridWriter>::New();
+        writer->SetFileName(vtu_filename.c_str());
+        writer->SetInputData(unstructuredGrid);
+        writer->SetDataModeToAscii(); // テキスト形式で出力
+        writer->Write();
+    }
 
+    // --- 外表面のみをVTPファイルに書き出し ---
+    if (!options.surface_filename.empty()) {
+        SurfaceExtractor extractor;
+        extractor.setLinearFaces(options.linear_surface);
+        auto surface = extractor.extract(unstructuredGrid);
+        surface->SetFieldData(unstructuredGrid->GetFieldData());
+
+        auto surface_writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+        surface_writer->SetFileName(options.surface_filename.c_str());
+        surface_writer->SetInputData(surface);
+        surface_writer->SetDataModeToBinary(); // 配布用なので圧縮バイナリで出力
+        if (surface_writer->Write() == 0) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // --- 解析用の列形式バイナリに書き出し ---
+    if (!options.columnar_filename.empty()) {
+        if (ColumnarResultFile::write(options.columnar_filename, unstructuredGrid) != 0) {
+            return EXIT_FAILURE;
+        }
+    }
 
     return EXIT_SUCCESS;
 }
@@ -2,6 +2,28 @@
 #define FRD2VTU_H
 
 #include <string>
+#include <vector>
+#include <map>
+#include "frd2vtu/FieldEncoder.h"
+#include "frd2vtu/LoadCaseSuperposer.h"
+#include "frd2vtu/FrdResults.h"
+#include "frd2vtu/ResultMirror.h"
+
+/**
+ * Output selection for FRD conversion
+ */
+struct FrdConvertOptions {
+    bool write_volume = true;        // Write the full volume grid to the VTU file
+    std::string surface_filename;    // Also write the exterior surface (.vtp) if not empty
+    bool linear_surface = false;     // Keep only corner nodes of quadratic surface faces
+    std::vector<std::string> fields; // FRD result blocks to read (DISP, STRESS, TOSTRAIN, ERROR); empty reads all
+    int step = 0;                    // Analysis step to read; 0 selects the last step
+    std::map<std::string, FieldEncoding> encodings;  // Storage precision per array name; default float64
+    std::string columnar_filename;   // Also write the memory-mappable columnar file (.strc) if not empty
+    int partitions = 1;              // Split the volume into this many .vtu pieces plus a .pvtu index
+    std::vector<LoadCaseWeight> load_cases;  // If not empty, write the weighted sum of these steps instead of `step`
+    std::vector<MirrorPlane> mirror_planes;  // Reflect a half or quarter model back to the full part
+};
 
 /**
  * Convert FRD file to VTU format
@@ -11,4 +33,26 @@
  */
 int convertFrdToVtu(const std::string& frd_filename, const std::string& vtu_filename);
 
+/**
+ * Convert FRD file to VTU and/or exterior-surface VTP format
+ * @param frd_filename Input FRD file path
+ * @param vtu_filename Output VTU file path (ignored unless options.write_volume;
+ *                     with options.partitions > 1 the .pvtu index is written next to it)
+ * @param options Output selection
+ * @return 0 on success, non-zero on error
+ */
+int convertFrdToVtu(const std::string& frd_filename, const std::string& vtu_filename,
+                    const FrdConvertOptions& options);
+
+/**
+ * Write results already parsed with readFrd() to VTU and/or exterior-surface VTP format.
+ * Stress is converted from MPa to Pa and a von Mises array is added.
+ * @param results Parsed FRD mesh and fields; the last step of each field type is written
+ * @param vtu_filename Output VTU file path (see convertFrdToVtu)
+ * @param options Output selection; the read options (fields, step, load_cases, mirror_planes) are ignored
+ * @return 0 on success, non-zero on error
+ */
+int convertFrdResultsToVtu(const FrdResults& results, const std::string& vtu_filename,
+                           const FrdConvertOptions& options);
+
 #endif // FRD2VTU_H
\ No newline at end of file
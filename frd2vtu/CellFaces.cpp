@@ -0,0 +1,67 @@
+#include "CellFaces.h"
+#include <vtkCellType.h>
+
+namespace {
+
+const CellFace kTetraFaces[4] = {
+    {3, {0, 1, 3, 4, 8, 7}},
+    {3, {1, 2, 3, 5, 9, 8}},
+    {3, {2, 0, 3, 6, 7, 9}},
+    {3, {0, 2, 1, 6, 5, 4}}
+};
+
+const CellFace kHexahedronFaces[6] = {
+    {4, {0, 3, 2, 1, 11, 10, 9, 8}},
+    {4, {4, 5, 6, 7, 12, 13, 14, 15}},
+    {4, {0, 1, 5, 4, 8, 17, 12, 16}},
+    {4, {1, 2, 6, 5, 9, 18, 13, 17}},
+    {4, {2, 3, 7, 6, 10, 19, 14, 18}},
+    {4, {3, 0, 4, 7, 11, 16, 15, 19}}
+};
+
+const CellFace kWedgeFaces[5] = {
+    {3, {0, 1, 2, 6, 7, 8}},
+    {3, {3, 5, 4, 11, 10, 9}},
+    {4, {0, 3, 4, 1, 12, 9, 13, 6}},
+    {4, {1, 4, 5, 2, 13, 10, 14, 7}},
+    {4, {2, 5, 3, 0, 14, 11, 12, 8}}
+};
+
+const CellFace kTriangleFace[1] = {{3, {0, 1, 2, 3, 4, 5}}};
+const CellFace kQuadFace[1] = {{4, {0, 1, 2, 3, 4, 5, 6, 7}}};
+
+} // namespace
+
+int getCellFaces(int cell_type, const CellFace*& faces) {
+    switch (cell_type) {
+        case VTK_TETRA:
+        case VTK_QUADRATIC_TETRA:
+            faces = kTetraFaces;
+            return 4;
+        case VTK_HEXAHEDRON:
+        case VTK_QUADRATIC_HEXAHEDRON:
+            faces = kHexahedronFaces;
+            return 6;
+        case VTK_WEDGE:
+        case VTK_QUADRATIC_WEDGE:
+            faces = kWedgeFaces;
+            return 5;
+        case VTK_TRIANGLE:
+        case VTK_QUADRATIC_TRIANGLE:
+            faces = kTriangleFace;
+            return 1;
+        case VTK_QUAD:
+        case VTK_QUADRATIC_QUAD:
+            faces = kQuadFace;
+            return 1;
+        default:
+            faces = nullptr;
+            return 0;
+    }
+}
+
+bool isQuadraticCell(int cell_type) {
+    return cell_type == VTK_QUADRATIC_TETRA || cell_type == VTK_QUADRATIC_HEXAHEDRON ||
+           cell_type == VTK_QUADRATIC_WEDGE || cell_type == VTK_QUADRATIC_TRIANGLE ||
+           cell_type == VTK_QUADRATIC_QUAD;
+}
@@ -0,0 +1,18 @@
+#ifndef CELL_FACES_H
+#define CELL_FACES_H
+
+// One face of a cell, oriented outward: its corners, then for quadratic cells
+// the mid-side nodes of the edges (c0,c1), (c1,c2), ... in the same order
+struct CellFace {
+    int corners;  // 3 or 4
+    int nodes[8];
+};
+
+// Faces of the VTK cell types converted from FRD files, as local node indices;
+// a triangle or quadrilateral is its own single face. Returns 0 for other types.
+int getCellFaces(int cell_type, const CellFace*& faces);
+
+// Whether the faces of a cell type carry mid-side nodes
+bool isQuadraticCell(int cell_type);
+
+#endif // CELL_FACES_H
@@ -0,0 +1,335 @@
+#include "ColumnarResultFile.h"
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkFieldData.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkType.h>
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[8] = {'S', 'T', 'R', 'C', 'O', 'L', '\0', '\0'};
+const std::uint32_t kVersion = 1;
+const std::uint64_t kAlignment = 64;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_columns;
+    std::uint64_t num_points;
+    std::uint64_t num_cells;
+    std::uint64_t toc_offset;
+    std::uint64_t file_size;
+    std::uint8_t reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64, "header must fill one 64-byte line");
+static_assert(sizeof(ColumnEntry) == 64, "TOC entry must fill one 64-byte line");
+
+std::uint64_t alignUp(std::uint64_t offset) {
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::size_t columnTypeSize(ColumnType type) {
+    switch (type) {
+        case ColumnType::Float64: return 8;
+        case ColumnType::Float32: return 4;
+        case ColumnType::Int64: return 8;
+        case ColumnType::UInt8: return 1;
+        case ColumnType::UInt16: return 2;
+        case ColumnType::UInt32: return 4;
+    }
+    return 0;
+}
+
+bool columnTypeFor(vtkDataArray* array, ColumnType& type) {
+    switch (array->GetDataType()) {
+        case VTK_DOUBLE: type = ColumnType::Float64; return true;
+        case VTK_FLOAT: type = ColumnType::Float32; return true;
+        case VTK_UNSIGNED_CHAR: type = ColumnType::UInt8; return true;
+        case VTK_UNSIGNED_SHORT: type = ColumnType::UInt16; return true;
+        case VTK_UNSIGNED_INT: type = ColumnType::UInt32; return true;
+        case VTK_ID_TYPE:
+        case VTK_LONG_LONG:
+            if (array->GetDataTypeSize() == 8) {
+                type = ColumnType::Int64;
+                return true;
+            }
+            return false;
+        default: return false;
+    }
+}
+
+// One column to be written: `count` elements read every `stride` bytes from `data`
+struct ColumnSource {
+    std::string name;
+    ColumnType type;
+    std::uint64_t count;
+    const char* data;
+    std::size_t stride;
+};
+
+// Split an interleaved VTK array into one column per component
+bool addArrayColumns(vtkDataArray* array, const std::vector<std::string>& names,
+                     std::vector<ColumnSource>& columns) {
+    ColumnType type;
+    if (!columnTypeFor(array, type)) {
+        std::cerr << "警告: " << array->GetName() << " は未対応のデータ型のため列ファイルに出力しません" << std::endl;
+        return true;
+    }
+    int components = array->GetNumberOfComponents();
+    std::size_t size = columnTypeSize(type);
+    const char* base = static_cast<const char*>(array->GetVoidPointer(0));
+    for (int c = 0; c < components; ++c) {
+        const std::string& name = names[c];
+        if (name.size() >= sizeof(ColumnEntry::name)) {
+            std::cerr << "エラー: 列名が長すぎます: " << name << std::endl;
+            return false;
+        }
+        columns.push_back({name, type, static_cast<std::uint64_t>(array->GetNumberOfTuples()),
+                           base + c * size, components * size});
+    }
+    return true;
+}
+
+std::vector<std::string> componentNames(const std::string& name, int components) {
+    std::vector<std::string> names;
+    if (components == 1) {
+        names.push_back(name);
+    } else {
+        for (int c = 0; c < components; ++c) {
+            names.push_back(name + "[" + std::to_string(c) + "]");
+        }
+    }
+    return names;
+}
+
+} // namespace
+
+ColumnarResultFile::ColumnarResultFile()
+    : mapping_(nullptr)
+    , mapping_size_(0)
+    , num_points_(0)
+    , num_cells_(0)
+    , columns_(nullptr)
+    , num_columns_(0)
+{
+}
+
+ColumnarResultFile::~ColumnarResultFile() {
+    close();
+}
+
+void ColumnarResultFile::close() {
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    num_points_ = 0;
+    num_cells_ = 0;
+    columns_ = nullptr;
+    num_columns_ = 0;
+}
+
+int ColumnarResultFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "エラー: 列ファイルを開けませんでした: " << filename << std::endl;
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        std::cerr << "エラー: 列ファイルが不正です: " << filename << std::endl;
+        return 1;
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "エラー: 列ファイルをマップできませんでした: " << filename << std::endl;
+        return 1;
+    }
+    mapping_ = mapping;
+    mapping_size_ = size;
+
+    // Validate header and TOC bounds once so that getColumn() can trust them
+    const FileHeader* header = static_cast<const FileHeader*>(mapping_);
+    bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+                 header->version == kVersion &&
+                 header->file_size == size &&
+                 header->toc_offset >= sizeof(FileHeader) &&
+                 header->toc_offset <= size &&
+                 header->num_columns <= (size - header->toc_offset) / sizeof(ColumnEntry);  // No overflow
+    if (valid) {
+        columns_ = reinterpret_cast<const ColumnEntry*>(static_cast<const char*>(mapping_) + header->toc_offset);
+        for (std::uint32_t i = 0; i < header->num_columns && valid; ++i) {
+            const ColumnEntry& entry = columns_[i];
+            std::size_t type_size = columnTypeSize(entry.type);
+            valid = type_size > 0 &&
+                    entry.offset % kAlignment == 0 &&
+                    entry.offset <= size &&
+                    entry.count <= (size - entry.offset) / type_size &&
+                    std::memchr(entry.name, '\0', sizeof(entry.name)) != nullptr;
+        }
+    }
+    if (!valid) {
+        close();
+        std::cerr << "エラー: 列ファイルが不正です: " << filename << std::endl;
+        return 1;
+    }
+
+    num_points_ = header->num_points;
+    num_cells_ = header->num_cells;
+    num_columns_ = header->num_columns;
+    return 0;
+}
+
+std::uint64_t ColumnarResultFile::getNumberOfPoints() const {
+    return num_points_;
+}
+
+std::uint64_t ColumnarResultFile::getNumberOfCells() const {
+    return num_cells_;
+}
+
+std::vector<std::string> ColumnarResultFile::getColumnNames() const {
+    std::vector<std::string> names;
+    for (std::uint32_t i = 0; i < num_columns_; ++i) {
+        names.push_back(columns_[i].name);
+    }
+    return names;
+}
+
+bool ColumnarResultFile::hasColumn(const std::string& name) const {
+    return findColumn(name) != nullptr;
+}
+
+const ColumnEntry* ColumnarResultFile::findColumn(const std::string& name) const {
+    for (std::uint32_t i = 0; i < num_columns_; ++i) {
+        if (name == columns_[i].name) {
+            return &columns_[i];
+        }
+    }
+    return nullptr;
+}
+
+int ColumnarResultFile::write(const std::string& filename, vtkUnstructuredGrid* grid) {
+    std::vector<ColumnSource> columns;
+
+    // Coordinates
+    vtkIdType num_points = grid->GetNumberOfPoints();
+    if (num_points > 0 && !addArrayColumns(grid->GetPoints()->GetData(),
+                                           {"points.x", "points.y", "points.z"}, columns)) {
+        return 1;
+    }
+
+    // Connectivity as flat 0-based point indices with CSR offsets
+    vtkIdType num_cells = grid->GetNumberOfCells();
+    std::vector<std::int64_t> connectivity;
+    std::vector<std::int64_t> offsets(1, 0);
+    std::vector<std::uint8_t> types;
+    offsets.reserve(num_cells + 1);
+    types.reserve(num_cells);
+    auto cell_points = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType i = 0; i < num_cells; ++i) {
+        grid->GetCellPoints(i, cell_points);
+        for (vtkIdType j = 0; j < cell_points->GetNumberOfIds(); ++j) {
+            connectivity.push_back(cell_points->GetId(j));
+        }
+        offsets.push_back(static_cast<std::int64_t>(connectivity.size()));
+        types.push_back(static_cast<std::uint8_t>(grid->GetCellType(i)));
+    }
+    columns.push_back({"cells.connectivity", ColumnType::Int64, connectivity.size(),
+                       reinterpret_cast<const char*>(connectivity.data()), sizeof(std::int64_t)});
+    columns.push_back({"cells.offsets", ColumnType::Int64, offsets.size(),
+                       reinterpret_cast<const char*>(offsets.data()), sizeof(std::int64_t)});
+    columns.push_back({"cells.types", ColumnType::UInt8, types.size(),
+                       reinterpret_cast<const char*>(types.data()), sizeof(std::uint8_t)});
+
+    // Point fields and field data (e.g. quantization parameters)
+    vtkFieldData* sources[] = {grid->GetPointData(), grid->GetFieldData()};
+    for (vtkFieldData* data : sources) {
+        for (int a = 0; a < data->GetNumberOfArrays(); ++a) {
+            vtkDataArray* array = data->GetArray(a);
+            if (!array || !array->GetName()) continue;
+            if (!addArrayColumns(array, componentNames(array->GetName(), array->GetNumberOfComponents()), columns)) {
+                return 1;
+            }
+        }
+    }
+
+    // Lay out TOC and 64-byte-aligned columns
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.num_columns = static_cast<std::uint32_t>(columns.size());
+    header.num_points = static_cast<std::uint64_t>(num_points);
+    header.num_cells = static_cast<std::uint64_t>(num_cells);
+    header.toc_offset = sizeof(FileHeader);
+
+    std::vector<ColumnEntry> toc(columns.size());
+    std::uint64_t offset = alignUp(header.toc_offset + toc.size() * sizeof(ColumnEntry));
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        std::memset(&toc[i], 0, sizeof(ColumnEntry));
+        std::memcpy(toc[i].name, columns[i].name.c_str(), columns[i].name.size());
+        toc[i].type = columns[i].type;
+        toc[i].offset = offset;
+        toc[i].count = columns[i].count;
+        offset = alignUp(offset + columns[i].count * columnTypeSize(columns[i].type));
+    }
+    header.file_size = offset;
+
+    std::ofstream f(filename, std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) {
+        std::cerr << "エラー: 列ファイルを作成できませんでした: " << filename << std::endl;
+        return 1;
+    }
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    f.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(ColumnEntry)));
+
+    // Gather strided components through a bounded buffer
+    const char zeros[kAlignment] = {};
+    std::vector<char> buffer(1 << 20);
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        std::uint64_t position = static_cast<std::uint64_t>(f.tellp());
+        f.write(zeros, static_cast<std::streamsize>(toc[i].offset - position));
+
+        const ColumnSource& column = columns[i];
+        std::size_t size = columnTypeSize(column.type);
+        std::size_t per_buffer = buffer.size() / size;
+        for (std::uint64_t start = 0; start < column.count; start += per_buffer) {
+            std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(per_buffer, column.count - start));
+            if (column.stride == size) {
+                std::memcpy(buffer.data(), column.data + start * size, n * size);
+            } else {
+                for (std::size_t j = 0; j < n; ++j) {
+                    std::memcpy(&buffer[j * size], column.data + (start + j) * column.stride, size);
+                }
+            }
+            f.write(buffer.data(), static_cast<std::streamsize>(n * size));
+        }
+    }
+    std::uint64_t position = static_cast<std::uint64_t>(f.tellp());
+    f.write(zeros, static_cast<std::streamsize>(header.file_size - position));
+
+    if (!f.good()) {
+        std::cerr << "エラー: 列ファイルの書き込みに失敗しました: " << filename << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#ifndef COLUMNAR_RESULT_FILE_H
+#define COLUMNAR_RESULT_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class vtkUnstructuredGrid;
+
+/**
+ * Binary columnar result file (.strc)
+ *
+ * Layout: a 64-byte header, a table of contents with one 64-byte entry per
+ * column, then the columns themselves, each starting on a 64-byte boundary.
+ * Coordinates and multi-component fields are stored one column per component
+ * ("points.x", "Displacement[0]", ...); cells as "cells.connectivity",
+ * "cells.offsets" and "cells.types". All values are host (little) endian.
+ */
+enum class ColumnType : std::uint32_t {
+    Float64 = 1,
+    Float32 = 2,
+    Int64 = 3,
+    UInt8 = 4,
+    UInt16 = 5,
+    UInt32 = 6
+};
+
+template <class T> struct ColumnTypeOf;
+template <> struct ColumnTypeOf<double> { static constexpr ColumnType value = ColumnType::Float64; };
+template <> struct ColumnTypeOf<float> { static constexpr ColumnType value = ColumnType::Float32; };
+template <> struct ColumnTypeOf<std::int64_t> { static constexpr ColumnType value = ColumnType::Int64; };
+template <> struct ColumnTypeOf<std::uint8_t> { static constexpr ColumnType value = ColumnType::UInt8; };
+template <> struct ColumnTypeOf<std::uint16_t> { static constexpr ColumnType value = ColumnType::UInt16; };
+template <> struct ColumnTypeOf<std::uint32_t> { static constexpr ColumnType value = ColumnType::UInt32; };
+
+// Read-only view of a mapped column
+template <class T>
+struct ColumnView {
+    const T* data = nullptr;
+    std::size_t size = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    const T& operator[](std::size_t i) const { return data[i]; }
+    bool empty() const { return size == 0; }
+};
+
+struct ColumnEntry {
+    char name[40];
+    ColumnType type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t count;
+};
+
+class ColumnarResultFile {
+public:
+    ColumnarResultFile();
+    ~ColumnarResultFile();
+
+    ColumnarResultFile(const ColumnarResultFile&) = delete;
+    ColumnarResultFile& operator=(const ColumnarResultFile&) = delete;
+
+    // Map a result file; no data is parsed or copied
+    int open(const std::string& filename);
+    void close();
+
+    std::uint64_t getNumberOfPoints() const;
+    std::uint64_t getNumberOfCells() const;
+    std::vector<std::string> getColumnNames() const;
+    bool hasColumn(const std::string& name) const;
+
+    // Typed view of a column; empty if missing or of another type
+    template <class T>
+    ColumnView<T> getColumn(const std::string& name) const {
+        ColumnView<T> view;
+        const ColumnEntry* entry = findColumn(name);
+        if (entry && entry->type == ColumnTypeOf<T>::value) {
+            view.data = reinterpret_cast<const T*>(static_cast<const char*>(mapping_) + entry->offset);
+            view.size = static_cast<std::size_t>(entry->count);
+        }
+        return view;
+    }
+
+    // Write the points, cells, point data and field data of a grid
+    static int write(const std::string& filename, vtkUnstructuredGrid* grid);
+
+private:
+    const ColumnEntry* findColumn(const std::string& name) const;
+
+    void* mapping_;
+    std::size_t mapping_size_;
+    std::uint64_t num_points_;
+    std::uint64_t num_cells_;
+    const ColumnEntry* columns_;
+    std::uint32_t num_columns_;
+};
+
+#endif // COLUMNAR_RESULT_FILE_H
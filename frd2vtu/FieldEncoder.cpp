@@ -0,0 +1,157 @@
+#include "FieldEncoder.h"
+#include <vtkSmartPointer.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnsignedShortArray.h>
+#include <vtkUnsignedIntArray.h>
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include "parallel/TaskScheduler.h"
+
+namespace {
+
+// Encode values into out in parallel; encode(value, decoded) returns the stored value
+// and sets what it decodes back to. Returns the largest decoding error.
+template <class OutType, class Encode>
+double encodeValues(const double* values, vtkIdType count, OutType* out, Encode encode) {
+    std::mutex mutex;
+    double max_error = 0.0;
+    TaskScheduler::instance().parallelFor(0, static_cast<std::size_t>(count), 16384,
+                                          [&](std::size_t first, std::size_t last) {
+        double chunk_error = 0.0;
+        for (std::size_t i = first; i < last; ++i) {
+            double decoded;
+            out[i] = encode(values[i], decoded);
+            chunk_error = std::max(chunk_error, std::abs(values[i] - decoded));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        max_error = std::max(max_error, chunk_error);
+    });
+    return max_error;
+}
+
+// Snap values to multiples of `scale` above `offset` and store the integer codes
+template <class ArrayType, class CodeType>
+vtkSmartPointer<vtkDataArray> quantize(vtkDoubleArray* field, double offset, double scale, double& max_error) {
+    auto codes = vtkSmartPointer<ArrayType>::New();
+    codes->SetName(field->GetName());
+    codes->SetNumberOfComponents(field->GetNumberOfComponents());
+    codes->SetNumberOfTuples(field->GetNumberOfTuples());
+
+    const double* values = field->GetPointer(0);
+    vtkIdType count = field->GetNumberOfTuples() * field->GetNumberOfComponents();
+    double error = encodeValues(values, count, codes->GetPointer(0), [offset, scale](double value, double& decoded) {
+        CodeType code = static_cast<CodeType>(std::llround((value - offset) / scale));
+        decoded = offset + code * scale;
+        return code;
+    });
+    max_error = std::max(max_error, error);
+    return codes;
+}
+
+} // namespace
+
+FieldEncoder::FieldEncoder() {
+}
+
+FieldEncoder::~FieldEncoder() {
+}
+
+void FieldEncoder::setEncoding(const std::string& name, const FieldEncoding& encoding) {
+    encodings_[name] = encoding;
+}
+
+bool FieldEncoder::parsePrecision(const std::string& name, FieldPrecision& precision) {
+    if (name == "float64") {
+        precision = FieldPrecision::Float64;
+    } else if (name == "float32") {
+        precision = FieldPrecision::Float32;
+    } else if (name == "quantized") {
+        precision = FieldPrecision::Quantized;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+vtkSmartPointer<vtkDataArray> FieldEncoder::encode(vtkDoubleArray* field, vtkFieldData* metadata) {
+    std::string name = field->GetName();
+    FieldEncoding encoding;
+    auto it = encodings_.find(name);
+    if (it != encodings_.end()) {
+        encoding = it->second;
+    }
+
+    const double* values = field->GetPointer(0);
+    vtkIdType count = field->GetNumberOfTuples() * field->GetNumberOfComponents();
+    std::size_t bytes_before = static_cast<std::size_t>(count) * sizeof(double);
+    FieldEncodingReport report{name, FieldPrecision::Float64, 0.0, bytes_before, bytes_before};
+
+    vtkSmartPointer<vtkDataArray> encoded = field;
+    if (encoding.precision == FieldPrecision::Float32) {
+        auto single = vtkSmartPointer<vtkFloatArray>::New();
+        single->SetName(field->GetName());
+        single->SetNumberOfComponents(field->GetNumberOfComponents());
+        single->SetNumberOfTuples(field->GetNumberOfTuples());
+        report.max_error = encodeValues(values, count, single->GetPointer(0), [](double value, double& decoded) {
+            float rounded = static_cast<float>(value);
+            decoded = static_cast<double>(rounded);
+            return rounded;
+        });
+        encoded = single;
+        report.precision = FieldPrecision::Float32;
+        report.bytes_after = static_cast<std::size_t>(count) * sizeof(float);
+
+    } else if (encoding.precision == FieldPrecision::Quantized && count > 0) {
+        double lo = *std::min_element(values, values + count);
+        double hi = *std::max_element(values, values + count);
+        double magnitude = std::max(std::abs(lo), std::abs(hi));
+        double tolerance = encoding.relative ? encoding.tolerance * magnitude : encoding.tolerance;
+
+        // Codes step by twice the tolerance, so rounding stays within it
+        double scale = 2.0 * tolerance;
+        double max_code = scale > 0.0 ? std::ceil((hi - lo) / scale) : 0.0;
+        if (!(scale > 0.0) && hi > lo) {
+            std::cerr << "警告: " << name << " の量子化許容誤差が0のため float64 のまま出力します" << std::endl;
+        } else if (max_code > std::numeric_limits<unsigned int>::max()) {
+            std::cerr << "警告: " << name << " の量子化許容誤差が小さすぎるため float64 のまま出力します" << std::endl;
+        } else {
+            if (!(scale > 0.0)) {
+                scale = 1.0;  // Constant field: every code is 0
+            }
+            std::size_t code_size;
+            if (max_code <= std::numeric_limits<unsigned char>::max()) {
+                encoded = quantize<vtkUnsignedCharArray, unsigned char>(field, lo, scale, report.max_error);
+                code_size = sizeof(unsigned char);
+            } else if (max_code <= std::numeric_limits<unsigned short>::max()) {
+                encoded = quantize<vtkUnsignedShortArray, unsigned short>(field, lo, scale, report.max_error);
+                code_size = sizeof(unsigned short);
+            } else {
+                encoded = quantize<vtkUnsignedIntArray, unsigned int>(field, lo, scale, report.max_error);
+                code_size = sizeof(unsigned int);
+            }
+
+            auto dequantization = vtkSmartPointer<vtkDoubleArray>::New();
+            dequantization->SetName((name + "_quantization").c_str());
+            dequantization->SetNumberOfComponents(2);
+            dequantization->InsertNextTuple2(lo, scale);
+            metadata->AddArray(dequantization);
+
+            report.precision = FieldPrecision::Quantized;
+            report.bytes_after = static_cast<std::size_t>(count) * code_size;
+        }
+    }
+
+    reports_.push_back(report);
+    return encoded;
+}
+
+const std::vector<FieldEncodingReport>& FieldEncoder::getReports() const {
+    return reports_;
+}
@@ -0,0 +1,59 @@
+#ifndef FIELD_ENCODER_H
+#define FIELD_ENCODER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <cstddef>
+
+template <class T> class vtkSmartPointer;
+class vtkDataArray;
+class vtkDoubleArray;
+class vtkFieldData;
+
+enum class FieldPrecision {
+    Float64,
+    Float32,
+    Quantized
+};
+
+// Storage precision of one result field
+struct FieldEncoding {
+    FieldPrecision precision = FieldPrecision::Float64;
+    double tolerance = 0.0;   // Quantization error bound
+    bool relative = false;    // Tolerance is relative to the largest absolute value
+};
+
+// Outcome of encoding one field
+struct FieldEncodingReport {
+    std::string name;
+    FieldPrecision precision;
+    double max_error;         // Largest absolute deviation actually introduced
+    std::size_t bytes_before;
+    std::size_t bytes_after;
+};
+
+class FieldEncoder {
+public:
+    FieldEncoder();
+    ~FieldEncoder();
+
+    // Set encoding for an array name; unlisted arrays stay float64
+    void setEncoding(const std::string& name, const FieldEncoding& encoding);
+
+    // Encode a field; quantized fields get "<name>_quantization" = [offset, scale]
+    // in metadata so that value = offset + code * scale
+    vtkSmartPointer<vtkDataArray> encode(vtkDoubleArray* field, vtkFieldData* metadata);
+
+    // Reports of all fields encoded so far
+    const std::vector<FieldEncodingReport>& getReports() const;
+
+    // Parse precision name ("float64", "float32", "quantized")
+    static bool parsePrecision(const std::string& name, FieldPrecision& precision);
+
+private:
+    std::map<std::string, FieldEncoding> encodings_;
+    std::vector<FieldEncodingReport> reports_;
+};
+
+#endif // FIELD_ENCODER_H
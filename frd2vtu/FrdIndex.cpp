@@ -0,0 +1,232 @@
+#include "FrdIndex.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+const char* kIndexMagic = "FRDIDX";
+const int kIndexVersion = 2;
+
+// First whitespace-delimited token of a line
+std::string firstToken(const char* line, std::size_t length, std::size_t& end) {
+    std::size_t begin = 0;
+    while (begin < length && (line[begin] == ' ' || line[begin] == '\t')) ++begin;
+    end = begin;
+    while (end < length && line[end] != ' ' && line[end] != '\t' && line[end] != '\r') ++end;
+    return std::string(line + begin, end - begin);
+}
+
+} // namespace
+
+FrdIndex::FrdIndex()
+    : file_size_(0)
+    , file_mtime_(0)
+{
+}
+
+FrdIndex::~FrdIndex() {
+}
+
+std::string FrdIndex::getIndexFilename(const std::string& frd_filename) {
+    return frd_filename + ".idx";
+}
+
+bool FrdIndex::getFileStamp(const std::string& filename, std::uint64_t& size, std::int64_t& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(filename, ec);
+    if (ec) return false;
+    auto time = std::filesystem::last_write_time(filename, ec);
+    if (ec) return false;
+    mtime = static_cast<std::int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+int FrdIndex::open(const std::string& frd_filename) {
+    std::string index_filename = getIndexFilename(frd_filename);
+    if (load(index_filename, frd_filename) == 0) {
+        return 0;
+    }
+    if (build(frd_filename) != 0) {
+        return 1;
+    }
+    if (save(index_filename) != 0) {
+        std::cerr << "警告: FRDインデックスを保存できませんでした: " << index_filename << std::endl;
+    }
+    return 0;
+}
+
+int FrdIndex::build(const std::string& frd_filename) {
+    blocks_.clear();
+    if (!getFileStamp(frd_filename, file_size_, file_mtime_)) {
+        return 1;
+    }
+
+    std::ifstream f(frd_filename, std::ios::binary);
+    if (!f.is_open()) {
+        return 1;
+    }
+
+    FrdBlock current{"", 0, 0, 0, 0, 0};
+    bool in_block = false;
+    int last_step = 0;
+    int analysis_step = 0;
+
+    auto processLine = [&](const char* line, std::size_t length, std::uint64_t offset) {
+        std::size_t token_end;
+        std::string token = firstToken(line, length, token_end);
+
+        if (token == "1PSTEP") {
+            // Output number, increment and *STEP; written ahead of each result block
+            std::istringstream fields(std::string(line + token_end, length - token_end));
+            int output = 0, increment = 0, step = 0;
+            if (fields >> output >> increment >> step) {
+                analysis_step = step;
+            }
+        } else if (token == "2C" || token == "3C") {
+            current = {token == "2C" ? "NODES" : "ELEMENTS", offset, 0, 0, 0, 0};
+            in_block = true;
+        } else if (token.compare(0, 4, "100C") == 0) {
+            // Step number is the I5 field at columns 59-63 of the 100C header
+            int step = last_step;
+            if (length >= 63) {
+                try {
+                    step = std::stoi(std::string(line + 58, 5));
+                } catch (const std::exception&) {
+                }
+            }
+            last_step = step;
+            current = {"", offset, 0, step, 0, analysis_step};
+            in_block = true;
+        } else if (!in_block) {
+            return;
+        } else if (token == "-4" && current.type.empty()) {
+            std::size_t name_end;
+            current.type = firstToken(line + token_end, length - token_end, name_end);
+        } else if (token == "-1") {
+            ++current.records;
+        } else if (token == "-3" || token == "9999") {
+            current.size = offset + length + 1 - current.offset;
+            if (!current.type.empty()) {
+                blocks_.push_back(current);
+            }
+            in_block = false;
+        }
+    };
+
+    // Scan in large chunks; lines split across chunks are carried over
+    std::vector<char> buffer(1 << 20);
+    std::string carry;
+    std::uint64_t line_offset = 0;
+    while (f.read(buffer.data(), buffer.size()) || f.gcount() > 0) {
+        std::size_t count = static_cast<std::size_t>(f.gcount());
+        const char* data = buffer.data();
+        std::size_t start = 0;
+        while (start < count) {
+            const char* newline = static_cast<const char*>(std::memchr(data + start, '\n', count - start));
+            if (!newline) break;
+            std::size_t end = newline - data;
+            std::size_t length;
+            if (carry.empty()) {
+                length = end - start;
+                processLine(data + start, length, line_offset);
+            } else {
+                carry.append(data + start, end - start);
+                length = carry.size();
+                processLine(carry.data(), length, line_offset);
+                carry.clear();
+            }
+            line_offset += length + 1;
+            start = end + 1;
+        }
+        carry.append(data + start, count - start);
+    }
+    if (!carry.empty()) {
+        processLine(carry.data(), carry.size(), line_offset);
+    }
+
+    return 0;
+}
+
+int FrdIndex::load(const std::string& index_filename, const std::string& frd_filename) {
+    std::ifstream f(index_filename);
+    if (!f.is_open()) {
+        return 1;
+    }
+
+    std::string magic;
+    int version;
+    std::uint64_t size;
+    std::int64_t mtime;
+    if (!(f >> magic >> version >> size >> mtime) || magic != kIndexMagic || version != kIndexVersion) {
+        return 1;
+    }
+
+    std::uint64_t current_size;
+    std::int64_t current_mtime;
+    if (!getFileStamp(frd_filename, current_size, current_mtime) ||
+        current_size != size || current_mtime != mtime) {
+        return 1;
+    }
+
+    std::vector<FrdBlock> blocks;
+    FrdBlock block;
+    while (f >> block.type >> block.offset >> block.size >> block.step >> block.records >> block.analysis_step) {
+        blocks.push_back(block);
+    }
+
+    blocks_.swap(blocks);
+    file_size_ = size;
+    file_mtime_ = mtime;
+    return 0;
+}
+
+int FrdIndex::save(const std::string& index_filename) const {
+    std::ofstream f(index_filename);
+    if (!f.is_open()) {
+        return 1;
+    }
+
+    f << kIndexMagic << " " << kIndexVersion << "\n";
+    f << file_size_ << " " << file_mtime_ << "\n";
+    for (const auto& block : blocks_) {
+        f << block.type << " " << block.offset << " " << block.size << " "
+          << block.step << " " << block.records << " " << block.analysis_step << "\n";
+    }
+    return f.good() ? 0 : 1;
+}
+
+const std::vector<FrdBlock>& FrdIndex::getBlocks() const {
+    return blocks_;
+}
+
+const FrdBlock* FrdIndex::findBlock(const std::string& type, int step) const {
+    const FrdBlock* found = nullptr;
+    for (const auto& block : blocks_) {
+        if (block.type == type && (step == 0 || block.step == step)) {
+            found = &block;
+        }
+    }
+    return found;
+}
+
+const FrdBlock* FrdIndex::findAnalysisStepBlock(const std::string& type, int analysis_step) const {
+    const FrdBlock* found = nullptr;
+    for (const auto& block : blocks_) {
+        if (block.type == type && block.analysis_step == analysis_step) {
+            found = &block;
+        }
+    }
+    return found;
+}
+
+int FrdIndex::getLastStep() const {
+    int last = 0;
+    for (const auto& block : blocks_) {
+        last = std::max(last, block.step);
+    }
+    return last;
+}
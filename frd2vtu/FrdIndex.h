@@ -0,0 +1,52 @@
+#ifndef FRD_INDEX_H
+#define FRD_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Location of one block in an FRD file
+struct FrdBlock {
+    std::string type;       // "NODES", "ELEMENTS" or the result name ("DISP", "STRESS", ...)
+    std::uint64_t offset;   // Byte offset of the block header line
+    std::uint64_t size;     // Bytes up to and including the closing -3 line
+    int step;               // Output number of the 100C header (0 for the mesh blocks)
+    std::uint64_t records;  // Number of -1 records
+    int analysis_step;      // *STEP of the input deck, from the 1PSTEP record; 0 if there is none
+};
+
+class FrdIndex {
+public:
+    FrdIndex();
+    ~FrdIndex();
+
+    // Reuse the sidecar index if it is up to date, otherwise scan and save it
+    int open(const std::string& frd_filename);
+
+    // Scan the FRD file and record its blocks
+    int build(const std::string& frd_filename);
+
+    // Sidecar index file I/O; load fails if the index does not match the FRD file
+    int load(const std::string& index_filename, const std::string& frd_filename);
+    int save(const std::string& index_filename) const;
+
+    // Block lookup; step 0 selects the last step containing the block
+    const std::vector<FrdBlock>& getBlocks() const;
+    const FrdBlock* findBlock(const std::string& type, int step = 0) const;
+
+    // Block of the last increment written for a *STEP of the input deck; null if none
+    const FrdBlock* findAnalysisStepBlock(const std::string& type, int analysis_step) const;
+    int getLastStep() const;
+
+    // Sidecar file name for an FRD file
+    static std::string getIndexFilename(const std::string& frd_filename);
+
+private:
+    static bool getFileStamp(const std::string& filename, std::uint64_t& size, std::int64_t& mtime);
+
+    std::vector<FrdBlock> blocks_;
+    std::uint64_t file_size_;
+    std::int64_t file_mtime_;
+};
+
+#endif // FRD_INDEX_H
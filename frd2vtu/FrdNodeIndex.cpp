@@ -0,0 +1,22 @@
+#include "FrdNodeIndex.h"
+
+FrdNodeIndex::FrdNodeIndex() : contiguous_(true), size_(0) {
+}
+
+FrdNodeIndex::~FrdNodeIndex() {
+}
+
+void FrdNodeIndex::build(const std::vector<int>& node_ids) {
+    size_ = node_ids.size();
+    positions_.clear();
+    contiguous_ = true;
+    for (std::size_t i = 0; contiguous_ && i < node_ids.size(); ++i) {
+        contiguous_ = node_ids[i] == static_cast<int>(i) + 1;
+    }
+    if (!contiguous_) {
+        positions_.reserve(node_ids.size());
+        for (std::size_t i = 0; i < node_ids.size(); ++i) {
+            positions_[node_ids[i]] = static_cast<std::int64_t>(i);
+        }
+    }
+}
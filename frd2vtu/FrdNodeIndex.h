@@ -0,0 +1,35 @@
+#ifndef FRD_NODE_INDEX_H
+#define FRD_NODE_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Position of each FRD node number in the node block, for the element
+// connectivity and the result records, which both refer to nodes by number
+class FrdNodeIndex {
+public:
+    FrdNodeIndex();
+    ~FrdNodeIndex();
+
+    void build(const std::vector<int>& node_ids);
+
+    // Position of the node; -1 if there is no such node
+    std::int64_t find(int node_id) const {
+        if (contiguous_) {
+            return node_id >= 1 && static_cast<std::size_t>(node_id) <= size_ ? node_id - 1 : -1;
+        }
+        auto it = positions_.find(node_id);
+        return it != positions_.end() ? it->second : -1;
+    }
+
+    std::size_t size() const { return size_; }
+
+private:
+    bool contiguous_;  // Numbered 1..n in order, which needs no table
+    std::size_t size_;
+    std::unordered_map<int, std::int64_t> positions_;
+};
+
+#endif // FRD_NODE_INDEX_H
@@ -0,0 +1,321 @@
+#include "FrdQuery.h"
+#include "FrdIndex.h"
+#include "parallel/TaskScheduler.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+// Maximum *INCLUDE nesting followed when reading node sets
+const int kMaxIncludeDepth = 8;
+
+// Bytes per parse chunk; at most one chunk per thread is held in memory
+const std::size_t kChunkBytes = 4 << 20;
+
+// FRD stress is in MPa; the VTU output (and therefore every report) uses Pa
+const double kStressScale = 1e6;
+
+bool lessValue(const NodeValue& a, const NodeValue& b) {
+    return a.value > b.value;  // min-heap on value
+}
+
+void pushTopK(std::vector<NodeValue>& heap, std::size_t k, const NodeValue& candidate) {
+    if (k == 0) return;
+    if (heap.size() < k) {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end(), lessValue);
+    } else if (candidate.value > heap.front().value) {
+        std::pop_heap(heap.begin(), heap.end(), lessValue);
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end(), lessValue);
+    }
+}
+
+std::string upper(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::toupper(c); });
+    return s;
+}
+
+// *NSET blocks of an INP file and of the files it includes (the mesh file of a case deck)
+int readNodeSetsOf(const std::string& inp_filename,
+                   const std::vector<std::string>& wanted,
+                   const std::vector<std::string>& names,
+                   std::map<std::string, std::vector<int>>& node_sets,
+                   int depth) {
+    std::ifstream f(inp_filename);
+    if (!f.is_open()) {
+        std::cerr << "エラー: INPファイルを開けませんでした: " << inp_filename << std::endl;
+        return 1;
+    }
+
+    std::string line;
+    std::vector<int>* current = nullptr;
+    while (std::getline(f, line)) {
+        if (line.compare(0, 2, "**") == 0) continue;
+        if (!line.empty() && line[0] == '*') {
+            current = nullptr;
+            std::string keyword = upper(line);
+            if (keyword.compare(0, 8, "*INCLUDE") == 0 && depth < kMaxIncludeDepth) {
+                std::size_t input = keyword.find("INPUT=");
+                if (input == std::string::npos) continue;
+                std::string included = line.substr(input + 6);
+                included = included.substr(0, included.find_first_of(", \r"));
+                // CalculiX resolves the name from its working directory; fall back to the deck's directory
+                std::filesystem::path path(included);
+                if (!std::filesystem::exists(path) && path.is_relative()) {
+                    path = std::filesystem::path(inp_filename).parent_path() / path;
+                }
+                if (readNodeSetsOf(path.string(), wanted, names, node_sets, depth + 1) != 0) {
+                    return 1;
+                }
+                continue;
+            }
+            std::size_t pos = keyword.find("NSET=");
+            if (keyword.compare(0, 5, "*NSET") != 0 || pos == std::string::npos) continue;
+
+            std::string set_name = keyword.substr(pos + 5);
+            set_name = set_name.substr(0, set_name.find_first_of(", \r"));
+            auto it = std::find(wanted.begin(), wanted.end(), set_name);
+            if (it != wanted.end()) {
+                current = &node_sets[names[it - wanted.begin()]];
+            }
+            continue;
+        }
+        if (!current) continue;
+
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream ss(line);
+        int node;
+        while (ss >> node) {
+            current->push_back(node);
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+struct FrdQuery::Reduction {
+    NodeValue max{0, -std::numeric_limits<double>::infinity()};
+    std::vector<NodeValue> top;  // bounded min-heap
+    std::vector<double> sum;
+    std::vector<double> maximum;
+    std::vector<std::size_t> count;
+
+    explicit Reduction(std::size_t num_sets)
+        : sum(num_sets, 0.0)
+        , maximum(num_sets, -std::numeric_limits<double>::infinity())
+        , count(num_sets, 0)
+    {
+    }
+
+    void merge(const Reduction& other, std::size_t k) {
+        if (other.max.value > max.value) max = other.max;
+        for (const auto& candidate : other.top) pushTopK(top, k, candidate);
+        for (std::size_t s = 0; s < sum.size(); ++s) {
+            sum[s] += other.sum[s];
+            maximum[s] = std::max(maximum[s], other.maximum[s]);
+            count[s] += other.count[s];
+        }
+    }
+};
+
+FrdQuery::FrdQuery()
+    : top_k_(10)
+    , step_(0)
+    , threads_(TaskScheduler::instance().getThreadCount())
+{
+}
+
+FrdQuery::~FrdQuery() {
+}
+
+void FrdQuery::setTopK(std::size_t k) {
+    top_k_ = k;
+}
+
+void FrdQuery::setStep(int step) {
+    step_ = step;
+}
+
+void FrdQuery::setThreads(unsigned threads) {
+    threads_ = std::max(1u, threads);
+}
+
+void FrdQuery::addNodeSet(const std::string& name, const std::vector<int>& nodes) {
+    std::size_t index = set_names_.size();
+    set_names_.push_back(name);
+    for (int node : nodes) {
+        auto& sets = node_membership_[node];
+        if (std::find(sets.begin(), sets.end(), index) == sets.end()) {
+            sets.push_back(index);
+        }
+    }
+}
+
+int FrdQuery::reduceBlock(const std::string& frd_filename, std::uint64_t offset, std::uint64_t size,
+                          bool stress, Reduction& reduction) const {
+    std::ifstream f(frd_filename, std::ios::binary);
+    if (!f.is_open()) {
+        return 1;
+    }
+    f.seekg(static_cast<std::streamoff>(offset));
+
+    std::size_t num_sets = set_names_.size();
+    std::size_t k = stress ? top_k_ : 0;
+    int components = stress ? 6 : 3;
+
+    // Parse the -1 records of one chunk of whole lines
+    auto reduceChunk = [this, num_sets, k, components, stress](const std::string& chunk) {
+        Reduction partial(num_sets);
+        const char* p = chunk.data();
+        const char* end = p + chunk.size();
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!eol) eol = end;
+            const char* q = p;
+            while (q < eol && *q == ' ') ++q;
+            if (eol - q > 2 && q[0] == '-' && q[1] == '1' && q[2] == ' ') {
+                char* next;
+                int node = static_cast<int>(std::strtol(q + 2, &next, 10));
+                double v[6] = {0, 0, 0, 0, 0, 0};
+                for (int c = 0; c < components; ++c) {
+                    v[c] = std::strtod(next, &next);
+                }
+
+                double value;
+                if (stress) {
+                    for (double& s : v) s *= kStressScale;
+                    value = std::sqrt(0.5 * ((v[0] - v[1]) * (v[0] - v[1]) +
+                                             (v[1] - v[2]) * (v[1] - v[2]) +
+                                             (v[2] - v[0]) * (v[2] - v[0]) +
+                                             6.0 * (v[3] * v[3] + v[4] * v[4] + v[5] * v[5])));
+                } else {
+                    value = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+                }
+
+                if (value > partial.max.value) partial.max = {node, value};
+                pushTopK(partial.top, k, {node, value});
+                if (num_sets > 0) {
+                    auto it = node_membership_.find(node);
+                    if (it != node_membership_.end()) {
+                        for (std::size_t s : it->second) {
+                            partial.sum[s] += value;
+                            partial.maximum[s] = std::max(partial.maximum[s], value);
+                            ++partial.count[s];
+                        }
+                    }
+                }
+            }
+            p = eol + 1;
+        }
+        return partial;
+    };
+
+    // Read up to one chunk per thread, reduce them concurrently, merge, repeat
+    std::uint64_t remaining = size;
+    std::string carry;
+    while (remaining > 0 || !carry.empty()) {
+        std::vector<std::string> chunks;
+        for (unsigned t = 0; t < threads_ && (remaining > 0 || !carry.empty()); ++t) {
+            std::size_t bytes = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, kChunkBytes));
+            std::string chunk;
+            chunk.swap(carry);
+            std::size_t base = chunk.size();
+            chunk.resize(base + bytes);
+            f.read(&chunk[base], static_cast<std::streamsize>(bytes));
+            remaining -= bytes;
+
+            // Keep the trailing partial line for the next chunk
+            if (remaining > 0) {
+                std::size_t last_newline = chunk.rfind('\n');
+                if (last_newline != std::string::npos) {
+                    carry.assign(chunk, last_newline + 1, std::string::npos);
+                    chunk.resize(last_newline + 1);
+                }
+            }
+            chunks.push_back(std::move(chunk));
+        }
+        std::vector<Reduction> partials(chunks.size(), Reduction(num_sets));
+        TaskScheduler::instance().parallelFor(0, chunks.size(), 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; ++c) {
+                partials[c] = reduceChunk(chunks[c]);
+            }
+        });
+        for (const Reduction& partial : partials) {
+            reduction.merge(partial, k);
+        }
+    }
+    return f.bad() ? 1 : 0;
+}
+
+int FrdQuery::run(const std::string& frd_filename, FrdQueryResult& result) const {
+    FrdIndex index;
+    if (index.open(frd_filename) != 0) {
+        std::cerr << "エラー: FRDファイルを開けませんでした: " << frd_filename << std::endl;
+        return 1;
+    }
+
+    result.step = step_ > 0 ? step_ : index.getLastStep();
+    result.has_stress = false;
+    result.has_displacement = false;
+    result.max_von_mises = {0, 0.0};
+    result.max_displacement = {0, 0.0};
+    result.hotspots.clear();
+    result.surfaces.clear();
+
+    std::size_t num_sets = set_names_.size();
+    Reduction stress(num_sets), displacement(num_sets);
+
+    const FrdBlock* stress_block = index.findBlock("STRESS", step_);
+    if (stress_block) {
+        if (reduceBlock(frd_filename, stress_block->offset, stress_block->size, true, stress) != 0) {
+            return 1;
+        }
+        result.has_stress = true;
+        result.max_von_mises = stress.max;
+        result.hotspots = stress.top;
+        std::sort_heap(result.hotspots.begin(), result.hotspots.end(), lessValue);
+    }
+
+    const FrdBlock* disp_block = index.findBlock("DISP", step_);
+    if (disp_block) {
+        if (reduceBlock(frd_filename, disp_block->offset, disp_block->size, false, displacement) != 0) {
+            return 1;
+        }
+        result.has_displacement = true;
+        result.max_displacement = displacement.max;
+    }
+
+    for (std::size_t s = 0; s < num_sets; ++s) {
+        SurfaceSummary summary{set_names_[s], 0, 0.0, 0.0, 0.0, 0.0};
+        if (stress.count[s] > 0) {
+            summary.nodes = stress.count[s];
+            summary.mean_von_mises = stress.sum[s] / stress.count[s];
+            summary.max_von_mises = stress.maximum[s];
+        }
+        if (displacement.count[s] > 0) {
+            summary.nodes = std::max(summary.nodes, displacement.count[s]);
+            summary.mean_displacement = displacement.sum[s] / displacement.count[s];
+            summary.max_displacement = displacement.maximum[s];
+        }
+        result.surfaces.push_back(summary);
+    }
+    return 0;
+}
+
+int FrdQuery::readNodeSets(const std::string& inp_filename,
+                           const std::vector<std::string>& names,
+                           std::map<std::string, std::vector<int>>& node_sets) {
+    std::vector<std::string> wanted;
+    for (const auto& name : names) wanted.push_back(upper(name));
+    return readNodeSetsOf(inp_filename, wanted, names, node_sets, 0);
+}
@@ -0,0 +1,71 @@
+#ifndef FRD_QUERY_H
+#define FRD_QUERY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+struct NodeValue {
+    int node;
+    double value;
+};
+
+// Reductions over the nodes of one surface node set
+struct SurfaceSummary {
+    std::string name;
+    std::size_t nodes;
+    double mean_von_mises;
+    double max_von_mises;
+    double mean_displacement;
+    double max_displacement;
+};
+
+// Answers of one query; von Mises stress uses the same units as the VTU output
+struct FrdQueryResult {
+    int step;
+    bool has_stress;
+    bool has_displacement;
+    NodeValue max_von_mises;
+    NodeValue max_displacement;
+    std::vector<NodeValue> hotspots;  // Highest von Mises nodes, descending
+    std::vector<SurfaceSummary> surfaces;
+};
+
+class FrdQuery {
+public:
+    FrdQuery();
+    ~FrdQuery();
+
+    // Query parameters
+    void setTopK(std::size_t k);
+    void setStep(int step);
+    void setThreads(unsigned threads);
+
+    // Register a node set for per-surface reductions
+    void addNodeSet(const std::string& name, const std::vector<int>& nodes);
+
+    // Stream the FRD result blocks and compute all reductions
+    int run(const std::string& frd_filename, FrdQueryResult& result) const;
+
+    // Read the named *NSET blocks from an INP file
+    static int readNodeSets(const std::string& inp_filename,
+                            const std::vector<std::string>& names,
+                            std::map<std::string, std::vector<int>>& node_sets);
+
+private:
+    struct Reduction;
+
+    int reduceBlock(const std::string& frd_filename, std::uint64_t offset, std::uint64_t size,
+                    bool stress, Reduction& reduction) const;
+
+    std::size_t top_k_;
+    int step_;
+    unsigned threads_;
+    std::vector<std::string> set_names_;
+    std::unordered_map<int, std::vector<std::size_t>> node_membership_;  // node -> node set indices
+};
+
+#endif // FRD_QUERY_H
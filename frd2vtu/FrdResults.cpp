@@ -0,0 +1,254 @@
+#include "FrdResults.h"
+#include "FrdIndex.h"
+#include "FrdNodeIndex.h"
+#include "parallel/TaskScheduler.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Values per node of the result blocks we understand
+int componentsOf(const std::string& type) {
+    if (type == "DISP") return 3;
+    if (type == "STRESS" || type == "TOSTRAIN") return 6;
+    if (type == "ERROR") return 1;
+    return 0;
+}
+
+// Nodes of an FRD element type; 0 if unknown
+int nodesOfElement(int type) {
+    static const int kNodes[] = {0, 8, 6, 4, 20, 15, 10, 3, 6, 4, 8, 2, 3};
+    return type > 0 && type < static_cast<int>(sizeof(kNodes) / sizeof(kNodes[0])) ? kNodes[type] : 0;
+}
+
+// Reads the lines of one block, seeking to it through the index
+class BlockReader {
+public:
+    BlockReader(std::ifstream& file, const FrdBlock& block) : file_(file), remaining_(block.size) {
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>(block.offset));
+    }
+
+    bool next(std::string& line) {
+        if (remaining_ == 0 || !std::getline(file_, line)) return false;
+        remaining_ -= std::min<std::uint64_t>(remaining_, line.size() + 1);
+        return true;
+    }
+
+private:
+    std::ifstream& file_;
+    std::uint64_t remaining_;
+};
+
+// Record key ("-1", "-2", ...) of a line and a stream positioned after it
+bool recordOf(const std::string& line, std::stringstream& ss, std::string& key) {
+    ss.clear();
+    ss.str(line);
+    return static_cast<bool>(ss >> key);
+}
+
+void readNodes(std::ifstream& file, const FrdBlock& block, FrdResults& results) {
+    results.node_ids.reserve(block.records);
+    results.coordinates.reserve(3 * block.records);
+    BlockReader reader(file, block);
+    std::string line, key;
+    std::stringstream ss;
+    while (reader.next(line)) {
+        if (!recordOf(line, ss, key) || key != "-1") continue;
+        int node_id;
+        double x, y, z;
+        ss >> node_id >> x >> y >> z;
+        results.node_ids.push_back(node_id);
+        results.coordinates.insert(results.coordinates.end(), {x, y, z});
+    }
+}
+
+// Cells that refer to a node missing from the node block are dropped; returns their number
+std::size_t readElements(std::ifstream& file, const FrdBlock& block, const FrdNodeIndex& nodes, FrdResults& results) {
+    results.cell_ids.reserve(block.records);
+    results.cell_types.reserve(block.records);
+    results.cell_offsets.reserve(block.records + 1);
+    results.cell_offsets.push_back(0);
+    BlockReader reader(file, block);
+    std::string line, key;
+    std::stringstream ss;
+    std::size_t dropped = 0;
+    while (reader.next(line)) {
+        if (!recordOf(line, ss, key) || key != "-1") continue;
+        int cell_id = 0, type = 0;
+        ss >> cell_id >> type;
+
+        // The nodes follow on -2 lines, ten per line (20-node hexahedra and
+        // 15-node wedges of expanded shells take two)
+        std::size_t first = results.cell_connectivity.size();
+        std::size_t expected = static_cast<std::size_t>(std::max(1, nodesOfElement(type)));
+        bool valid = true;
+        while (results.cell_connectivity.size() - first < expected) {
+            if (!reader.next(line) || !recordOf(line, ss, key) || key != "-2") break;
+            int node_id;
+            while (ss >> node_id) {
+                std::int64_t index = nodes.find(node_id);
+                valid = valid && index >= 0;
+                results.cell_connectivity.push_back(index);
+            }
+        }
+        if (!valid) {
+            results.cell_connectivity.resize(first);
+            ++dropped;
+            continue;
+        }
+        if (results.cell_connectivity.size() == first) continue;
+        results.cell_ids.push_back(cell_id);
+        results.cell_types.push_back(type);
+        results.cell_offsets.push_back(static_cast<std::int64_t>(results.cell_connectivity.size()));
+    }
+    return dropped;
+}
+
+// Values are stored at the position of each record's node, which need not follow
+// the node block; nodes without a record keep 0
+void readField(std::ifstream& file, const FrdBlock& block, const FrdNodeIndex& nodes, FrdField& field) {
+    field.type = block.type;
+    field.step = block.step;
+    field.components = componentsOf(block.type);
+    field.values.assign(field.components * nodes.size(), 0.0);
+    BlockReader reader(file, block);
+    std::string line, key;
+    std::stringstream ss;
+    while (reader.next(line)) {
+        if (!recordOf(line, ss, key) || key != "-1") continue;
+        int node_id = 0;
+        ss >> node_id;
+        std::int64_t index = nodes.find(node_id);
+        if (index < 0) continue;
+        double* values = &field.values[static_cast<std::size_t>(index) * field.components];
+        for (int c = 0; c < field.components; ++c) {
+            ss >> values[c];
+        }
+    }
+}
+
+} // namespace
+
+std::size_t FrdResults::getNumberOfNodes() const {
+    return node_ids.size();
+}
+
+std::size_t FrdResults::getNumberOfCells() const {
+    return cell_ids.size();
+}
+
+const FrdField* FrdResults::findField(const std::string& type, int step) const {
+    const FrdField* found = nullptr;
+    for (const FrdField& field : fields) {
+        if (field.type != type) continue;
+        if (field.step == step) return &field;
+        if (step == 0 && (!found || field.step > found->step)) found = &field;
+    }
+    return found;
+}
+
+int readFrd(const std::string& frd_filename, const FrdReadOptions& options, FrdResults& results) {
+    results = FrdResults();
+
+    // Block offsets from the sidecar index, so only the selected blocks are read
+    FrdIndex index;
+    if (index.open(frd_filename) != 0) {
+        return EXIT_FAILURE;
+    }
+    std::ifstream file(frd_filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "エラー: ファイルを開けませんでした: " << frd_filename << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const FrdBlock* node_block = index.findBlock("NODES");
+    const FrdBlock* element_block = index.findBlock("ELEMENTS");
+    if (!node_block || !element_block) {
+        std::cerr << "エラー: FRDファイルにメッシュが含まれていません: " << frd_filename << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> fields = options.fields;
+    if (fields.empty()) {
+        fields = {"DISP", "STRESS", "TOSTRAIN", "ERROR"};
+    }
+
+    LoadCaseSuperposer superposer;
+    for (const auto& load_case : options.load_cases) {
+        superposer.addCase(load_case.step, load_case.weight);
+    }
+
+    // Plan the fields in output order: a block to read, or a type to superpose
+    std::vector<const FrdBlock*> field_blocks;
+    std::vector<std::string> superposed_types;
+    for (const std::string& type : fields) {
+        if (componentsOf(type) == 0) continue;
+
+        if (!options.load_cases.empty()) {
+            // Only results proportional to the load can be combined from the unit-load steps
+            if (!LoadCaseSuperposer::isLinearField(type)) {
+                std::cerr << "警告: " << type << " は荷重に比例しないため重ね合わせでは出力しません" << std::endl;
+                continue;
+            }
+            field_blocks.push_back(nullptr);
+            superposed_types.push_back(type);
+            continue;
+        }
+
+        std::size_t found = field_blocks.size();
+        if (options.all_steps) {
+            for (const FrdBlock& block : index.getBlocks()) {
+                if (block.type == type) field_blocks.push_back(&block);
+            }
+        } else if (const FrdBlock* block = index.findBlock(type, options.step)) {
+            field_blocks.push_back(block);
+        }
+        if (field_blocks.size() == found) {
+            std::cerr << "警告: FRDファイルに " << type << " ブロックがありません" << std::endl;
+        }
+    }
+    results.fields.resize(field_blocks.size());
+
+    // Element connectivity and result records refer to nodes by number, so they
+    // wait for the node block; each task reads through its own stream
+    TaskGraph graph;
+    FrdNodeIndex node_index;
+    std::size_t dropped_cells = 0;
+    TaskGraph::NodeId nodes = graph.add([&]() {
+        std::ifstream stream(frd_filename, std::ios::binary);
+        readNodes(stream, *node_block, results);
+        node_index.build(results.node_ids);
+    });
+    graph.add([&]() {
+        std::ifstream stream(frd_filename, std::ios::binary);
+        dropped_cells = readElements(stream, *element_block, node_index, results);
+    }, {nodes});
+    for (std::size_t f = 0; f < field_blocks.size(); ++f) {
+        if (!field_blocks[f]) continue;
+        graph.add([&, f]() {
+            std::ifstream stream(frd_filename, std::ios::binary);
+            readField(stream, *field_blocks[f], node_index, results.fields[f]);
+        }, {nodes});
+    }
+    graph.run();
+    if (dropped_cells > 0) {
+        std::cerr << "警告: 未定義の節点を参照する要素 " << dropped_cells << " 個を除外しました: "
+                  << frd_filename << std::endl;
+    }
+
+    std::size_t next_superposed = 0;
+    for (std::size_t f = 0; f < field_blocks.size(); ++f) {
+        if (field_blocks[f]) continue;
+        FrdField& field = results.fields[f];
+        field.type = superposed_types[next_superposed++];
+        field.components = componentsOf(field.type);
+        if (superposer.combine(frd_filename, index, node_index, field.type, field.components, field.values) != 0) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#ifndef FRD_RESULTS_H
+#define FRD_RESULTS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "LoadCaseSuperposer.h"
+
+// One nodal result block of one analysis step, node-major
+struct FrdField {
+    std::string type;             // FRD block name ("DISP", "STRESS", "TOSTRAIN", "ERROR")
+    int step = 0;                 // Analysis step; 0 for a load-case superposition
+    int components = 0;
+    std::vector<double> values;   // components values per node, in the order of node_ids; 0 for nodes without a record
+};
+
+// Mesh and results of an FRD file as flat arrays, independent of VTK
+struct FrdResults {
+    std::vector<int> node_ids;                   // FRD node numbers
+    std::vector<double> coordinates;             // x, y, z per node
+    std::vector<int> cell_ids;                   // FRD element numbers
+    std::vector<int> cell_types;                 // FRD element types (6 = 10-node tetrahedron, 4/5 = expanded shells)
+    std::vector<std::int64_t> cell_offsets;      // CSR: nodes of cell i are connectivity[offsets[i]..offsets[i+1])
+    std::vector<std::int64_t> cell_connectivity; // Indices into the node arrays
+    std::vector<FrdField> fields;
+
+    std::size_t getNumberOfNodes() const;
+    std::size_t getNumberOfCells() const;
+
+    // Field of the given block type; step 0 selects the last step read
+    const FrdField* findField(const std::string& type, int step = 0) const;
+};
+
+// What readFrd loads
+struct FrdReadOptions {
+    std::vector<std::string> fields;          // Result blocks to read; empty reads DISP, STRESS, TOSTRAIN, ERROR
+    int step = 0;                             // Analysis step to read; 0 selects the last step
+    bool all_steps = false;                   // Read the fields of every step instead of `step`
+    std::vector<LoadCaseWeight> load_cases;   // If not empty, read the weighted sum of these steps instead
+};
+
+// Parse the mesh and the selected result blocks of an FRD file
+int readFrd(const std::string& frd_filename, const FrdReadOptions& options, FrdResults& results);
+
+#endif // FRD_RESULTS_H
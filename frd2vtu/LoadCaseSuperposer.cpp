@@ -0,0 +1,98 @@
+#include "LoadCaseSuperposer.h"
+#include "FrdIndex.h"
+#include "FrdNodeIndex.h"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+LoadCaseSuperposer::LoadCaseSuperposer() {
+}
+
+LoadCaseSuperposer::~LoadCaseSuperposer() {
+}
+
+void LoadCaseSuperposer::addCase(int step, double weight) {
+    cases_.push_back({step, weight});
+}
+
+const std::vector<LoadCaseWeight>& LoadCaseSuperposer::getCases() const {
+    return cases_;
+}
+
+bool LoadCaseSuperposer::isLinearField(const std::string& field) {
+    return field == "DISP" || field == "STRESS" || field == "TOSTRAIN";
+}
+
+int LoadCaseSuperposer::readBlock(const std::string& frd_filename, const FrdIndex& index,
+                                  const FrdNodeIndex& nodes, const std::string& field, int step, int components,
+                                  std::vector<double>& values) {
+    // Cases are *STEPs of the deck; ccx numbers its outputs per increment, so
+    // match the step of the 1PSTEP record and take its last increment
+    const FrdBlock* block = index.findAnalysisStepBlock(field, step);
+    if (!block) {
+        std::cerr << "エラー: FRDファイルに Step " << step << " の " << field << " ブロックがありません" << std::endl;
+        return 1;
+    }
+
+    std::ifstream f(frd_filename, std::ios::binary);
+    if (!f.is_open()) {
+        return 1;
+    }
+    std::string text(static_cast<std::size_t>(block->size), '\0');
+    f.seekg(static_cast<std::streamoff>(block->offset));
+    f.read(&text[0], static_cast<std::streamsize>(text.size()));
+    if (!f) {
+        return 1;
+    }
+
+    // -1 records, stored at the position of their node; nodes without one keep 0
+    values.assign(nodes.size() * components, 0.0);
+    const char* p = text.c_str();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        const char* q = p;
+        while (q < eol && *q == ' ') ++q;
+        if (eol - q > 2 && q[0] == '-' && q[1] == '1' && q[2] == ' ') {
+            char* next;
+            std::int64_t node = nodes.find(static_cast<int>(std::strtol(q + 2, &next, 10)));
+            for (int c = 0; node >= 0 && c < components; ++c) {
+                values[static_cast<std::size_t>(node) * components + c] = std::strtod(next, &next);
+            }
+        }
+        p = eol + 1;
+    }
+    return 0;
+}
+
+int LoadCaseSuperposer::combine(const std::string& frd_filename, const FrdIndex& index,
+                                const FrdNodeIndex& nodes, const std::string& field, int components,
+                                std::vector<double>& values) const {
+    values.clear();
+    std::vector<double> unit;
+    for (std::size_t i = 0; i < cases_.size(); ++i) {
+        if (cases_[i].weight == 0.0 && !values.empty()) continue;
+        if (readBlock(frd_filename, index, nodes, field, cases_[i].step, components, unit) != 0) {
+            return 1;
+        }
+        if (i == 0) {
+            values.assign(unit.size(), 0.0);
+        } else if (unit.size() != values.size()) {
+            std::cerr << "エラー: Step " << cases_[i].step << " の " << field
+                      << " の節点数が他の荷重ケースと一致しません" << std::endl;
+            return 1;
+        }
+
+        // Contiguous axpy; vectorized by the compiler
+        const double weight = cases_[i].weight;
+        const double* source = unit.data();
+        double* target = values.data();
+        const std::size_t n = values.size();
+        for (std::size_t j = 0; j < n; ++j) {
+            target[j] += weight * source[j];
+        }
+    }
+    return 0;
+}
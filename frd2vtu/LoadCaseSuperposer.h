@@ -0,0 +1,41 @@
+#ifndef LOAD_CASE_SUPERPOSER_H
+#define LOAD_CASE_SUPERPOSER_H
+
+#include <string>
+#include <vector>
+
+class FrdIndex;
+class FrdNodeIndex;
+
+// Contribution of one solved analysis step to a load combination
+struct LoadCaseWeight {
+    int step;  // *STEP of the input deck (1-based), not the FRD output number
+    double weight;
+};
+
+class LoadCaseSuperposer {
+public:
+    LoadCaseSuperposer();
+    ~LoadCaseSuperposer();
+
+    void addCase(int step, double weight);
+    const std::vector<LoadCaseWeight>& getCases() const;
+
+    // Weighted sum of a linear result block (DISP, STRESS, TOSTRAIN) over all
+    // cases; values are node-major with `components` entries per node, in the
+    // order of the node block
+    int combine(const std::string& frd_filename, const FrdIndex& index, const FrdNodeIndex& nodes,
+                const std::string& field, int components, std::vector<double>& values) const;
+
+    // Only fields proportional to the load can be superposed
+    static bool isLinearField(const std::string& field);
+
+private:
+    static int readBlock(const std::string& frd_filename, const FrdIndex& index, const FrdNodeIndex& nodes,
+                         const std::string& field, int step, int components,
+                         std::vector<double>& values);
+
+    std::vector<LoadCaseWeight> cases_;
+};
+
+#endif // LOAD_CASE_SUPERPOSER_H
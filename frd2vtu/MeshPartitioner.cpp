@@ -0,0 +1,327 @@
+#include "MeshPartitioner.h"
+#include "CellFaces.h"
+#include "parallel/TaskScheduler.h"
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkFieldData.h>
+#include <vtkDataArray.h>
+#include <vtkXMLUnstructuredGridWriter.h>
+#include <vtkCellType.h>
+#include <vtkType.h>
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+
+const char* xmlTypeName(int data_type) {
+    switch (data_type) {
+        case VTK_DOUBLE: return "Float64";
+        case VTK_FLOAT: return "Float32";
+        case VTK_UNSIGNED_CHAR: return "UInt8";
+        case VTK_UNSIGNED_SHORT: return "UInt16";
+        case VTK_UNSIGNED_INT: return "UInt32";
+        case VTK_INT: return "Int32";
+        case VTK_ID_TYPE: return "Int64";
+        default: return "Float64";
+    }
+}
+
+// One part as a standalone grid with compacted points
+vtkSmartPointer<vtkUnstructuredGrid> extractPiece(vtkUnstructuredGrid* grid, const std::vector<int>& cell_parts,
+                                                  int part, std::vector<vtkIdType>& point_map) {
+    std::fill(point_map.begin(), point_map.end(), -1);
+    std::vector<vtkIdType> kept_points;
+
+    auto piece = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    std::vector<vtkIdType> local;
+    for (vtkIdType cell = 0; cell < grid->GetNumberOfCells(); ++cell) {
+        if (cell_parts[cell] != part) continue;
+        vtkIdType npts;
+        const vtkIdType* pts;
+        grid->GetCellPoints(cell, npts, pts);
+        local.resize(npts);
+        for (vtkIdType i = 0; i < npts; ++i) {
+            if (point_map[pts[i]] < 0) {
+                point_map[pts[i]] = static_cast<vtkIdType>(kept_points.size());
+                kept_points.push_back(pts[i]);
+            }
+            local[i] = point_map[pts[i]];
+        }
+        piece->InsertNextCell(grid->GetCellType(cell), npts, local.data());
+    }
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataType(grid->GetPoints()->GetDataType());
+    points->SetNumberOfPoints(static_cast<vtkIdType>(kept_points.size()));
+    for (std::size_t i = 0; i < kept_points.size(); ++i) {
+        double x[3];
+        grid->GetPoints()->GetPoint(kept_points[i], x);
+        points->SetPoint(static_cast<vtkIdType>(i), x[0], x[1], x[2]);
+    }
+    piece->SetPoints(points);
+
+    // Copy point data tuples bytewise so encoded (float32/quantized) arrays stay exact
+    vtkPointData* source_data = grid->GetPointData();
+    for (int a = 0; a < source_data->GetNumberOfArrays(); ++a) {
+        vtkDataArray* source = source_data->GetArray(a);
+        if (source->GetNumberOfTuples() != grid->GetNumberOfPoints()) continue;
+
+        auto target = vtkSmartPointer<vtkDataArray>::Take(source->NewInstance());
+        target->SetName(source->GetName());
+        target->SetNumberOfComponents(source->GetNumberOfComponents());
+        target->SetNumberOfTuples(static_cast<vtkIdType>(kept_points.size()));
+        std::size_t tuple_bytes = static_cast<std::size_t>(source->GetDataTypeSize()) * source->GetNumberOfComponents();
+        const char* from = static_cast<const char*>(source->GetVoidPointer(0));
+        char* to = static_cast<char*>(target->GetVoidPointer(0));
+        for (std::size_t i = 0; i < kept_points.size(); ++i) {
+            std::memcpy(to + i * tuple_bytes, from + kept_points[i] * tuple_bytes, tuple_bytes);
+        }
+        piece->GetPointData()->AddArray(target);
+    }
+
+    // Each piece gets its own copy of the (small) field data, e.g. quantization parameters
+    auto field_data = vtkSmartPointer<vtkFieldData>::New();
+    field_data->DeepCopy(grid->GetFieldData());
+    piece->SetFieldData(field_data);
+    return piece;
+}
+
+} // namespace
+
+MeshPartitioner::MeshPartitioner()
+    : parts_(1)
+    , stamp_(0)
+{
+}
+
+MeshPartitioner::~MeshPartitioner() {
+}
+
+void MeshPartitioner::setNumberOfParts(int parts) {
+    parts_ = std::max(1, parts);
+}
+
+int MeshPartitioner::getNumberOfParts() const {
+    return parts_;
+}
+
+const PartitionQuality& MeshPartitioner::getQuality() const {
+    return quality_;
+}
+
+void MeshPartitioner::buildAdjacency(vtkUnstructuredGrid* grid) {
+    std::size_t num_cells = static_cast<std::size_t>(grid->GetNumberOfCells());
+
+    // Sort (face, cell) pairs; equal neighbours are cells sharing that face
+    // Face keys are the sorted corners, padded with -1 for triangles
+    std::vector<std::pair<std::array<vtkIdType, 4>, std::size_t>> faces;
+    faces.reserve(num_cells * 4);
+    for (std::size_t cell = 0; cell < num_cells; ++cell) {
+        const CellFace* cell_faces;
+        int num_faces = getCellFaces(grid->GetCellType(static_cast<vtkIdType>(cell)), cell_faces);
+        if (num_faces == 0) continue;
+        vtkIdType npts;
+        const vtkIdType* pts;
+        grid->GetCellPoints(static_cast<vtkIdType>(cell), npts, pts);
+        for (int f = 0; f < num_faces; ++f) {
+            const CellFace& face = cell_faces[f];
+            std::array<vtkIdType, 4> key = {-1, -1, -1, -1};
+            for (int k = 0; k < face.corners; ++k) {
+                key[k] = pts[face.nodes[k]];
+            }
+            std::sort(key.begin(), key.begin() + face.corners);
+            faces.push_back({key, cell});
+        }
+    }
+    std::sort(faces.begin(), faces.end());
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for (std::size_t i = 0; i + 1 < faces.size(); ++i) {
+        if (faces[i].first == faces[i + 1].first) {
+            edges.push_back({faces[i].second, faces[i + 1].second});
+            ++i;
+        }
+    }
+
+    adjacency_offsets_.assign(num_cells + 1, 0);
+    for (const auto& edge : edges) {
+        ++adjacency_offsets_[edge.first + 1];
+        ++adjacency_offsets_[edge.second + 1];
+    }
+    for (std::size_t cell = 0; cell < num_cells; ++cell) {
+        adjacency_offsets_[cell + 1] += adjacency_offsets_[cell];
+    }
+    adjacency_.resize(adjacency_offsets_.back());
+    std::vector<std::size_t> fill(adjacency_offsets_.begin(), adjacency_offsets_.end() - 1);
+    for (const auto& edge : edges) {
+        adjacency_[fill[edge.first]++] = edge.second;
+        adjacency_[fill[edge.second]++] = edge.first;
+    }
+}
+
+void MeshPartitioner::breadthFirstOrder(const std::vector<std::size_t>& cells, std::size_t start,
+                                        std::vector<std::size_t>& order) {
+    // Restart from the next unreached cell when a component is exhausted
+    ++stamp_;
+    order.clear();
+    std::size_t next_seed = 0;
+    std::size_t seed = start;
+    while (order.size() < cells.size()) {
+        if (visited_[seed] == stamp_) {
+            while (visited_[cells[next_seed]] == stamp_) ++next_seed;
+            seed = cells[next_seed];
+        }
+        std::size_t head = order.size();
+        visited_[seed] = stamp_;
+        order.push_back(seed);
+        while (head < order.size()) {
+            std::size_t cell = order[head++];
+            for (std::size_t k = adjacency_offsets_[cell]; k < adjacency_offsets_[cell + 1]; ++k) {
+                std::size_t neighbour = adjacency_[k];
+                if (subset_[neighbour] == subset_[cell] && visited_[neighbour] != stamp_) {
+                    visited_[neighbour] = stamp_;
+                    order.push_back(neighbour);
+                }
+            }
+        }
+    }
+}
+
+void MeshPartitioner::bisect(std::vector<std::size_t>& cells, int first_part, int parts, std::vector<int>& cell_parts) {
+    if (parts == 1 || cells.empty()) {
+        for (std::size_t cell : cells) {
+            cell_parts[cell] = first_part;
+        }
+        return;
+    }
+
+    // Level-structure bisection: BFS from a pseudo-peripheral cell, split by BFS rank
+    unsigned subset = ++stamp_;
+    for (std::size_t cell : cells) {
+        subset_[cell] = subset;
+    }
+    std::vector<std::size_t> order;
+    breadthFirstOrder(cells, cells.front(), order);
+    breadthFirstOrder(cells, order.back(), order);
+
+    int left_parts = parts / 2;
+    std::size_t split = cells.size() * left_parts / parts;
+    std::vector<std::size_t> left(order.begin(), order.begin() + split);
+    std::vector<std::size_t> right(order.begin() + split, order.end());
+    cells.clear();
+    cells.shrink_to_fit();
+    bisect(left, first_part, left_parts, cell_parts);
+    bisect(right, first_part + left_parts, parts - left_parts, cell_parts);
+}
+
+int MeshPartitioner::partition(vtkUnstructuredGrid* grid, std::vector<int>& cell_parts) {
+    std::size_t num_cells = static_cast<std::size_t>(grid->GetNumberOfCells());
+    cell_parts.assign(num_cells, 0);
+    quality_ = PartitionQuality();
+    quality_.parts = parts_;
+    quality_.sizes.assign(parts_, 0);
+    if (num_cells == 0) {
+        return 0;
+    }
+    if (static_cast<std::size_t>(parts_) > num_cells) {
+        std::cerr << "エラー: 分割数 " << parts_ << " が要素数 " << num_cells << " を超えています" << std::endl;
+        return 1;
+    }
+
+    buildAdjacency(grid);
+    subset_.assign(num_cells, 0);
+    visited_.assign(num_cells, 0);
+    stamp_ = 0;
+
+    std::vector<std::size_t> cells(num_cells);
+    for (std::size_t cell = 0; cell < num_cells; ++cell) {
+        cells[cell] = cell;
+    }
+    bisect(cells, 0, parts_, cell_parts);
+
+    for (std::size_t cell = 0; cell < num_cells; ++cell) {
+        ++quality_.sizes[cell_parts[cell]];
+        for (std::size_t k = adjacency_offsets_[cell]; k < adjacency_offsets_[cell + 1]; ++k) {
+            if (adjacency_[k] > cell && cell_parts[adjacency_[k]] != cell_parts[cell]) {
+                ++quality_.edge_cut;
+            }
+        }
+    }
+    double average = static_cast<double>(num_cells) / parts_;
+    quality_.imbalance = *std::max_element(quality_.sizes.begin(), quality_.sizes.end()) / average;
+
+    adjacency_offsets_.clear();
+    adjacency_.clear();
+    subset_.clear();
+    visited_.clear();
+    return 0;
+}
+
+int MeshPartitioner::writePieces(vtkUnstructuredGrid* grid, const std::vector<int>& cell_parts,
+                                 int parts, const std::string& pvtu_filename) {
+    std::filesystem::path pvtu_path(pvtu_filename);
+    std::string stem = pvtu_path.stem().string();
+
+    // Pieces are assembled here; only the encoding and writing run in threads
+    std::vector<vtkSmartPointer<vtkUnstructuredGrid>> pieces;
+    std::vector<std::string> piece_names;
+    std::vector<vtkIdType> point_map(grid->GetNumberOfPoints());
+    for (int part = 0; part < parts; ++part) {
+        pieces.push_back(extractPiece(grid, cell_parts, part, point_map));
+        piece_names.push_back(stem + "_" + std::to_string(part) + ".vtu");
+    }
+
+    std::atomic<bool> failed(false);
+    TaskScheduler::instance().parallelFor(0, static_cast<std::size_t>(parts), 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t part = first; part < last; ++part) {
+            auto writer = vtkSmartPointer<vtkXMLUnstructuredGridWriter>::New();
+            writer->SetFileName((pvtu_path.parent_path() / piece_names[part]).string().c_str());
+            writer->SetInputData(pieces[part]);
+            writer->SetDataModeToBinary(); // 大規模モデル向けなので圧縮バイナリで出力
+            if (writer->Write() == 0) {
+                failed = true;
+            }
+        }
+    });
+    if (failed) {
+        std::cerr << "エラー: VTUピースの書き込みに失敗しました: " << pvtu_filename << std::endl;
+        return 1;
+    }
+
+    // .pvtu index: array layout is shared by every piece
+    std::ofstream f(pvtu_filename);
+    if (!f.is_open()) {
+        std::cerr << "エラー: ファイルを開けませんでした: " << pvtu_filename << std::endl;
+        return 1;
+    }
+    f << "<?xml version=\"1.0\"?>\n";
+    f << "<VTKFile type=\"PUnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    f << "  <PUnstructuredGrid GhostLevel=\"0\">\n";
+    f << "    <PPointData>\n";
+    vtkPointData* point_data = pieces.front()->GetPointData();
+    for (int a = 0; a < point_data->GetNumberOfArrays(); ++a) {
+        vtkDataArray* array = point_data->GetArray(a);
+        f << "      <PDataArray type=\"" << xmlTypeName(array->GetDataType()) << "\" Name=\"" << array->GetName()
+          << "\" NumberOfComponents=\"" << array->GetNumberOfComponents() << "\"/>\n";
+    }
+    f << "    </PPointData>\n";
+    f << "    <PPoints>\n";
+    f << "      <PDataArray type=\"" << xmlTypeName(grid->GetPoints()->GetDataType())
+      << "\" NumberOfComponents=\"3\"/>\n";
+    f << "    </PPoints>\n";
+    for (const auto& name : piece_names) {
+        f << "    <Piece Source=\"" << name << "\"/>\n";
+    }
+    f << "  </PUnstructuredGrid>\n";
+    f << "</VTKFile>\n";
+    return f.good() ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#ifndef MESH_PARTITIONER_H
+#define MESH_PARTITIONER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+class vtkUnstructuredGrid;
+
+// Quality of a cell partition
+struct PartitionQuality {
+    int parts = 0;
+    std::size_t edge_cut = 0;          // Faces shared by cells of different parts
+    double imbalance = 0.0;            // Largest part / average part size
+    std::vector<std::size_t> sizes;    // Cells per part
+};
+
+class MeshPartitioner {
+public:
+    MeshPartitioner();
+    ~MeshPartitioner();
+
+    void setNumberOfParts(int parts);
+    int getNumberOfParts() const;
+
+    // Assign every cell a part by recursive bisection of the face-adjacency graph
+    int partition(vtkUnstructuredGrid* grid, std::vector<int>& cell_parts);
+
+    const PartitionQuality& getQuality() const;
+
+    // Write each part as <stem>_<i>.vtu in parallel threads plus the .pvtu index
+    static int writePieces(vtkUnstructuredGrid* grid, const std::vector<int>& cell_parts,
+                           int parts, const std::string& pvtu_filename);
+
+private:
+    void buildAdjacency(vtkUnstructuredGrid* grid);
+    void bisect(std::vector<std::size_t>& cells, int first_part, int parts, std::vector<int>& cell_parts);
+    void breadthFirstOrder(const std::vector<std::size_t>& cells, std::size_t start,
+                           std::vector<std::size_t>& order);
+
+    int parts_;
+    PartitionQuality quality_;
+    std::vector<std::size_t> adjacency_offsets_;  // CSR dual graph over cells
+    std::vector<std::size_t> adjacency_;
+    std::vector<unsigned> subset_;                // Stamp of the subset a cell is in
+    std::vector<unsigned> visited_;               // Stamp of the last BFS that reached a cell
+    unsigned stamp_;
+};
+
+#endif // MESH_PARTITIONER_H
@@ -0,0 +1,160 @@
+#include "ResultMirror.h"
+#include "parallel/TaskScheduler.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Node order of a reflected FRD element that keeps it positively oriented
+// (FRD orders of the he20 and pe15 mid-side nodes: bottom, vertical, top)
+const int kTetra4Mirror[] = {0, 2, 1, 3};
+const int kTetra10Mirror[] = {0, 2, 1, 3, 6, 5, 4, 7, 9, 8};
+const int kHexahedron8Mirror[] = {0, 3, 2, 1, 4, 7, 6, 5};
+const int kHexahedron20Mirror[] = {0, 3, 2, 1, 4, 7, 6, 5, 11, 10, 9, 8, 12, 15, 14, 13, 19, 18, 17, 16};
+const int kWedge6Mirror[] = {0, 2, 1, 3, 5, 4};
+const int kWedge15Mirror[] = {0, 2, 1, 3, 5, 4, 8, 7, 6, 9, 11, 10, 14, 13, 12};
+const int kTriangle3Mirror[] = {0, 2, 1};
+const int kTriangle6Mirror[] = {0, 2, 1, 5, 4, 3};
+const int kQuad4Mirror[] = {0, 3, 2, 1};
+const int kQuad8Mirror[] = {0, 3, 2, 1, 7, 6, 5, 4};
+
+// Reflected node order of an FRD element type with num_nodes nodes; nullptr keeps the order
+const int* mirrorOrderOf(int type, std::size_t num_nodes) {
+    struct MirrorOrder {
+        int type;
+        std::size_t nodes;
+        const int* order;
+    };
+    static const MirrorOrder kOrders[] = {
+        {1, 8, kHexahedron8Mirror}, {2, 6, kWedge6Mirror}, {3, 4, kTetra4Mirror},
+        {4, 20, kHexahedron20Mirror}, {5, 15, kWedge15Mirror}, {6, 10, kTetra10Mirror},
+        {7, 3, kTriangle3Mirror}, {8, 6, kTriangle6Mirror}, {9, 4, kQuad4Mirror}, {10, 8, kQuad8Mirror},
+    };
+    for (const MirrorOrder& order : kOrders) {
+        if (order.type == type && order.nodes == num_nodes) return order.order;
+    }
+    return nullptr;
+}
+
+// Components of a field that change sign across a plane normal to axis:
+// the axis component of a vector, the shear components with one axis index
+// of a tensor stored as xx, yy, zz, xy, yz, zx
+std::vector<int> flippedComponents(int components, int axis) {
+    if (components == 3) {
+        return {axis};
+    }
+    if (components == 6) {
+        const int kShears[3][2] = {{3, 5}, {3, 4}, {4, 5}};
+        return {kShears[axis][0], kShears[axis][1]};
+    }
+    return {};
+}
+
+void mirrorAcross(FrdResults& results, const MirrorPlane& plane) {
+    std::size_t num_nodes = results.getNumberOfNodes();
+    std::size_t num_cells = results.getNumberOfCells();
+    if (num_nodes == 0) return;
+
+    // FRD keeps five significant digits of the coordinates, so nodes of the
+    // plane are matched with a tolerance relative to the model size
+    double low = results.coordinates[plane.axis], high = low;
+    for (std::size_t i = 0; i < num_nodes; ++i) {
+        low = std::min(low, results.coordinates[3 * i + plane.axis]);
+        high = std::max(high, results.coordinates[3 * i + plane.axis]);
+    }
+    double tolerance = 1e-4 * std::max({high - low, std::abs(low), std::abs(high)});
+
+    // Image of each node: itself in the plane, a new node elsewhere
+    std::vector<std::int64_t> image(num_nodes);
+    std::vector<std::size_t> copied;
+    for (std::size_t i = 0; i < num_nodes; ++i) {
+        if (std::abs(results.coordinates[3 * i + plane.axis] - plane.position) <= tolerance) {
+            image[i] = static_cast<std::int64_t>(i);
+        } else {
+            image[i] = static_cast<std::int64_t>(num_nodes + copied.size());
+            copied.push_back(i);
+        }
+    }
+
+    int next_node_id = *std::max_element(results.node_ids.begin(), results.node_ids.end());
+    results.node_ids.reserve(num_nodes + copied.size());
+    for (std::size_t k = 0; k < copied.size(); ++k) {
+        results.node_ids.push_back(++next_node_id);
+    }
+    results.coordinates.resize(3 * (num_nodes + copied.size()));
+    TaskScheduler::instance().parallelFor(0, copied.size(), 16384, [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k < last; ++k) {
+            const double* source = results.coordinates.data() + 3 * copied[k];
+            double* target = results.coordinates.data() + 3 * (num_nodes + k);
+            for (int a = 0; a < 3; ++a) target[a] = source[a];
+            target[plane.axis] = 2.0 * plane.position - source[plane.axis];
+        }
+    });
+
+    for (FrdField& field : results.fields) {
+        if (field.components <= 0 || field.values.size() != num_nodes * field.components) continue;
+        std::size_t components = static_cast<std::size_t>(field.components);
+        std::vector<int> flipped = flippedComponents(field.components, plane.axis);
+        field.values.resize(components * (num_nodes + copied.size()));
+        TaskScheduler::instance().parallelFor(0, copied.size(), 16384, [&](std::size_t first, std::size_t last) {
+            for (std::size_t k = first; k < last; ++k) {
+                const double* source = field.values.data() + components * copied[k];
+                double* target = field.values.data() + components * (num_nodes + k);
+                std::copy(source, source + components, target);
+                for (int c : flipped) target[c] = -target[c];
+            }
+        });
+    }
+
+    // Reflected cells on the mirrored nodes
+    int next_cell_id = num_cells > 0 ? *std::max_element(results.cell_ids.begin(), results.cell_ids.end()) : 0;
+    results.cell_ids.reserve(2 * num_cells);
+    results.cell_types.reserve(2 * num_cells);
+    results.cell_offsets.reserve(2 * num_cells + 1);
+    results.cell_connectivity.reserve(2 * results.cell_connectivity.size());
+    for (std::size_t c = 0; c < num_cells; ++c) {
+        std::size_t begin = static_cast<std::size_t>(results.cell_offsets[c]);
+        std::size_t cell_nodes = static_cast<std::size_t>(results.cell_offsets[c + 1]) - begin;
+        const int* order = mirrorOrderOf(results.cell_types[c], cell_nodes);
+        for (std::size_t k = 0; k < cell_nodes; ++k) {
+            std::int64_t node = results.cell_connectivity[begin + (order ? static_cast<std::size_t>(order[k]) : k)];
+            results.cell_connectivity.push_back(node >= 0 ? image[node] : node);
+        }
+        results.cell_ids.push_back(++next_cell_id);
+        results.cell_types.push_back(results.cell_types[c]);
+        results.cell_offsets.push_back(static_cast<std::int64_t>(results.cell_connectivity.size()));
+    }
+}
+
+} // namespace
+
+int readMirrorPlanes(const std::string& filename, std::vector<MirrorPlane>& planes) {
+    planes.clear();
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return 0;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ss(line);
+        std::string axis;
+        MirrorPlane plane;
+        if (!(ss >> axis >> plane.position) || axis.size() != 1 || axis[0] < 'x' || axis[0] > 'z') {
+            std::cerr << "エラー: 対称面の指定が不正です: " << filename << ": " << line << std::endl;
+            return 1;
+        }
+        plane.axis = axis[0] - 'x';
+        planes.push_back(plane);
+    }
+    return 0;
+}
+
+void mirrorResults(FrdResults& results, const std::vector<MirrorPlane>& planes) {
+    for (const MirrorPlane& plane : planes) {
+        mirrorAcross(results, plane);
+    }
+}
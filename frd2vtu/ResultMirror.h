@@ -0,0 +1,23 @@
+#ifndef RESULT_MIRROR_H
+#define RESULT_MIRROR_H
+
+#include <string>
+#include <vector>
+#include "FrdResults.h"
+
+// Mirror plane x[axis] = position of a model solved as a half or quarter
+struct MirrorPlane {
+    int axis;         // 0 = x, 1 = y, 2 = z
+    double position;
+};
+
+// Planes listed in the .sym file written next to the INP of a reduced model;
+// no planes if the file does not exist
+int readMirrorPlanes(const std::string& filename, std::vector<MirrorPlane>& planes);
+
+// Complete a reduced model: reflect the mesh and the fields across each plane in
+// turn, sharing the nodes that lie in the plane. Vectors and tensors change sign
+// in their components across the plane; reflected cells keep a positive orientation.
+void mirrorResults(FrdResults& results, const std::vector<MirrorPlane>& planes);
+
+#endif // RESULT_MIRROR_H
@@ -0,0 +1,154 @@
+#include "SurfaceExtractor.h"
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkCellType.h>
+#include "CellFaces.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Sorted corners of a face; d is -1 for triangles
+struct FaceKey {
+    vtkIdType a, b, c, d;
+
+    bool operator==(const FaceKey& other) const {
+        return a == other.a && b == other.b && c == other.c && d == other.d;
+    }
+};
+
+struct FaceKeyHash {
+    std::size_t operator()(const FaceKey& key) const {
+        std::size_t h = static_cast<std::size_t>(key.a) * 0x9E3779B97F4A7C15ULL;
+        h ^= static_cast<std::size_t>(key.b) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= static_cast<std::size_t>(key.c) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= static_cast<std::size_t>(key.d) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+FaceKey makeKey(const vtkIdType* pts, const CellFace& face) {
+    vtkIdType v[4] = {pts[face.nodes[0]], pts[face.nodes[1]], pts[face.nodes[2]], -1};
+    if (face.corners == 4) {
+        v[3] = pts[face.nodes[3]];
+        std::sort(v, v + 4);
+    } else {
+        std::sort(v, v + 3);
+    }
+    return {v[0], v[1], v[2], v[3]};
+}
+
+} // namespace
+
+SurfaceExtractor::SurfaceExtractor()
+    : linear_faces_(false)
+{
+}
+
+SurfaceExtractor::~SurfaceExtractor() {
+}
+
+void SurfaceExtractor::setLinearFaces(bool linear) {
+    linear_faces_ = linear;
+}
+
+vtkSmartPointer<vtkPolyData> SurfaceExtractor::extract(vtkUnstructuredGrid* grid) const {
+    vtkIdType num_cells = grid->GetNumberOfCells();
+
+    // Pass 1: count how many cells share each face
+    std::unordered_map<FaceKey, int, FaceKeyHash> face_count;
+    face_count.reserve(static_cast<std::size_t>(num_cells) * 2);
+    for (vtkIdType cell = 0; cell < num_cells; ++cell) {
+        const CellFace* faces;
+        int num_faces = getCellFaces(grid->GetCellType(cell), faces);
+        if (num_faces == 0) continue;
+        vtkIdType npts;
+        const vtkIdType* pts;
+        grid->GetCellPoints(cell, npts, pts);
+        for (int f = 0; f < num_faces; ++f) {
+            ++face_count[makeKey(pts, faces[f])];
+        }
+    }
+
+    // Pass 2: emit unshared faces in cell order, compacting the referenced points
+    std::vector<vtkIdType> point_map(grid->GetNumberOfPoints(), -1);
+    std::vector<vtkIdType> kept_points;
+    auto mapPoint = [&point_map, &kept_points](vtkIdType id) {
+        if (point_map[id] < 0) {
+            point_map[id] = static_cast<vtkIdType>(kept_points.size());
+            kept_points.push_back(id);
+        }
+        return point_map[id];
+    };
+
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    for (vtkIdType cell = 0; cell < num_cells; ++cell) {
+        int cell_type = grid->GetCellType(cell);
+        const CellFace* faces;
+        int num_faces = getCellFaces(cell_type, faces);
+        if (num_faces == 0) continue;
+        vtkIdType npts;
+        const vtkIdType* pts;
+        grid->GetCellPoints(cell, npts, pts);
+        for (int f = 0; f < num_faces; ++f) {
+            const CellFace& face = faces[f];
+            if (face_count[makeKey(pts, face)] != 1) continue;
+
+            int n = face.corners;
+            vtkIdType c[4];
+            for (int k = 0; k < n; ++k) {
+                c[k] = mapPoint(pts[face.nodes[k]]);
+            }
+            if (linear_faces_ || !isQuadraticCell(cell_type)) {
+                polys->InsertNextCell(n, c);
+                continue;
+            }
+
+            // Split the quadratic face through its mid-side nodes: a triangle at each
+            // corner, and the inner triangle or quadrilateral
+            vtkIdType m[4];
+            for (int k = 0; k < n; ++k) {
+                m[k] = mapPoint(pts[face.nodes[n + k]]);
+            }
+            for (int k = 0; k < n; ++k) {
+                const vtkIdType tri[3] = {m[(k + n - 1) % n], c[k], m[k]};
+                polys->InsertNextCell(3, tri);
+            }
+            polys->InsertNextCell(n, m);
+        }
+    }
+
+    // Copy coordinates and point data of the referenced points only
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetNumberOfPoints(static_cast<vtkIdType>(kept_points.size()));
+    for (std::size_t i = 0; i < kept_points.size(); ++i) {
+        double x[3];
+        grid->GetPoints()->GetPoint(kept_points[i], x);
+        points->SetPoint(static_cast<vtkIdType>(i), x[0], x[1], x[2]);
+    }
+
+    auto surface = vtkSmartPointer<vtkPolyData>::New();
+    surface->SetPoints(points);
+    surface->SetPolys(polys);
+
+    vtkPointData* source_data = grid->GetPointData();
+    for (int a = 0; a < source_data->GetNumberOfArrays(); ++a) {
+        vtkDataArray* source = source_data->GetArray(a);
+        if (source->GetNumberOfTuples() != grid->GetNumberOfPoints()) continue;
+
+        auto target = vtkSmartPointer<vtkDataArray>::Take(source->NewInstance());
+        target->SetName(source->GetName());
+        target->SetNumberOfComponents(source->GetNumberOfComponents());
+        target->SetNumberOfTuples(static_cast<vtkIdType>(kept_points.size()));
+        for (std::size_t i = 0; i < kept_points.size(); ++i) {
+            target->SetTuple(static_cast<vtkIdType>(i), source->GetTuple(kept_points[i]));
+        }
+        surface->GetPointData()->AddArray(target);
+    }
+
+    return surface;
+}
@@ -0,0 +1,23 @@
+#ifndef SURFACE_EXTRACTOR_H
+#define SURFACE_EXTRACTOR_H
+
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkPolyData.h>
+
+class SurfaceExtractor {
+public:
+    SurfaceExtractor();
+    ~SurfaceExtractor();
+
+    // Reduce quadratic faces to their corner nodes instead of subdividing them
+    void setLinearFaces(bool linear);
+
+    // Extract the exterior faces of a volume grid, keeping only referenced points
+    vtkSmartPointer<vtkPolyData> extract(vtkUnstructuredGrid* grid) const;
+
+private:
+    bool linear_faces_;
+};
+
+#endif // SURFACE_EXTRACTOR_H
@@ -0,0 +1,85 @@
+#include "batch_converter.h"
+#include "parallel/TaskScheduler.h"
+#include <iostream>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// Convert every FRD file of a result directory:
+//   frd2vtu_batch <directory|glob> [--output dir] [--jobs n] [--io-jobs n] [--memory-mb m]
+//                 [--threads n] [--partitions n] [--recursive] [--force] [--surface]
+//                 [--no-volume] [--columnar]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <directory|glob> [--output dir] [--jobs n] [--io-jobs n]"
+                  << " [--memory-mb m] [--threads n] [--partitions n] [--recursive] [--force]"
+                  << " [--surface] [--no-volume] [--columnar]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string pattern = argv[1];
+    bool recursive = false;
+    FrdConvertOptions options;
+    BatchConverter converter;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--recursive") {
+                recursive = true;
+            } else if (option == "--force") {
+                converter.setForce(true);
+            } else if (option == "--surface") {
+                converter.setSurface(true);
+            } else if (option == "--no-volume") {
+                options.write_volume = false;
+            } else if (option == "--columnar") {
+                converter.setColumnar(true);
+            } else if (i + 1 >= argc) {
+                std::cerr << "エラー: オプションの値がありません: " << option << std::endl;
+                return EXIT_FAILURE;
+            } else if (option == "--output") {
+                converter.setOutputDirectory(argv[++i]);
+            } else if (option == "--jobs") {
+                converter.setJobs(std::stoi(argv[++i]));
+            } else if (option == "--io-jobs") {
+                converter.setIoJobs(std::stoi(argv[++i]));
+            } else if (option == "--memory-mb") {
+                converter.setMemoryLimit(std::stod(argv[++i]));
+            } else if (option == "--partitions") {
+                options.partitions = std::stoi(argv[++i]);
+            } else if (option == "--threads") {
+                SchedulerOptions scheduler;
+                // std::stoul would wrap "-1" to the largest unsigned value
+                long threads = std::stol(argv[++i]);
+                if (threads <= 0 || threads > 4096) {
+                    throw std::invalid_argument(option + " " + argv[i]);
+                }
+                scheduler.threads = static_cast<unsigned>(threads);
+                TaskScheduler::instance().configure(scheduler);
+            } else {
+                std::cerr << "エラー: 不明なオプションです: " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "エラー: オプションの値が不正です: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    converter.setOptions(options);
+
+    std::vector<std::string> frd_files;
+    if (BatchConverter::collectInputs(pattern, recursive, frd_files) != 0) {
+        return EXIT_FAILURE;
+    }
+    std::error_code error;
+    if (std::filesystem::is_directory(pattern, error)) {
+        converter.setInputRoot(pattern);
+    }
+    if (frd_files.empty()) {
+        std::cerr << "エラー: FRDファイルが見つかりません: " << pattern << std::endl;
+        return EXIT_FAILURE;
+    }
+    return converter.run(frd_files) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,159 @@
+#include "Logger.h"
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    static const struct {
+        const char* name;
+        LogLevel level;
+    } kLevels[] = {
+        {"trace", LogLevel::Trace}, {"debug", LogLevel::Debug}, {"info", LogLevel::Info},
+        {"warning", LogLevel::Warning}, {"error", LogLevel::Error}, {"off", LogLevel::Off},
+    };
+    for (const auto& entry : kLevels) {
+        if (name == entry.name) {
+            level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : slots_(new Slot[kCapacity])
+    , enqueue_position_(0)
+    , dequeue_position_(0)
+    , written_(0)
+    , level_(static_cast<int>(LogLevel::Info))
+    , sleeping_(false)
+    , stopping_(false)
+{
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    drain_thread_ = std::thread(&Logger::drainLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    drain_thread_.join();
+}
+
+void Logger::setLevel(LogLevel level) {
+    level_.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel() const {
+    return static_cast<LogLevel>(level_.load(std::memory_order_relaxed));
+}
+
+bool Logger::isEnabled(LogLevel level) const {
+    return static_cast<int>(level) >= level_.load(std::memory_order_relaxed) && level != LogLevel::Off;
+}
+
+void Logger::write(LogLevel level, std::string message) {
+    // A full buffer only happens in bursts faster than the console; wait for room
+    // rather than drop the message
+    while (!tryPush(level, message)) {
+        wake_.notify_one();
+        std::this_thread::yield();
+    }
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        wake_.notify_one();
+    }
+    if (level >= LogLevel::Warning) {
+        flush();
+    }
+}
+
+void Logger::flush() {
+    std::size_t target = enqueue_position_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.notify_one();
+    drained_.wait(lock, [&] { return written_.load(std::memory_order_acquire) >= target; });
+}
+
+bool Logger::tryPush(LogLevel level, std::string& message) {
+    std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[position & (kCapacity - 1)];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+        if (difference == 0) {
+            if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->level = level;
+    slot->message = std::move(message);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool Logger::tryPop(LogLevel& level, std::string& message) {
+    // The drain thread is the only consumer
+    std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[position & (kCapacity - 1)];
+    std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1) < 0) {
+        return false;
+    }
+    dequeue_position_.store(position + 1, std::memory_order_relaxed);
+    level = slot.level;
+    message = std::move(slot.message);
+    slot.sequence.store(position + kCapacity, std::memory_order_release);
+    return true;
+}
+
+void Logger::drainLoop() {
+    std::string text;
+    LogLevel level;
+    std::string message;
+    for (;;) {
+        // Consecutive lines of one stream are written together, with one flush per batch
+        std::size_t count = 0;
+        bool to_stderr = false;
+        auto emit = [&]() {
+            if (text.empty()) return;
+            std::ostream& stream = to_stderr ? std::cerr : std::cout;
+            stream << text << std::flush;
+            text.clear();
+        };
+        while (count < 1024 && tryPop(level, message)) {
+            bool is_error = level >= LogLevel::Warning;
+            if (is_error != to_stderr) {
+                emit();
+                to_stderr = is_error;
+            }
+            text += message;
+            text += '\n';
+            ++count;
+        }
+        emit();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (count > 0) {
+            written_.fetch_add(count, std::memory_order_release);
+            drained_.notify_all();
+            continue;
+        }
+        if (stopping_) break;
+        sleeping_.store(true, std::memory_order_relaxed);
+        wake_.wait_for(lock, std::chrono::milliseconds(20));
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+enum class LogLevel {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4,
+    Off = 5
+};
+
+// Level named "trace", "debug", "info", "warning", "error" or "off"; false if unknown
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+// Calls below this level are removed at compile time; trace calls are
+// compiled in only with -DSTRECS_LOG_MIN_LEVEL=0
+#ifndef STRECS_LOG_MIN_LEVEL
+#define STRECS_LOG_MIN_LEVEL 1
+#endif
+
+// Process-wide asynchronous logger. Messages go into a bounded lock-free ring
+// buffer and a background thread writes them in batches, so a logging thread
+// never waits for the console: info and below go to stdout, warnings and
+// errors to stderr. Warnings and errors are flushed before the call returns,
+// so they are never lost or overtaken by direct output that follows.
+class Logger {
+public:
+    static Logger& instance();
+
+    // Messages below this level are dropped before they are formatted
+    void setLevel(LogLevel level);
+    LogLevel getLevel() const;
+    bool isEnabled(LogLevel level) const;
+
+    void write(LogLevel level, std::string message);
+
+    // Wait until every queued message has been written; call before direct
+    // output that must come after the logged lines and before fork()
+    void flush();
+
+private:
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Slot of the ring buffer; sequence tells producers and the consumer whose turn it is
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        LogLevel level;
+        std::string message;
+    };
+
+    bool tryPush(LogLevel level, std::string& message);
+    bool tryPop(LogLevel& level, std::string& message);
+    void drainLoop();
+
+    static const std::size_t kCapacity = 8192;  // Power of two
+
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<std::size_t> enqueue_position_;
+    std::atomic<std::size_t> dequeue_position_;
+    std::atomic<std::size_t> written_;           // Messages written so far
+    std::atomic<int> level_;
+    std::atomic<bool> sleeping_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    bool stopping_;
+    std::thread drain_thread_;
+};
+
+#define STRECS_LOG(level, expression)                                   \
+    do {                                                                \
+        if (Logger::instance().isEnabled(level)) {                      \
+            std::ostringstream strecs_log_stream_;                      \
+            strecs_log_stream_ << expression;                           \
+            Logger::instance().write(level, strecs_log_stream_.str());  \
+        }                                                               \
+    } while (0)
+
+#if STRECS_LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(expression) STRECS_LOG(LogLevel::Trace, expression)
+#else
+#define LOG_TRACE(expression) do {} while (0)
+#endif
+#if STRECS_LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(expression) STRECS_LOG(LogLevel::Debug, expression)
+#else
+#define LOG_DEBUG(expression) do {} while (0)
+#endif
+#define LOG_INFO(expression) STRECS_LOG(LogLevel::Info, expression)
+#define LOG_WARNING(expression) STRECS_LOG(LogLevel::Warning, expression)
+#define LOG_ERROR(expression) STRECS_LOG(LogLevel::Error, expression)
+
+#endif // LOGGER_H
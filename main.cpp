@@ -1,19 +1,220 @@
 #include "frd2vtu.h"
 #include "step2inp.h"
 #include "simulation_config.h"
+#include "analysis_pipeline.h"
+#include "analysis_daemon.h"
+#include "frd2vtu/FrdQuery.h"
+#include "parallel/TaskScheduler.h"
+#include "logging/Logger.h"
 #include <iostream>
 #include <cstdlib>
 #include <filesystem>
+#include <map>
+#include <vector>
+#include <stdexcept>
+
+namespace {
+
+// Upper bound of a thread count option; far beyond any machine it runs on
+const long kMaxThreads = 4096;
+
+// Value of a count option: a whole number in [1, limit]. std::stoul would take
+// "-1" as the largest unsigned value, so parse signed and check the range.
+long parseCount(const std::string& option, const std::string& value, long limit) {
+    std::size_t used = 0;
+    long count = std::stol(value, &used);
+    if (used != value.size() || count <= 0 || count > limit) {
+        throw std::invalid_argument(option + " " + value);
+    }
+    return count;
+}
+
+} // namespace
+
+// Answer result queries directly from an FRD file:
+//   strecsfem query <frd_file> [--config file] [--inp file] [--top k] [--step n] [--threads n]
+int runQuery(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " query <frd_file> [--config file] [--inp file]"
+                  << " [--top k] [--step n] [--threads n]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string frd_file = argv[2];
+    std::string config_file;
+    std::string inp_file = (std::filesystem::path(frd_file).parent_path() /
+                            std::filesystem::path(frd_file).stem()).string() + ".inp";
+    FrdQuery query;
+    try {
+        for (int i = 3; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option != "--config" && option != "--inp" && option != "--top" &&
+                option != "--step" && option != "--threads") {
+                std::cerr << "エラー: 不明なオプションです: " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "エラー: オプションの値がありません: " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::string value = argv[++i];
+            if (option == "--config") {
+                config_file = value;
+            } else if (option == "--inp") {
+                inp_file = value;
+            } else if (option == "--top") {
+                query.setTopK(parseCount(option, value, 1000000));
+            } else if (option == "--step") {
+                query.setStep(std::stoi(value));
+            } else {
+                SchedulerOptions scheduler;
+                scheduler.threads = parseCount(option, value, kMaxThreads);
+                TaskScheduler::instance().configure(scheduler);
+                query.setThreads(scheduler.threads);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "エラー: オプションの値が不正です: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Per-surface reductions over the load and constraint faces of the config
+    struct QuerySurface {
+        int surface_id;
+        std::string name;
+        std::string role;
+    };
+    std::vector<QuerySurface> surfaces;
+    if (!config_file.empty()) {
+        try {
+            SimulationConfig config = SimulationConfig::fromJsonFile(config_file);
+            if (resolveConfigFaces(config) != 0) {
+                return EXIT_FAILURE;
+            }
+            for (const auto& fixed_face : config.constraints.fixed_faces) {
+                surfaces.push_back({fixed_face.surface_id, fixed_face.name, "constraint"});
+            }
+            for (const auto& load : config.loads.applied_loads) {
+                surfaces.push_back({load.surface_id, load.name, "load"});
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "エラー: 設定ファイルの読み込みに失敗しました: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::vector<std::string> set_names;
+        for (const auto& surface : surfaces) {
+            set_names.push_back("Surface" + std::to_string(surface.surface_id));
+        }
+        std::map<std::string, std::vector<int>> node_sets;
+        if (FrdQuery::readNodeSets(inp_file, set_names, node_sets) != 0) {
+            return EXIT_FAILURE;
+        }
+        for (const auto& set_name : set_names) {
+            query.addNodeSet(set_name, node_sets[set_name]);
+        }
+    }
+
+    FrdQueryResult result;
+    if (query.run(frd_file, result) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    nlohmann::json report;
+    report["frd_file"] = frd_file;
+    report["step"] = result.step;
+    if (result.has_stress) {
+        report["max_von_mises"] = {{"node", result.max_von_mises.node}, {"value", result.max_von_mises.value}};
+        report["hotspots"] = nlohmann::json::array();
+        for (const auto& hotspot : result.hotspots) {
+            report["hotspots"].push_back({{"node", hotspot.node}, {"value", hotspot.value}});
+        }
+    }
+    if (result.has_displacement) {
+        report["max_displacement"] = {{"node", result.max_displacement.node}, {"value", result.max_displacement.value}};
+    }
+    report["surfaces"] = nlohmann::json::array();
+    for (std::size_t i = 0; i < surfaces.size(); ++i) {
+        const SurfaceSummary& summary = result.surfaces[i];
+        report["surfaces"].push_back({
+            {"surface_id", surfaces[i].surface_id},
+            {"name", surfaces[i].name},
+            {"role", surfaces[i].role},
+            {"nodes", summary.nodes},
+            {"mean_von_mises", summary.mean_von_mises},
+            {"max_von_mises", summary.max_von_mises},
+            {"mean_displacement", summary.mean_displacement},
+            {"max_displacement", summary.max_displacement}
+        });
+    }
+    std::cout << report.dump(2) << std::endl;
+    return EXIT_SUCCESS;
+}
+
+// Serve analysis jobs on a Unix domain socket, keeping gmsh models warm:
+//   strecsfem daemon <socket_path> [--cache n] [--threads n]
+int runDaemon(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " daemon <socket_path> [--cache n] [--threads n]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    AnalysisDaemon daemon;
+    try {
+        for (int i = 3; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option != "--cache" && option != "--threads") {
+                std::cerr << "エラー: 不明なオプションです: " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "エラー: オプションの値がありません: " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::string value = argv[++i];
+            if (option == "--cache") {
+                daemon.setCacheCapacity(parseCount(option, value, 1024));
+            } else {
+                SchedulerOptions scheduler;
+                scheduler.threads = parseCount(option, value, kMaxThreads);
+                TaskScheduler::instance().configure(scheduler);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "エラー: オプションの値が不正です: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return daemon.run(argv[2]) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
 int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::string(argv[1]) == "query") {
+        return runQuery(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "daemon") {
+        return runDaemon(argc, argv);
+    }
+
     std::string config_file = "resources/simulation_config.json";
-    
+    bool plan_only = false;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--plan") {
+            plan_only = true;
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+
     // Allow config file to be specified as command line argument
-    if (argc == 2) {
-        config_file = argv[1];
-    } else if (argc > 2) {
-        std::cerr << "Usage: " << argv[0] << " [config_file]" << std::endl;
+    if (arguments.size() == 1) {
+        config_file = arguments[0];
+    } else if (arguments.size() > 1) {
+        std::cerr << "Usage: " << argv[0] << " [config_file] [--plan]" << std::endl;
+        std::cerr << "       " << argv[0] << " query <frd_file> [options]" << std::endl;
+        std::cerr << "       " << argv[0] << " daemon <socket_path> [--cache n] [--threads n]" << std::endl;
         std::cerr << "If no config file is specified, uses resources/simulation_config.json" << std::endl;
+        std::cerr << "--plan only estimates the solver resources of the mesh, without solving" << std::endl;
         return EXIT_FAILURE;
     }
     
@@ -22,73 +223,28 @@ int main(int argc, char* argv[]) {
     try {
         config = SimulationConfig::fromJsonFile(config_file);
         std::cout << "Loaded configuration from: " << config_file << std::endl;
+        if (plan_only) {
+            config.resources.plan_only = true;
+        }
     } catch (const std::exception& e) {
         std::cerr << "エラー: 設定ファイルの読み込みに失敗しました: " << e.what() << std::endl;
         return EXIT_FAILURE;
     }
-    
-    std::string step_file = config.step_file;
-    
-    // Create constraint conditions from config
-    std::vector<ConstraintCondition> constraints;
-    for (const auto& fixed_face : config.constraints.fixed_faces) {
-        constraints.push_back(createConstraintCondition(fixed_face.surface_id));
-    }
-    
-    // Create load conditions from config
-    std::vector<LoadCondition> loads;
-    for (const auto& load : config.loads.applied_loads) {
-        std::vector<double> direction = {load.direction.x, load.direction.y, load.direction.z};
-        loads.push_back(createLoadCondition(load.surface_id, load.magnitude, direction));
-    }
-    
-    if (constraints.empty() && loads.empty()) {
-        std::cerr << "エラー: 設定ファイルに境界条件が指定されていません。" << std::endl;
-        return EXIT_FAILURE;
-    }
 
-    // Step 1: Convert STEP to INP
-    std::cout << "Step 1: Converting STEP to INP..." << std::endl;
-    int result = convertStepToInp(step_file, constraints, loads);
-    if (result != 0) {
-        std::cerr << "エラー: STEP to INP conversion failed" << std::endl;
-        return result;
-    }
-    
-    // Get base filename for subsequent operations
-    std::filesystem::path path(step_file);
-    std::string base_name = path.stem().string();
-    std::string inp_file = base_name + ".inp";
-    std::string frd_file = base_name + ".frd";
-    std::string vtu_file = base_name + ".vtu";
-    
-    // Step 2: Run CalculiX analysis
-    std::cout << "Step 2: Running CalculiX analysis..." << std::endl;
-    std::string ccx_command = "ccx_2.22 " + base_name;
-    result = std::system(ccx_command.c_str());
-    if (result != 0) {
-        std::cerr << "エラー: CalculiX analysis failed" << std::endl;
-        return result;
-    }
-    
-    // Check if FRD file was generated
-    if (!std::filesystem::exists(frd_file)) {
-        std::cerr << "エラー: FRD file was not generated: " << frd_file << std::endl;
+    // One scheduler shared by every stage of the pipeline
+    SchedulerOptions scheduler;
+    scheduler.threads = config.parallel.threads;
+    scheduler.pin_threads = config.parallel.pin_threads;
+    scheduler.numa_node = config.parallel.numa_node;
+    TaskScheduler::instance().configure(scheduler);
+
+    LogLevel log_level;
+    if (!parseLogLevel(config.logging.level, log_level)) {
+        std::cerr << "エラー: 不明なログレベルです: " << config.logging.level << std::endl;
         return EXIT_FAILURE;
     }
-    
-    // Step 3: Convert FRD to VTU
-    std::cout << "Step 3: Converting FRD to VTU..." << std::endl;
-    result = convertFrdToVtu(frd_file, vtu_file);
-    if (result == EXIT_SUCCESS) {
-        std::cout << "Analysis pipeline completed successfully!" << std::endl;
-        std::cout << "Generated files:" << std::endl;
-        std::cout << "  - INP file: " << inp_file << std::endl;
-        std::cout << "  - FRD file: " << frd_file << std::endl;
-        std::cout << "  - VTU file: " << vtu_file << std::endl;
-    } else {
-        std::cerr << "エラー: FRD to VTU conversion failed" << std::endl;
-    }
-
-    return result;
-}
\ No newline at end of file
+    Logger::instance().setLevel(log_level);
+
+    std::map<std::string, std::string> outputs;
+    return runAnalysisPipeline(config, PipelineProgress(), outputs);
+}
@@ -0,0 +1,273 @@
+#include "TaskScheduler.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+
+// Index of the calling worker's own queue; -1 on threads outside the pool
+thread_local int t_worker_index = -1;
+
+// CPUs this process may run on
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// CPUs of a NUMA node from sysfs ("0-3,8-11")
+std::vector<int> nodeCpus(int node) {
+    std::vector<int> cpus;
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!std::getline(file, list)) return cpus;
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        std::size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+void bindThread(std::thread& thread, const std::vector<int>& cpus) {
+    if (cpus.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+}
+
+} // namespace
+
+TaskScheduler& TaskScheduler::instance() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler()
+    : thread_count_(1)
+    , queued_(0)
+    , next_victim_(0)
+    , stopping_(false)
+{
+    start();
+}
+
+TaskScheduler::~TaskScheduler() {
+    stop();
+}
+
+void TaskScheduler::configure(const SchedulerOptions& options) {
+    stop();
+    options_ = options;
+    start();
+}
+
+unsigned TaskScheduler::getThreadCount() const {
+    return thread_count_;
+}
+
+void TaskScheduler::start() {
+    std::vector<int> cpus = allowedCpus();
+    if (options_.numa_node >= 0) {
+        std::vector<int> node = nodeCpus(options_.numa_node);
+        std::vector<int> both;
+        for (int cpu : cpus) {
+            if (std::find(node.begin(), node.end(), cpu) != node.end()) both.push_back(cpu);
+        }
+        if (both.empty()) {
+            std::cerr << "警告: NUMAノード " << options_.numa_node << " のCPUを使用できません" << std::endl;
+        } else {
+            cpus = both;
+        }
+    }
+
+    thread_count_ = options_.threads > 0 ? options_.threads
+                                         : std::max<unsigned>(1, static_cast<unsigned>(cpus.size()));
+    unsigned workers = thread_count_ - 1;  // The waiting thread works too
+    queues_.clear();
+    for (unsigned i = 0; i <= workers; ++i) {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    stopping_ = false;
+    bool restrict = options_.pin_threads || options_.numa_node >= 0;
+    for (unsigned i = 0; i < workers; ++i) {
+        std::vector<int> worker_cpus;
+        if (options_.pin_threads && !cpus.empty()) {
+            worker_cpus = {cpus[(i + 1) % cpus.size()]};  // The first CPU is left to the caller
+        } else if (restrict) {
+            worker_cpus = cpus;
+        }
+        workers_.emplace_back(&TaskScheduler::workerLoop, this, i);
+        bindThread(workers_.back(), worker_cpus);
+    }
+}
+
+void TaskScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void TaskScheduler::spawn(std::function<void()> task) {
+    // Workers keep their own tasks local; other threads use the injection queue
+    std::size_t index = t_worker_index >= 0 ? static_cast<std::size_t>(t_worker_index) : queues_.size() - 1;
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    queued_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+bool TaskScheduler::popTask(std::function<void()>& task) {
+    if (queued_.load() == 0) return false;
+
+    // Own queue from the back (most recent, still in cache), then steal from the front
+    if (t_worker_index >= 0) {
+        TaskQueue& own = *queues_[t_worker_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+    std::size_t count = queues_.size();
+    std::size_t first = next_victim_.fetch_add(1) % count;
+    for (std::size_t i = 0; i < count; ++i) {
+        TaskQueue& victim = *queues_[(first + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::runPendingTask() {
+    std::function<void()> task;
+    if (!popTask(task)) return false;
+    task();
+    return true;
+}
+
+void TaskScheduler::workerLoop(unsigned index) {
+    t_worker_index = static_cast<int>(index);
+    while (true) {
+        if (runPendingTask()) continue;
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this]() { return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0) break;
+    }
+    t_worker_index = -1;
+}
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : scheduler_(scheduler)
+    , remaining_(0)
+{
+}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // Errors surface through an explicit wait()
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    remaining_.fetch_add(1);
+    scheduler_.spawn([this, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        finish();
+    });
+}
+
+void TaskGroup::finish() {
+    // Under the lock: wait() must not return, and the group go away, before we are done with it
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (remaining_.fetch_sub(1) == 1) {
+        done_.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    while (remaining_.load() > 0) {
+        if (scheduler_.runPendingTask()) continue;
+        // Our tasks run elsewhere; sleep briefly so new tasks are still picked up
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return remaining_.load() == 0; });
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(error, error_);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+TaskGraph::NodeId TaskGraph::add(std::function<void()> task, const std::vector<NodeId>& dependencies) {
+    NodeId id = nodes_.size();
+    nodes_.push_back(Node());
+    nodes_.back().task = std::move(task);
+    nodes_.back().dependencies = dependencies.size();
+    for (NodeId dependency : dependencies) {
+        nodes_[dependency].successors.push_back(id);
+    }
+    return id;
+}
+
+void TaskGraph::run(TaskScheduler& scheduler) {
+    std::unique_ptr<std::atomic<std::size_t>[]> waiting(new std::atomic<std::size_t>[nodes_.size()]);
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+        waiting[i].store(nodes_[i].dependencies);
+    }
+
+    // A finished node releases the successors whose last dependency it was
+    TaskGroup group(scheduler);
+    std::function<void(NodeId)> launch = [&](NodeId id) {
+        group.run([&, id]() {
+            nodes_[id].task();
+            for (NodeId successor : nodes_[id].successors) {
+                if (waiting[successor].fetch_sub(1) == 1) launch(successor);
+            }
+        });
+    };
+    for (NodeId id = 0; id < nodes_.size(); ++id) {
+        if (nodes_[id].dependencies == 0) launch(id);
+    }
+    group.wait();
+}
@@ -0,0 +1,136 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SchedulerOptions {
+    unsigned threads = 0;       // Total threads including the caller; 0 uses every CPU we may run on
+    bool pin_threads = false;   // Bind each worker to a single CPU
+    int numa_node = -1;         // Keep the workers on the CPUs of this NUMA node; -1 for any
+};
+
+// Process-wide work-stealing scheduler. Each worker owns a deque: it pushes and
+// pops its own tasks at the back and steals from the front of the others, so
+// nested parallel loops spread without oversubscribing the machine. Threads
+// that wait for tasks run queued tasks meanwhile instead of blocking.
+class TaskScheduler {
+public:
+    static TaskScheduler& instance();
+
+    // Restart the workers with new options; must not be called while tasks run
+    void configure(const SchedulerOptions& options);
+
+    // Threads that execute tasks, counting the one waiting for them
+    unsigned getThreadCount() const;
+
+    // Run body(first, last) over subranges of [begin, end) no smaller than grain
+    template <class Body>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Body&& body);
+
+    // Queue a task; prefer TaskGroup, which tracks completion
+    void spawn(std::function<void()> task);
+
+    // Run one queued task on the calling thread; false if none was found
+    bool runPendingTask();
+
+private:
+    TaskScheduler();
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void start();
+    void stop();
+    void workerLoop(unsigned index);
+    bool popTask(std::function<void()>& task);
+
+    SchedulerOptions options_;
+    unsigned thread_count_;
+    std::vector<std::unique_ptr<TaskQueue>> queues_;  // One per worker, then the injection queue
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> queued_;
+    std::atomic<unsigned> next_victim_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+};
+
+// Tasks whose completion is awaited together
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance());
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+
+    // Wait for every task, running queued ones meanwhile; rethrows the first exception
+    void wait();
+
+private:
+    void finish();
+
+    TaskScheduler& scheduler_;
+    std::atomic<std::size_t> remaining_;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+};
+
+// Tasks with dependencies; each runs once all of its dependencies have finished
+class TaskGraph {
+public:
+    using NodeId = std::size_t;
+
+    NodeId add(std::function<void()> task, const std::vector<NodeId>& dependencies = {});
+
+    // Run the whole graph and wait for it; rethrows the first exception
+    void run(TaskScheduler& scheduler = TaskScheduler::instance());
+
+private:
+    struct Node {
+        std::function<void()> task;
+        std::vector<NodeId> successors;
+        std::size_t dependencies = 0;
+    };
+
+    std::vector<Node> nodes_;
+};
+
+template <class Body>
+void TaskScheduler::parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Body&& body) {
+    if (begin >= end) return;
+    std::size_t count = end - begin;
+    grain = std::max<std::size_t>(grain, 1);
+
+    // A few chunks per thread, so that stealing can even out uneven chunks
+    std::size_t chunks = std::min((count + grain - 1) / grain, static_cast<std::size_t>(4) * getThreadCount());
+    if (chunks <= 1 || getThreadCount() == 1) {
+        body(begin, end);
+        return;
+    }
+    std::size_t step = (count + chunks - 1) / chunks;
+    TaskGroup group(*this);
+    for (std::size_t first = begin + step; first < end; first += step) {
+        std::size_t last = std::min(end, first + step);
+        group.run([&body, first, last]() { body(first, last); });
+    }
+    body(begin, begin + step);
+    group.wait();
+}
+
+#endif // TASK_SCHEDULER_H
@@ -21,6 +21,296 @@ SimulationConfig SimulationConfig::fromJson(const nlohmann::json& json) {
     json.at("mesh").get_to(config.mesh);
     json.at("constraints").get_to(config.constraints);
     json.at("loads").get_to(config.loads);
+    if (json.contains("output")) {
+        json.at("output").get_to(config.output);
+    }
+    if (json.contains("superposition")) {
+        json.at("superposition").get_to(config.superposition);
+    }
+    if (json.contains("materials")) {
+        json.at("materials").get_to(config.materials);
+    }
+    if (json.contains("solver")) {
+        json.at("solver").get_to(config.solver);
+    }
+    if (json.contains("resources")) {
+        json.at("resources").get_to(config.resources);
+    }
+    if (json.contains("parallel")) {
+        json.at("parallel").get_to(config.parallel);
+    }
+    if (json.contains("logging")) {
+        json.at("logging").get_to(config.logging);
+    }
     
     return config;
-}
\ No newline at end of file
+}
+
+void to_json(nlohmann::json& json, const FaceSelectConfig& select) {
+    json = nlohmann::json::object();
+    if (!select.point.empty()) json["point"] = select.point;
+    if (!select.box.empty()) json["box"] = select.box;
+    if (!select.normal.empty()) json["normal"] = select.normal;
+    if (!select.plane_point.empty()) {
+        json["plane"] = {{"point", select.plane_point}, {"normal", select.plane_normal}};
+    }
+    json["tolerance"] = select.tolerance;
+    json["angle_tolerance"] = select.angle_tolerance;
+}
+
+void from_json(const nlohmann::json& json, FaceSelectConfig& select) {
+    select.point = json.value("point", std::vector<double>());
+    select.box = json.value("box", std::vector<double>());
+    select.normal = json.value("normal", std::vector<double>());
+    select.plane_point.clear();
+    select.plane_normal.clear();
+    if (json.contains("plane")) {
+        json.at("plane").at("point").get_to(select.plane_point);
+        json.at("plane").at("normal").get_to(select.plane_normal);
+    }
+    select.tolerance = json.value("tolerance", 1e-6);
+    select.angle_tolerance = json.value("angle_tolerance", 1.0);
+}
+
+void to_json(nlohmann::json& json, const FixedFace& fixed_face) {
+    json = nlohmann::json{
+        {"surface_id", fixed_face.surface_id},
+        {"name", fixed_face.name}
+    };
+    if (!fixed_face.select.empty()) {
+        json["select"] = fixed_face.select;
+    }
+}
+
+void from_json(const nlohmann::json& json, FixedFace& fixed_face) {
+    fixed_face.surface_id = json.value("surface_id", 0);
+    json.at("name").get_to(fixed_face.name);
+    fixed_face.select = FaceSelectConfig();
+    if (json.contains("select")) {
+        json.at("select").get_to(fixed_face.select);
+    }
+}
+
+void to_json(nlohmann::json& json, const AppliedLoad& load) {
+    json = nlohmann::json{
+        {"surface_id", load.surface_id},
+        {"name", load.name},
+        {"magnitude", load.magnitude},
+        {"direction", load.direction},
+        {"distribution", load.distribution}
+    };
+    if (!load.select.empty()) {
+        json["select"] = load.select;
+    }
+}
+
+void from_json(const nlohmann::json& json, AppliedLoad& load) {
+    load.surface_id = json.value("surface_id", 0);
+    json.at("name").get_to(load.name);
+    json.at("magnitude").get_to(load.magnitude);
+    json.at("direction").get_to(load.direction);
+    load.distribution = json.value("distribution", std::string("nodal"));
+    load.select = FaceSelectConfig();
+    if (json.contains("select")) {
+        json.at("select").get_to(load.select);
+    }
+}
+
+void to_json(nlohmann::json& json, const RefinementConfig& refinement) {
+    json = nlohmann::json{
+        {"enabled", refinement.enabled},
+        {"size", refinement.size},
+        {"distance_min", refinement.distance_min},
+        {"distance_max", refinement.distance_max},
+        {"constraints", refinement.constraints},
+        {"loads", refinement.loads},
+        {"surfaces", refinement.surfaces},
+        {"curvature_points", refinement.curvature_points}
+    };
+}
+
+void from_json(const nlohmann::json& json, RefinementConfig& refinement) {
+    // Giving the section enables it unless it says otherwise
+    refinement.enabled = json.value("enabled", true);
+    refinement.size = json.value("size", 0.0);
+    refinement.distance_min = json.value("distance_min", 0.0);
+    refinement.distance_max = json.value("distance_max", 0.0);
+    refinement.constraints = json.value("constraints", true);
+    refinement.loads = json.value("loads", true);
+    refinement.surfaces = json.value("surfaces", std::vector<int>());
+    refinement.curvature_points = json.value("curvature_points", 0);
+}
+
+void to_json(nlohmann::json& json, const ShellConfig& shell) {
+    json = nlohmann::json{
+        {"enabled", shell.enabled},
+        {"surfaces", shell.surfaces},
+        {"thickness", shell.thickness},
+        {"quads", shell.quads}
+    };
+}
+
+void from_json(const nlohmann::json& json, ShellConfig& shell) {
+    // Giving the section enables it unless it says otherwise
+    shell.enabled = json.value("enabled", true);
+    shell.surfaces = json.value("surfaces", std::vector<int>());
+    shell.thickness = json.value("thickness", 0.0);
+    shell.quads = json.value("quads", false);
+}
+
+void to_json(nlohmann::json& json, const SymmetryConfig& symmetry) {
+    json = nlohmann::json{
+        {"enabled", symmetry.enabled},
+        {"max_planes", symmetry.max_planes},
+        {"tolerance", symmetry.tolerance}
+    };
+}
+
+void from_json(const nlohmann::json& json, SymmetryConfig& symmetry) {
+    // Giving the section enables it unless it says otherwise
+    symmetry.enabled = json.value("enabled", true);
+    symmetry.max_planes = json.value("max_planes", 2);
+    symmetry.tolerance = json.value("tolerance", 1e-4);
+}
+
+void to_json(nlohmann::json& json, const MeshConfig& mesh) {
+    json = nlohmann::json{
+        {"min_element_size", mesh.min_element_size},
+        {"max_element_size", mesh.max_element_size},
+        {"renumbering", mesh.renumbering},
+        {"workers", mesh.workers},
+        {"order", mesh.order},
+        {"refinement", mesh.refinement},
+        {"shell", mesh.shell},
+        {"symmetry", mesh.symmetry}
+    };
+}
+
+void from_json(const nlohmann::json& json, MeshConfig& mesh) {
+    json.at("min_element_size").get_to(mesh.min_element_size);
+    json.at("max_element_size").get_to(mesh.max_element_size);
+    if (!(mesh.min_element_size > 0.0) || !(mesh.max_element_size > 0.0)) {
+        throw std::runtime_error("mesh.min_element_size and mesh.max_element_size must be positive");
+    }
+    mesh.renumbering = json.value("renumbering", std::string("none"));
+    mesh.workers = json.value("workers", 0);
+    mesh.order = json.value("order", 2);
+    mesh.refinement = json.value("refinement", RefinementConfig());
+    mesh.shell = json.value("shell", ShellConfig());
+    mesh.symmetry = json.value("symmetry", SymmetryConfig());
+}
+
+void to_json(nlohmann::json& json, const FieldPrecisionConfig& precision) {
+    json = nlohmann::json{
+        {"type", precision.type},
+        {"tolerance", precision.tolerance},
+        {"relative", precision.relative}
+    };
+}
+
+void from_json(const nlohmann::json& json, FieldPrecisionConfig& precision) {
+    // Either a bare type name or an object with type/tolerance/relative
+    if (json.is_string()) {
+        precision = FieldPrecisionConfig();
+        json.get_to(precision.type);
+        return;
+    }
+    precision.type = json.value("type", std::string("float64"));
+    precision.tolerance = json.value("tolerance", 0.0);
+    precision.relative = json.value("relative", false);
+}
+
+void to_json(nlohmann::json& json, const OutputConfig& output) {
+    json = nlohmann::json{
+        {"volume", output.volume},
+        {"surface", output.surface},
+        {"linear_surface", output.linear_surface},
+        {"columnar", output.columnar},
+        {"partitions", output.partitions},
+        {"fields", output.fields},
+        {"step", output.step},
+        {"precision", output.precision}
+    };
+}
+
+void from_json(const nlohmann::json& json, OutputConfig& output) {
+    output.volume = json.value("volume", true);
+    output.surface = json.value("surface", false);
+    output.linear_surface = json.value("linear_surface", false);
+    output.columnar = json.value("columnar", false);
+    output.partitions = json.value("partitions", 1);
+    output.fields = json.value("fields", std::vector<std::string>());
+    output.step = json.value("step", 0);
+    output.precision.clear();
+    if (json.contains("precision")) {
+        const auto& precision = json.at("precision");
+        for (auto it = precision.begin(); it != precision.end(); ++it) {
+            it.value().get_to(output.precision[it.key()]);
+        }
+    }
+}
+void to_json(nlohmann::json& json, const SuperpositionConfig& superposition) {
+    json = nlohmann::json{
+        {"enabled", superposition.enabled}
+    };
+}
+
+void from_json(const nlohmann::json& json, SuperpositionConfig& superposition) {
+    superposition.enabled = json.value("enabled", false);
+}
+
+void to_json(nlohmann::json& json, const SolverConfig& solver) {
+    json = nlohmann::json{
+        {"command", solver.command},
+        {"cache_directory", solver.cache_directory},
+        {"cache_size_mb", solver.cache_size_mb},
+        {"timeout_seconds", solver.timeout_seconds},
+        {"memory_limit_mb", solver.memory_limit_mb}
+    };
+}
+
+void from_json(const nlohmann::json& json, SolverConfig& solver) {
+    solver.command = json.value("command", std::string("ccx_2.22"));
+    solver.cache_directory = json.value("cache_directory", std::string());
+    solver.cache_size_mb = json.value("cache_size_mb", 1024.0);
+    solver.timeout_seconds = json.value("timeout_seconds", 0.0);
+    solver.memory_limit_mb = json.value("memory_limit_mb", 0.0);
+}
+
+void to_json(nlohmann::json& json, const ResourceConfig& resources) {
+    json = nlohmann::json{
+        {"memory_mb", resources.memory_mb},
+        {"time_seconds", resources.time_seconds},
+        {"plan_only", resources.plan_only}
+    };
+}
+
+void from_json(const nlohmann::json& json, ResourceConfig& resources) {
+    resources.memory_mb = json.value("memory_mb", 0.0);
+    resources.time_seconds = json.value("time_seconds", 0.0);
+    resources.plan_only = json.value("plan_only", false);
+}
+
+void to_json(nlohmann::json& json, const ParallelConfig& parallel) {
+    json = nlohmann::json{
+        {"threads", parallel.threads},
+        {"pin_threads", parallel.pin_threads},
+        {"numa_node", parallel.numa_node}
+    };
+}
+
+void from_json(const nlohmann::json& json, ParallelConfig& parallel) {
+    parallel.threads = json.value("threads", 0u);
+    parallel.pin_threads = json.value("pin_threads", false);
+    parallel.numa_node = json.value("numa_node", -1);
+}
+
+void to_json(nlohmann::json& json, const LoggingConfig& logging) {
+    json = nlohmann::json{
+        {"level", logging.level}
+    };
+}
+
+void from_json(const nlohmann::json& json, LoggingConfig& logging) {
+    logging.level = json.value("level", std::string("info"));
+}
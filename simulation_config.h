@@ -3,6 +3,7 @@
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
+#include <map>
 
 struct Vector3D {
     double x;
@@ -10,21 +11,78 @@ struct Vector3D {
     double z;
 };
 
+// Local mesh refinement around the faces that carry boundary conditions
+struct RefinementConfig {
+    bool enabled = false;
+    double size = 0.0;                 // Element size at the faces; 0 uses min_element_size
+    double distance_min = 0.0;         // The refined size holds up to this distance
+    double distance_max = 0.0;         // max_element_size is reached here; 0 picks distance_min + 10 * size
+    bool constraints = true;           // Refine around the fixed faces
+    bool loads = true;                 // Refine around the loaded faces
+    std::vector<int> surfaces;         // Further faces to refine
+    int curvature_points = 0;          // Elements per full circle on curved faces; 0 disables it
+};
+
+// Shell model of a thin-walled part: shell elements on the listed faces instead of solid tetrahedra
+struct ShellConfig {
+    bool enabled = false;
+    std::vector<int> surfaces;         // Faces to mesh with shells, one per wall
+    double thickness = 0.0;            // 0 measures it across the body at each face
+    bool quads = false;                // S8 quadrilaterals instead of S6 triangles
+};
+
+// Half or quarter model of a mirror-symmetric part and load case
+struct SymmetryConfig {
+    bool enabled = false;
+    int max_planes = 2;                // 1 allows a half model only
+    double tolerance = 1e-4;           // Relative to the model size, areas and volumes
+};
+
 struct MeshConfig {
-    int min_element_size;
-    int max_element_size;
+    double min_element_size;           // gmsh characteristic lengths; must be positive
+    double max_element_size;
+    std::string renumbering = "none";  // "none", "rcm" or "hilbert"
+    int workers = 0;                   // Meshing worker processes for assemblies; 0 uses all cores
+    int order = 2;                     // Element order; 0 chooses it from the resource budget
+    RefinementConfig refinement;
+    ShellConfig shell;
+    SymmetryConfig symmetry;
+};
+
+// Material of the listed bodies (gmsh volume tags); other bodies use the default
+struct BodyMaterialConfig {
+    std::string name;
+    double youngs_modulus;
+    double poisson_ratio;
+    std::vector<int> volumes;
+};
+
+// Geometric face selection; an alternative to a raw surface_id
+struct FaceSelectConfig {
+    std::vector<double> point;         // Face passes through this point
+    std::vector<double> box;           // Face inside [xmin, ymin, zmin, xmax, ymax, zmax]
+    std::vector<double> normal;        // Planar face with this outward normal
+    std::vector<double> plane_point;   // Planar face in the plane {"point", "normal"}
+    std::vector<double> plane_normal;
+    double tolerance = 1e-6;
+    double angle_tolerance = 1.0;      // Degrees
+
+    bool empty() const { return point.empty() && box.empty() && normal.empty() && plane_point.empty(); }
 };
 
 struct FixedFace {
-    int surface_id;
+    int surface_id = 0;                // 0 if resolved from `select`
     std::string name;
+    FaceSelectConfig select;
 };
 
 struct AppliedLoad {
-    int surface_id;
+    int surface_id = 0;                // 0 if resolved from `select`
     std::string name;
     double magnitude;
     Vector3D direction;
+    FaceSelectConfig select;
+    std::string distribution = "nodal";  // "nodal" (*CLOAD per node) or "pressure" (*DLOAD on element faces)
 };
 
 struct ConstraintsConfig {
@@ -35,20 +93,101 @@ struct LoadsConfig {
     std::vector<AppliedLoad> applied_loads;
 };
 
+struct FieldPrecisionConfig {
+    std::string type = "float64";  // "float64", "float32" or "quantized"
+    double tolerance = 0.0;        // Quantization error bound
+    bool relative = false;         // Tolerance relative to the field's largest value
+};
+
+struct OutputConfig {
+    bool volume = true;            // Full volume result (.vtu)
+    bool surface = false;          // Exterior surface only (.vtp)
+    bool linear_surface = false;   // Drop mid-side nodes of surface faces
+    bool columnar = false;         // Memory-mappable columnar result (.strc)
+    int partitions = 1;            // Volume split into N .vtu pieces plus a .pvtu index if > 1
+    std::vector<std::string> fields;  // FRD result blocks to convert; empty converts all
+    int step = 0;                  // Analysis step to convert; 0 selects the last step
+    std::map<std::string, FieldPrecisionConfig> precision;  // Per VTU array name
+};
+
+struct SuperpositionConfig {
+    bool enabled = false;          // Solve unit x/y/z loads once and combine applied_loads from them
+};
+
+struct SolverConfig {
+    std::string command = "ccx_2.22";  // CalculiX executable
+    std::string cache_directory;       // Content-addressed result cache; empty disables it
+    double cache_size_mb = 1024.0;     // Least recently used results are evicted beyond this
+    double timeout_seconds = 0.0;      // Wall-clock limit of one solver run; 0 disables it
+    double memory_limit_mb = 0.0;      // Resident memory limit of the solver; 0 disables it
+};
+
+// Budget the mesh is coarsened to fit; 0 falls back to the solver limits
+struct ResourceConfig {
+    double memory_mb = 0.0;
+    double time_seconds = 0.0;
+    bool plan_only = false;            // Report the estimate without writing or solving
+};
+
+struct ParallelConfig {
+    unsigned threads = 0;              // Scheduler threads; 0 uses every available CPU
+    bool pin_threads = false;
+    int numa_node = -1;                // -1 for any node
+};
+
+struct LoggingConfig {
+    std::string level = "info";        // "trace", "debug", "info", "warning", "error" or "off"
+};
+
 struct SimulationConfig {
     std::string step_file;
     MeshConfig mesh;
     ConstraintsConfig constraints;
     LoadsConfig loads;
+    OutputConfig output;
+    SuperpositionConfig superposition;
+    std::vector<BodyMaterialConfig> materials;
+    SolverConfig solver;
+    ResourceConfig resources;
+    ParallelConfig parallel;
+    LoggingConfig logging;
     
     static SimulationConfig fromJsonFile(const std::string& filename);
     static SimulationConfig fromJson(const nlohmann::json& json);
 };
 
+// Sections with optional keys are (de)serialized by hand
+void to_json(nlohmann::json& json, const FaceSelectConfig& select);
+void from_json(const nlohmann::json& json, FaceSelectConfig& select);
+void to_json(nlohmann::json& json, const FixedFace& fixed_face);
+void from_json(const nlohmann::json& json, FixedFace& fixed_face);
+void to_json(nlohmann::json& json, const AppliedLoad& load);
+void from_json(const nlohmann::json& json, AppliedLoad& load);
+void to_json(nlohmann::json& json, const RefinementConfig& refinement);
+void from_json(const nlohmann::json& json, RefinementConfig& refinement);
+void to_json(nlohmann::json& json, const ShellConfig& shell);
+void from_json(const nlohmann::json& json, ShellConfig& shell);
+void to_json(nlohmann::json& json, const SymmetryConfig& symmetry);
+void from_json(const nlohmann::json& json, SymmetryConfig& symmetry);
+void to_json(nlohmann::json& json, const MeshConfig& mesh);
+void from_json(const nlohmann::json& json, MeshConfig& mesh);
+void to_json(nlohmann::json& json, const FieldPrecisionConfig& precision);
+void from_json(const nlohmann::json& json, FieldPrecisionConfig& precision);
+void to_json(nlohmann::json& json, const OutputConfig& output);
+void from_json(const nlohmann::json& json, OutputConfig& output);
+void to_json(nlohmann::json& json, const SuperpositionConfig& superposition);
+void from_json(const nlohmann::json& json, SuperpositionConfig& superposition);
+void to_json(nlohmann::json& json, const SolverConfig& solver);
+void from_json(const nlohmann::json& json, SolverConfig& solver);
+void to_json(nlohmann::json& json, const ResourceConfig& resources);
+void from_json(const nlohmann::json& json, ResourceConfig& resources);
+void to_json(nlohmann::json& json, const ParallelConfig& parallel);
+void from_json(const nlohmann::json& json, ParallelConfig& parallel);
+void to_json(nlohmann::json& json, const LoggingConfig& logging);
+void from_json(const nlohmann::json& json, LoggingConfig& logging);
+
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Vector3D, x, y, z)
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(MeshConfig, min_element_size, max_element_size)
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(FixedFace, surface_id, name)
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(AppliedLoad, surface_id, name, magnitude, direction)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(BodyMaterialConfig, name, youngs_modulus, poisson_ratio, volumes)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ConstraintsConfig, fixed_faces)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LoadsConfig, applied_loads)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(SimulationConfig, step_file, mesh, constraints, loads)
\ No newline at end of file
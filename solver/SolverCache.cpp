@@ -0,0 +1,330 @@
+#include "SolverCache.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <cctype>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace {
+
+const char* kIndexHeader = "strecsfem-solver-cache 1";
+
+// Maximum *INCLUDE nesting followed when hashing a deck
+const int kMaxIncludeDepth = 8;
+
+// 128-bit content hash from two independently mixed 64-bit lanes
+class ContentHash {
+public:
+    void update(const std::string& data) {
+        for (unsigned char c : data) {
+            a_ = (a_ ^ c) * 1099511628211ull;  // FNV-1a
+            b_ = (b_ ^ c) * 0xff51afd7ed558ccdull;
+            b_ ^= b_ >> 29;
+        }
+    }
+
+    std::string hex() const {
+        std::ostringstream out;
+        out << std::hex << std::setfill('0') << std::setw(16) << a_ << std::setw(16) << b_;
+        return out.str();
+    }
+
+private:
+    std::uint64_t a_ = 14695981039346656037ull;
+    std::uint64_t b_ = 0x9e3779b97f4a7c15ull;
+};
+
+std::string toUpper(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::toupper(c); });
+    return s;
+}
+
+// File named by INPUT= of an *INCLUDE card; empty for any other line
+std::string includedFile(const std::string& line) {
+    std::string upper = toUpper(line);
+    if (upper.compare(0, 8, "*INCLUDE") != 0) return "";
+    std::size_t input = upper.find("INPUT=");
+    if (input == std::string::npos) return "";
+    std::string name = line.substr(input + 6);
+    name = name.substr(0, name.find(','));
+    name.erase(std::remove_if(name.begin(), name.end(), [](unsigned char c) {
+        return c == '"' || std::isspace(c);
+    }), name.end());
+    return name;
+}
+
+bool hashDeck(const std::string& filename, int depth, ContentHash& hash) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "エラー: ファイルを開けませんでした: " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        hash.update(line);
+        hash.update("\n");
+        std::string include = includedFile(line);
+        if (!include.empty() && depth < kMaxIncludeDepth && !hashDeck(include, depth + 1, hash)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+double SolverCacheStatistics::getHitRate() const {
+    std::size_t lookups = hits + misses;
+    return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+}
+
+SolverCache::SolverCache()
+    : max_bytes_(0)
+{
+}
+
+SolverCache::~SolverCache() {
+}
+
+const SolverCacheStatistics& SolverCache::getStatistics() const {
+    return statistics_;
+}
+
+int SolverCache::open(const std::string& directory, std::uintmax_t max_bytes) {
+    directory_ = directory;
+    max_bytes_ = max_bytes;
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        std::cerr << "エラー: キャッシュディレクトリを作成できませんでした: " << directory_
+                  << " (" << ec.message() << ")" << std::endl;
+        return 1;
+    }
+    return loadIndex();
+}
+
+std::string SolverCache::computeKey(const std::string& inp_file, const std::string& solver_identity) {
+    ContentHash hash;
+    hash.update(solver_identity);
+    hash.update("\n");
+    if (!hashDeck(inp_file, 0, hash)) {
+        return "";
+    }
+    return hash.hex();
+}
+
+std::string SolverCache::describeSolver(const std::string& command) {
+    // The banner costs a process launch, so ask each solver only once per process
+    static std::mutex mutex;
+    static std::map<std::string, std::string> identities;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = identities.find(command);
+    if (it != identities.end()) return it->second;
+
+    std::string identity = command + "\n";
+    if (FILE* pipe = popen((command + " -v 2>&1").c_str(), "r")) {
+        char buffer[256];
+        while (identity.size() < 4096 && std::fgets(buffer, sizeof(buffer), pipe)) {
+            identity += buffer;
+        }
+        pclose(pipe);
+    }
+    identities[command] = identity;
+    return identity;
+}
+
+std::string SolverCache::pathOf(const std::string& key, const std::string& extension) const {
+    return (std::filesystem::path(directory_) / (key + extension)).string();
+}
+
+bool SolverCache::fetch(const std::string& key, const std::string& base_name) {
+    auto it = entries_.find(key);
+    if (it == entries_.end() || !std::filesystem::exists(pathOf(key, ".frd"))) {
+        if (it != entries_.end()) {
+            entries_.erase(it);  // Files removed behind our back
+        }
+        ++statistics_.misses;
+        saveIndex();
+        return false;
+    }
+
+    if (!linkOrCopy(pathOf(key, ".frd"), base_name + ".frd")) {
+        ++statistics_.misses;
+        saveIndex();
+        return false;
+    }
+    if (std::filesystem::exists(pathOf(key, ".dat"))) {
+        linkOrCopy(pathOf(key, ".dat"), base_name + ".dat");
+    } else {
+        std::error_code ec;
+        std::filesystem::remove(base_name + ".dat", ec);  // Stale output of an earlier run
+    }
+    it->second.last_used = now();
+    ++statistics_.hits;
+    saveIndex();
+    return true;
+}
+
+int SolverCache::store(const std::string& key, const std::string& base_name) {
+    if (!linkOrCopy(base_name + ".frd", pathOf(key, ".frd"))) {
+        return 1;
+    }
+    std::error_code ec;
+    Entry entry = {std::filesystem::file_size(pathOf(key, ".frd"), ec), now()};
+    if (std::filesystem::exists(base_name + ".dat") && linkOrCopy(base_name + ".dat", pathOf(key, ".dat"))) {
+        entry.size += std::filesystem::file_size(pathOf(key, ".dat"), ec);
+    }
+    entries_[key] = entry;
+    evict(key);
+    return saveIndex();
+}
+
+void SolverCache::evict(const std::string& keep) {
+    std::uintmax_t total = 0;
+    for (const auto& [key, entry] : entries_) {
+        total += entry.size;
+    }
+
+    std::vector<std::pair<std::int64_t, std::string>> by_age;
+    for (const auto& [key, entry] : entries_) {
+        if (key != keep) by_age.push_back({entry.last_used, key});
+    }
+    std::sort(by_age.begin(), by_age.end());
+
+    for (const auto& [last_used, key] : by_age) {
+        if (total <= max_bytes_) break;
+        std::error_code ec;
+        std::filesystem::remove(pathOf(key, ".frd"), ec);
+        std::filesystem::remove(pathOf(key, ".dat"), ec);
+        total -= entries_[key].size;
+        entries_.erase(key);
+        ++statistics_.evictions;
+    }
+}
+
+bool SolverCache::linkOrCopy(const std::string& source, const std::string& target) {
+    // Replace rather than overwrite: the target may share an inode with a cache entry
+    std::error_code ec;
+    std::filesystem::remove(target, ec);
+    std::filesystem::create_hard_link(source, target, ec);
+    if (ec) {
+        ec.clear();
+        std::filesystem::copy_file(source, target, std::filesystem::copy_options::overwrite_existing, ec);
+    }
+    if (ec) {
+        std::cerr << "エラー: " << source << " を " << target << " にコピーできませんでした: " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int SolverCache::loadIndex() {
+    readIndex(entries_, statistics_);
+    saved_statistics_ = statistics_;
+    return 0;
+}
+
+bool SolverCache::readIndex(std::map<std::string, Entry>& entries, SolverCacheStatistics& statistics) const {
+    entries.clear();
+    statistics = SolverCacheStatistics();
+
+    std::ifstream index(pathOf("index", ""));
+    std::string line;
+    if (!index.is_open() || !std::getline(index, line) || line != kIndexHeader) {
+        return false;  // New or unreadable cache: start empty
+    }
+    std::string word;
+    if (std::getline(index, line)) {
+        std::istringstream stats(line);
+        stats >> word >> statistics.hits >> statistics.misses >> statistics.evictions;
+    }
+    while (std::getline(index, line)) {
+        std::istringstream record(line);
+        std::string key;
+        Entry entry;
+        if (record >> key >> entry.size >> entry.last_used) {
+            entries[key] = entry;
+        }
+    }
+    statistics.entries = entries.size();
+    for (const auto& [key, entry] : entries) {
+        statistics.bytes += entry.size;
+    }
+    return true;
+}
+
+int SolverCache::saveIndex() {
+    // Pipelines sharing the cache each hold their own view of the index: merge
+    // with the one on disk under an exclusive lock so no entry or count is lost
+    std::string lock_file = pathOf("index", ".lock");
+    int lock = ::open(lock_file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+        std::cerr << "エラー: キャッシュインデックスをロックできませんでした: " << lock_file << std::endl;
+        if (lock >= 0) close(lock);
+        return 1;
+    }
+
+    std::map<std::string, Entry> on_disk;
+    SolverCacheStatistics disk_statistics;
+    readIndex(on_disk, disk_statistics);
+    for (const auto& [key, entry] : on_disk) {
+        auto [it, inserted] = entries_.emplace(key, entry);
+        if (!inserted) it->second.last_used = std::max(it->second.last_used, entry.last_used);
+    }
+    // Entries evicted by any process have lost their files
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        it = std::filesystem::exists(pathOf(it->first, ".frd")) ? std::next(it) : entries_.erase(it);
+    }
+    statistics_.hits = disk_statistics.hits + (statistics_.hits - saved_statistics_.hits);
+    statistics_.misses = disk_statistics.misses + (statistics_.misses - saved_statistics_.misses);
+    statistics_.evictions = disk_statistics.evictions + (statistics_.evictions - saved_statistics_.evictions);
+    statistics_.entries = entries_.size();
+    statistics_.bytes = 0;
+    for (const auto& [key, entry] : entries_) {
+        statistics_.bytes += entry.size;
+    }
+
+    // Write-then-rename so a concurrent reader never sees a partial index
+    std::string index_file = pathOf("index", "");
+    std::string temp_file = pathOf("index", "." + std::to_string(getpid()) + ".tmp");
+    int result = 0;
+    {
+        std::ofstream index(temp_file, std::ios::trunc);
+        index << kIndexHeader << "\n";
+        index << "stats " << statistics_.hits << " " << statistics_.misses << " " << statistics_.evictions << "\n";
+        for (const auto& [key, entry] : entries_) {
+            index << key << " " << entry.size << " " << entry.last_used << "\n";
+        }
+        if (!index.good()) {
+            std::cerr << "エラー: キャッシュインデックスを書き込めませんでした: " << temp_file << std::endl;
+            result = 1;
+        }
+    }
+    std::error_code ec;
+    if (result == 0) {
+        std::filesystem::rename(temp_file, index_file, ec);
+        result = ec ? 1 : 0;
+    }
+    if (result != 0) {
+        std::filesystem::remove(temp_file, ec);
+    } else {
+        saved_statistics_ = statistics_;
+    }
+    close(lock);
+    return result;
+}
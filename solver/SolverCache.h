@@ -0,0 +1,67 @@
+#ifndef SOLVER_CACHE_H
+#define SOLVER_CACHE_H
+
+#include <string>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+struct SolverCacheStatistics {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t entries = 0;
+    std::uintmax_t bytes = 0;
+
+    double getHitRate() const;
+};
+
+// Content-addressed store of solver outputs (.frd, .dat). The key is a hash of
+// the input deck, including its *INCLUDE files, and of the solver identity, so
+// a byte-identical rerun can skip the solver. Entries are evicted least
+// recently used first once the cache grows beyond its size bound.
+class SolverCache {
+public:
+    SolverCache();
+    ~SolverCache();
+
+    // Open (or create) the cache directory and read its index
+    int open(const std::string& directory, std::uintmax_t max_bytes);
+
+    // Key of an input deck as solved by the described solver
+    static std::string computeKey(const std::string& inp_file, const std::string& solver_identity);
+
+    // Command line plus the version banner the solver prints for -v
+    static std::string describeSolver(const std::string& command);
+
+    // Hard-link (or copy) the cached outputs of key to <base_name>.frd/.dat; false on a miss
+    bool fetch(const std::string& key, const std::string& base_name);
+
+    // Store <base_name>.frd/.dat under key, then evict beyond the size bound
+    int store(const std::string& key, const std::string& base_name);
+
+    const SolverCacheStatistics& getStatistics() const;
+
+private:
+    struct Entry {
+        std::uintmax_t size;
+        std::int64_t last_used;
+    };
+
+    int loadIndex();
+    bool readIndex(std::map<std::string, Entry>& entries, SolverCacheStatistics& statistics) const;
+    int saveIndex();
+    void evict(const std::string& keep);
+    std::string pathOf(const std::string& key, const std::string& extension) const;
+
+    // Link target to source, falling back to a copy across file systems
+    static bool linkOrCopy(const std::string& source, const std::string& target);
+
+    std::string directory_;
+    std::uintmax_t max_bytes_;
+    std::map<std::string, Entry> entries_;
+    SolverCacheStatistics statistics_;
+    SolverCacheStatistics saved_statistics_;  // Counters as last read from or written to the index
+};
+
+#endif // SOLVER_CACHE_H
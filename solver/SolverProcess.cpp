@@ -0,0 +1,308 @@
+#include "SolverProcess.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+namespace {
+
+// Set by cancel() and the signal handlers, polled by the supervision loop
+volatile std::sig_atomic_t g_cancel_requested = 0;
+
+void onSignal(int) {
+    g_cancel_requested = 1;
+}
+
+// Single-quoted for sh, so that a word with spaces or metacharacters stays one argument
+std::string shellQuote(const std::string& word) {
+    std::string quoted = "'";
+    for (char c : word) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
+
+// Seconds between SIGTERM and SIGKILL
+const double kTerminateGrace = 5.0;
+
+// Seconds between resident memory samples of the solver's process group
+const double kMemoryCheckInterval = 0.5;
+
+// Solver phase messages worth reporting (CalculiX prints them on their own line)
+const char* kPhases[] = {
+    "Determining the structure of the matrix",
+    "Factoring the system of equations",
+    "Solving the system of equations",
+    "Calculating the stiffness matrix",
+    "Job finished"
+};
+
+bool startsWith(const std::string& s, const char* prefix) {
+    return s.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+} // namespace
+
+SolverProcess::SolverProcess()
+    : timeout_(0.0)
+    , memory_limit_mb_(0)
+    , echo_(true)
+{
+}
+
+SolverProcess::~SolverProcess() {
+}
+
+void SolverProcess::setTimeout(double seconds) {
+    timeout_ = seconds;
+}
+
+void SolverProcess::setMemoryLimit(std::size_t megabytes) {
+    memory_limit_mb_ = megabytes;
+}
+
+void SolverProcess::setProgressCallback(std::function<void(const SolverProgress&)> callback) {
+    callback_ = std::move(callback);
+}
+
+void SolverProcess::setEcho(bool echo) {
+    echo_ = echo;
+}
+
+void SolverProcess::cancel() {
+    g_cancel_requested = 1;
+}
+
+void SolverProcess::resetCancel() {
+    g_cancel_requested = 0;
+}
+
+const SolverRunSummary& SolverProcess::getSummary() const {
+    return summary_;
+}
+
+const SolverProgress& SolverProcess::getProgress() const {
+    return progress_;
+}
+
+bool SolverProcess::parseProgressLine(const std::string& raw, SolverProgress& progress, SolverRunSummary& summary) {
+    std::size_t first = raw.find_first_not_of(" \t");
+    if (first == std::string::npos) return false;
+    std::string line = raw.substr(first);
+    std::istringstream ss(line);
+    std::string word;
+
+    if (startsWith(line, "STEP ")) {
+        ss >> word >> progress.step;
+        progress.increment = progress.attempt = progress.iteration = 0;
+        ++summary.steps;
+        return true;
+    }
+    if (startsWith(line, "increment ") && line.find("attempt") != std::string::npos) {
+        // " increment 3 attempt 1 "
+        ss >> word >> progress.increment >> word >> progress.attempt;
+        progress.iteration = 0;
+        ++summary.increments;
+        return true;
+    }
+    if (startsWith(line, "iteration ")) {
+        ss >> word >> progress.iteration;
+        ++summary.iterations;
+        return true;
+    }
+    if (startsWith(line, "actual total time=")) {
+        progress.total_time = std::strtod(line.c_str() + std::strlen("actual total time="), nullptr);
+        return false;  // Reported with the next iteration
+    }
+    for (const char* phase : kPhases) {
+        if (startsWith(line, phase) && progress.phase != phase) {
+            progress.phase = phase;
+            return true;
+        }
+    }
+    return false;
+}
+
+long SolverProcess::readResidentKilobytes(int process_group) {
+    // Sum over the group: the solver may run under a wrapper or spawn helpers
+    long total = 0;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.find_first_not_of("0123456789") != std::string::npos) continue;
+
+        // Fields after the parenthesised command name: state, ppid, pgrp
+        std::ifstream stat(entry.path() / "stat");
+        std::string line;
+        if (!std::getline(stat, line)) continue;
+        std::size_t close_paren = line.rfind(')');
+        if (close_paren == std::string::npos) continue;
+        std::istringstream fields(line.substr(close_paren + 1));
+        std::string state;
+        int parent = 0, group = 0;
+        if (!(fields >> state >> parent >> group) || group != process_group) continue;
+
+        std::ifstream status(entry.path() / "status");
+        while (std::getline(status, line)) {
+            if (startsWith(line, "VmRSS:")) {
+                total += std::strtol(line.c_str() + 6, nullptr, 10);
+                break;
+            }
+        }
+    }
+    return total;
+}
+
+int SolverProcess::run(const std::string& command, const std::string& job_name) {
+    progress_ = SolverProgress();
+    summary_ = SolverRunSummary();
+    // A cancellation that arrived while the job was being prepared stops it here
+    if (g_cancel_requested) {
+        summary_.cancelled = true;
+        std::cerr << "エラー: ソルバーをキャンセルしました" << std::endl;
+        return 1;
+    }
+
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+        std::cerr << "エラー: パイプを作成できませんでした: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // The command may carry its own arguments (mpirun ...); the job name is data
+    std::string shell_command = "exec " + command + " " + shellQuote(job_name);
+    std::cout.flush();
+    std::cerr.flush();
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Own process group, so cancellation reaches everything the solver starts
+        setpgid(0, 0);
+        dup2(pipe_fds[1], STDOUT_FILENO);
+        dup2(pipe_fds[1], STDERR_FILENO);
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+        execl("/bin/sh", "sh", "-c", shell_command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    close(pipe_fds[1]);
+    if (pid < 0) {
+        close(pipe_fds[0]);
+        std::cerr << "エラー: ソルバーを起動できませんでした: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    setpgid(pid, pid);
+
+    // Interrupts cancel the solver; the handlers are restored afterwards
+    struct sigaction action, previous_int, previous_term;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &previous_int);
+    sigaction(SIGTERM, &action, &previous_term);
+
+    auto elapsed = [start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::string buffer;
+    char chunk[4096];
+    bool open = true;
+    double terminate_time = -1.0;
+    double next_memory_check = 0.0;
+    while (true) {
+        if (open) {
+            pollfd fd = {pipe_fds[0], POLLIN, 0};
+            int ready = poll(&fd, 1, 100);
+            if (ready > 0) {
+                ssize_t received = read(pipe_fds[0], chunk, sizeof(chunk));
+                if (received > 0) {
+                    buffer.append(chunk, static_cast<std::size_t>(received));
+                } else if (received == 0 || errno != EINTR) {
+                    open = false;
+                }
+            }
+            std::size_t newline;
+            while ((newline = buffer.find('\n')) != std::string::npos) {
+                std::string line = buffer.substr(0, newline);
+                buffer.erase(0, newline + 1);
+                if (echo_) {
+                    std::cout << line << "\n";
+                }
+                if (parseProgressLine(line, progress_, summary_) && callback_) {
+                    callback_(progress_);
+                }
+            }
+        }
+
+        // Never block here, so limits are still enforced after the output closes
+        int status = 0;
+        struct rusage usage;
+        pid_t done = wait4(pid, &status, WNOHANG, &usage);
+        if (done == pid) {
+            summary_.peak_rss_kb = std::max(summary_.peak_rss_kb, static_cast<long>(usage.ru_maxrss));
+            summary_.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            break;
+        }
+        if (done < 0 && errno != EINTR) {
+            break;
+        }
+
+        // Limits and cancellation: SIGTERM to the group first, SIGKILL after a grace period
+        if (terminate_time < 0) {
+            if (g_cancel_requested) {
+                summary_.cancelled = true;
+            } else if (timeout_ > 0 && elapsed() > timeout_) {
+                summary_.timed_out = true;
+            } else if (memory_limit_mb_ > 0 && elapsed() >= next_memory_check) {
+                long resident = readResidentKilobytes(pid);
+                summary_.peak_rss_kb = std::max(summary_.peak_rss_kb, resident);
+                summary_.memory_exceeded = resident > static_cast<long>(memory_limit_mb_ * 1024);
+                next_memory_check = elapsed() + kMemoryCheckInterval;
+            }
+            if (summary_.cancelled || summary_.timed_out || summary_.memory_exceeded) {
+                kill(-pid, SIGTERM);
+                terminate_time = elapsed();
+            }
+        } else if (elapsed() - terminate_time > kTerminateGrace) {
+            kill(-pid, SIGKILL);
+        }
+        if (!open) {
+            usleep(100000);
+        }
+    }
+    close(pipe_fds[0]);
+    if (echo_ && !buffer.empty()) {
+        std::cout << buffer << std::endl;
+    }
+    std::cout.flush();
+
+    sigaction(SIGINT, &previous_int, nullptr);
+    sigaction(SIGTERM, &previous_term, nullptr);
+    summary_.wall_seconds = elapsed();
+
+    if (summary_.cancelled) {
+        std::cerr << "エラー: ソルバーをキャンセルしました" << std::endl;
+    } else if (summary_.timed_out) {
+        std::cerr << "エラー: ソルバーが制限時間 " << timeout_ << " 秒を超えました" << std::endl;
+    } else if (summary_.memory_exceeded) {
+        std::cerr << "エラー: ソルバーがメモリ制限 " << memory_limit_mb_ << " MB を超えました" << std::endl;
+    }
+    bool failed = summary_.exit_code != 0 || summary_.cancelled || summary_.timed_out || summary_.memory_exceeded;
+    return failed ? 1 : 0;
+}
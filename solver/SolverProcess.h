@@ -0,0 +1,77 @@
+#ifndef SOLVER_PROCESS_H
+#define SOLVER_PROCESS_H
+
+#include <string>
+#include <functional>
+#include <cstddef>
+
+// Position of a running CalculiX job, parsed from its console output
+struct SolverProgress {
+    int step = 0;
+    int increment = 0;
+    int attempt = 0;
+    int iteration = 0;
+    double total_time = 0.0;   // Analysis time reached ("actual total time=")
+    std::string phase;         // Last solver phase message, e.g. "Factoring the system of equations"
+};
+
+struct SolverRunSummary {
+    int exit_code = -1;
+    bool timed_out = false;
+    bool memory_exceeded = false;
+    bool cancelled = false;
+    double wall_seconds = 0.0;
+    long peak_rss_kb = 0;
+    int steps = 0;
+    int increments = 0;        // Increment attempts started
+    int iterations = 0;        // Equilibrium iterations over all increments
+};
+
+// Runs the solver as a supervised child process in its own process group:
+// output is piped and parsed into progress events, wall-clock and resident
+// memory limits are enforced, and the whole group is terminated on cancellation.
+class SolverProcess {
+public:
+    SolverProcess();
+    ~SolverProcess();
+
+    // Limits; 0 disables them
+    void setTimeout(double seconds);
+    void setMemoryLimit(std::size_t megabytes);
+
+    // Called on every change of step, increment, iteration or phase
+    void setProgressCallback(std::function<void(const SolverProgress&)> callback);
+
+    // Echo the solver output to stdout (default on)
+    void setEcho(bool echo);
+
+    // Run `command job_name` through /bin/sh in the current directory and wait for it.
+    // SIGINT/SIGTERM received meanwhile cancel the solver instead of only this process.
+    int run(const std::string& command, const std::string& job_name);
+
+    // Cancel the running solver, or the next one if none runs yet; safe from
+    // other threads and signal handlers
+    static void cancel();
+
+    // Forget an earlier cancel(); call when a job is set up, before anything may cancel it
+    static void resetCancel();
+
+    const SolverRunSummary& getSummary() const;
+    const SolverProgress& getProgress() const;
+
+    // Update progress from one output line; true if anything changed
+    static bool parseProgressLine(const std::string& line, SolverProgress& progress, SolverRunSummary& summary);
+
+private:
+    // Resident memory of all processes in the group
+    static long readResidentKilobytes(int process_group);
+
+    double timeout_;
+    std::size_t memory_limit_mb_;
+    bool echo_;
+    std::function<void(const SolverProgress&)> callback_;
+    SolverProgress progress_;
+    SolverRunSummary summary_;
+};
+
+#endif // SOLVER_PROCESS_H
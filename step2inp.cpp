@@ -1,28 +1,147 @@
 #include "step2inp.h"
 #include <iostream>
+#include <set>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
 #include <gmsh.h>
+#include "logging/Logger.h"
 
-Step2Inp::Step2Inp() {}
+namespace {
+
+// Initializes gmsh unless a long-running owner already did, and finalizes
+// only what it initialized itself
+class GmshSession {
+public:
+    GmshSession() : owner_(!gmsh::isInitialized()) {
+        if (owner_) gmsh::initialize();
+    }
+    ~GmshSession() {
+        if (owner_) gmsh::finalize();
+    }
+
+private:
+    bool owner_;
+};
+
+// A gmsh model of its own for geometry that is modified in place, removed on scope exit
+class ScratchModel {
+public:
+    ScratchModel() : active_(false) {}
+    ~ScratchModel() {
+        try {
+            if (active_) gmsh::model::remove();
+        } catch (const std::exception&) {
+        }
+    }
+
+    void open(const std::string& name) {
+        gmsh::model::add(name);
+        active_ = true;
+    }
+
+private:
+    bool active_;
+};
+
+// Writes the queued log lines on scope exit, so that they come before the caller's own output
+class LogFlush {
+public:
+    ~LogFlush() {
+        Logger::instance().flush();
+    }
+};
+
+} // namespace
+
+Step2Inp::Step2Inp() : model_cache_(nullptr), plan_only_(false), symmetry_(false) {}
 
 Step2Inp::~Step2Inp() {}
 
 int Step2Inp::convert(const std::string& step_file,
-                      const std::vector<ConstraintCondition>& constraints,
-                      const std::vector<LoadCondition>& loads) {
-    gmsh::initialize();
+                      const std::vector<ConstraintCondition>& full_constraints,
+                      const std::vector<LoadCondition>& full_loads) {
+    LogFlush log_flush;
+    GmshSession session;
+    ScratchModel scratch;
+
+    // Conditions of the model actually solved: the full one, or the part kept by symmetry
+    std::vector<ConstraintCondition> constraints = full_constraints;
+    std::vector<LoadCondition> loads = full_loads;
+    bool reduce = symmetry_ && !mesh_generator_.isShellModel() && !load_setter_.getUnitLoadCases();
+    if (symmetry_ && !reduce) {
+        LOG_INFO("シェルモデルと単位荷重ケースでは対称性を利用しません");
+    }
+    constraint_setter_.clearSymmetryPlanes();
 
     try {
-        // Generate mesh
-        if (mesh_generator_.generateMesh(step_file) != 0) {
-            gmsh::finalize();
+        // Generate mesh unless the cached model already holds one with these settings
+        // A plan always meshes anew: its estimate is not kept with the cached mesh
+        bool meshed = false;
+        std::string mesh_key = plan_only_ ? "" : getMeshKey();
+        // The cut geometry must not replace the cached model of the full part
+        ModelCache* model_cache = reduce ? nullptr : model_cache_;
+        if (reduce) {
+            scratch.open("strecsfem_symmetry");
+        }
+        int status = model_cache ? model_cache->open(step_file, mesh_key, mesh_generator_, node_renumberer_, meshed)
+                                 : mesh_generator_.importGeometry(step_file);
+        if (status != 0) {
             return 1;
         }
+        if (reduce) {
+            if (symmetry_reducer_.detect(constraints, loads, material_setter_) != 0 ||
+                symmetry_reducer_.reduce(mesh_generator_, material_setter_, constraints, loads) != 0) {
+                return 1;
+            }
+            const std::vector<SymmetryPlane>& planes = symmetry_reducer_.getPlanes();
+            for (std::size_t p = 0; p < planes.size(); ++p) {
+                constraint_setter_.addSymmetryPlane(planes[p].axis, symmetry_reducer_.getPlaneSurfaces()[p]);
+            }
+        }
+        if (meshed) {
+            LOG_INFO("キャッシュ済みのメッシュを再利用します: " << step_file);
+        } else {
+            if (mesh_generator_.generateMesh() != 0) {
+                return 1;
+            }
+            if (plan_only_) {
+                if (model_cache) {
+                    model_cache->storeMesh(getMeshKey(), mesh_generator_, node_renumberer_);
+                }
+                return 0;
+            }
+
+            // Renumber nodes and elements for bandwidth and locality
+            if (node_renumberer_.getMethod() != RenumberingMethod::None && node_renumberer_.renumber() != 0) {
+                return 1;
+            }
+            if (model_cache) {
+                model_cache->storeMesh(getMeshKey(), mesh_generator_, node_renumberer_);
+            }
+        }
+
+        // One material element set per body, or one shell section per meshed face
+        material_setter_.setVolumes(mesh_generator_.getVolumeTags());
+        material_setter_.setShellSections(mesh_generator_.getShellSections());
+        std::vector<int> shell_surfaces;
+        for (const ShellSection& section : mesh_generator_.getShellSections()) {
+            shell_surfaces.push_back(section.surface);
+        }
+        inp_writer_.setShellSurfaces(shell_surfaces);
+        constraint_setter_.setFixRotations(mesh_generator_.isShellModel());
+
+        // Pressure needs the faces of volume elements; shells take the force as nodal loads
+        bool pressure_loads = !mesh_generator_.isShellModel();
+        if (!pressure_loads && std::any_of(loads.begin(), loads.end(), [](const LoadCondition& load) { return load.pressure; })) {
+            LOG_INFO("シェルモデルでは圧力荷重を寄与面積に基づく節点荷重で与えます");
+        }
 
         // Validate surfaces
         for (const auto& constraint : constraints) {
             if (!mesh_generator_.hasSurface(constraint.surface_number)) {
                 std::cerr << "エラー: Surface " << constraint.surface_number << " が見つかりません。" << std::endl;
-                gmsh::finalize();
                 return 1;
             }
         }
@@ -30,27 +149,66 @@ int Step2Inp::convert(const std::string& step_file,
         for (const auto& load : loads) {
             if (!mesh_generator_.hasSurface(load.surface_number)) {
                 std::cerr << "エラー: Surface " << load.surface_number << " が見つかりません。" << std::endl;
-                gmsh::finalize();
                 return 1;
             }
         }
 
+        // The deck refers to the Surface<id> node sets of the mesh file, which a
+        // face without mesh nodes (a solid face of a shell model) does not get
+        std::set<int> referenced;
+        for (const auto& constraint : constraints) {
+            referenced.insert(constraint.surface_number);
+        }
+        for (const auto& load : loads) {
+            referenced.insert(load.surface_number);
+        }
+        if (reduce) {
+            for (const auto& surfaces : symmetry_reducer_.getPlaneSurfaces()) {
+                referenced.insert(surfaces.begin(), surfaces.end());
+            }
+        }
+        for (int surface : referenced) {
+            if (!InpWriter::hasSurfaceNodes(surface)) {
+                std::cerr << "エラー: Surface " << surface << " にメッシュの節点が見つかりません。" << std::endl;
+                return 1;
+            }
+        }
+
+        if (material_setter_.checkMaterials() != 0) {
+            return 1;
+        }
+
         // Write initial INP file
         std::string base_name = InpWriter::getBaseFilename(step_file);
         std::string inp_file = base_name + ".inp";
 
-        if (inp_writer_.initializeInpFile(step_file, inp_file) != 0) {
-            gmsh::finalize();
+        if (node_renumberer_.getMethod() != RenumberingMethod::None &&
+            node_renumberer_.writeTagMap(base_name + ".renum") != 0) {
+            return 1;
+        }
+
+        // Planes of a reduced model, for mirroring its results; a stale list would mirror a full model
+        std::string symmetry_file = base_name + ".sym";
+        if (reduce && !symmetry_reducer_.getPlanes().empty()) {
+            if (symmetry_reducer_.writePlanes(symmetry_file) != 0) {
+                return 1;
+            }
+        } else {
+            std::error_code ec;
+            std::filesystem::remove(symmetry_file, ec);
+        }
+
+        // Mesh and surface node sets once per mesh; the deck holds only the case
+        if (inp_writer_.writeMeshInclude(inp_file, mesh_generator_.getSurfaceTags()) != 0) {
             return 1;
         }
 
-        // Open file for appending
-        std::ofstream f(inp_file, std::ios::app);
+        std::ofstream f(inp_file, std::ios::trunc);
         if (!f.is_open()) {
             std::cerr << "エラー: ファイルを開けませんでした: " << inp_file << std::endl;
-            gmsh::finalize();
             return 1;
         }
+        inp_writer_.writeInclude(f);
 
         // Write material and element sets
         material_setter_.writeEall(f);
@@ -60,54 +218,133 @@ int Step2Inp::convert(const std::string& step_file,
         for (const auto& constraint : constraints) {
             constraint_setter_.writeConstraintNodeSet(f, constraint.surface_number);
         }
+        constraint_setter_.writeSymmetryNodeSets(f);
+
+        // Element face surfaces for pressure loads (unit load cases stay nodal)
+        if (!load_setter_.getUnitLoadCases()) {
+            std::set<int> pressure_surfaces;
+            for (const auto& load : loads) {
+                if (load.pressure && pressure_loads) pressure_surfaces.insert(load.surface_number);
+            }
+            for (int surface : pressure_surfaces) {
+                if (load_setter_.writeLoadSurface(f, surface) != 0) {
+                    return 1;
+                }
+            }
+        }
 
         // Write material properties
         material_setter_.writePhysicalConstants(f);
         material_setter_.writeMaterial(f);
         material_setter_.writeSections(f);
 
-        // Write analysis step
-        inp_writer_.writeStep(f);
-        constraint_setter_.writeFixedConstraints(f);
+        if (load_setter_.getUnitLoadCases()) {
+            // One step per unit load; the fixed constraints carry over between steps
+            const char* axis_names[] = {"x", "y", "z"};
+            for (const auto& unit_case : LoadConditionSetter::createUnitLoadCases(loads)) {
+                std::vector<double> direction = {0.0, 0.0, 0.0};
+                direction[unit_case.axis] = 1.0;
 
-        // Write load conditions
-        for (const auto& load : loads) {
-            std::vector<std::size_t> node_tags;
-            std::vector<double> coord, parametricCoord;
-            gmsh::model::mesh::getNodes(node_tags, coord, parametricCoord, 2, load.surface_number, true);
+                inp_writer_.writeStep(f);
+                constraint_setter_.writeFixedConstraints(f);
+                load_setter_.writeForceBoundaryCondition(f, unit_case.surface_number, 1.0, direction, true);
+                inp_writer_.writeOutputs(f);
+                inp_writer_.writeEndStep(f);
+                LOG_INFO("Step " << unit_case.step << ": Surface " << unit_case.surface_number
+                         << " に単位荷重 (" << axis_names[unit_case.axis] << ") を追加しました");
+            }
+        } else {
+            // Write analysis step
+            inp_writer_.writeStep(f);
+            constraint_setter_.writeFixedConstraints(f);
 
-            std::cout << "Surface " << load.surface_number << " のノード数: " << node_tags.size() << std::endl;
+            // Write load conditions
+            for (const auto& load : loads) {
+                std::vector<std::size_t> node_tags;
+                std::vector<double> coord, parametricCoord;
+                gmsh::model::mesh::getNodes(node_tags, coord, parametricCoord, 2, load.surface_number, true);
 
-            // Use area-based force calculation with values from load condition
-            load_setter_.writeForceBoundaryCondition(f, load.surface_number, load.magnitude, load.direction);
-            std::cout << "Surface " << load.surface_number << " に寄与面積に基づく力の境界条件を追加しました" << std::endl;
-        }
+                LOG_INFO("Surface " << load.surface_number << " のノード数: " << node_tags.size());
 
-        // Write outputs and end step
-        inp_writer_.writeOutputs(f);
-        inp_writer_.writeEndStep(f);
+                if (load.pressure && pressure_loads) {
+                    load_setter_.writePressureLoad(f, load.surface_number, load.magnitude, load.direction);
+                    continue;
+                }
+
+                // Use area-based force calculation with values from load condition
+                load_setter_.writeForceBoundaryCondition(f, load.surface_number, load.magnitude, load.direction);
+                LOG_INFO("Surface " << load.surface_number << " に寄与面積に基づく力の境界条件を追加しました");
+            }
+
+            // Write outputs and end step
+            inp_writer_.writeOutputs(f);
+            inp_writer_.writeEndStep(f);
+        }
 
         f.close();
 
-        std::cout << "変換完了（境界条件追加済み): " << step_file << " -> " << inp_file << std::endl;
-        std::cout << "適用された境界条件:" << std::endl;
+        LOG_INFO("変換完了（境界条件追加済み): " << step_file << " -> " << inp_file);
+        LOG_INFO("適用された境界条件:");
         for (const auto& constraint : constraints) {
-            std::cout << "  Surface " << constraint.surface_number << ": fixed" << std::endl;
+            LOG_INFO("  Surface " << constraint.surface_number << ": fixed");
         }
         for (const auto& load : loads) {
-            std::cout << "  Surface " << load.surface_number << ": force (magnitude: " << load.magnitude << ")" << std::endl;
+            LOG_INFO("  Surface " << load.surface_number << ": " << (load.pressure ? "pressure" : "force")
+                     << " (magnitude: " << load.magnitude << ")");
         }
 
     } catch (const std::exception& e) {
         std::cerr << "エラーが発生しました: " << e.what() << std::endl;
-        gmsh::finalize();
         return 1;
     }
 
-    gmsh::finalize();
     return 0;
 }
 
+int Step2Inp::resolveFaces(const std::string& step_file,
+                           const std::vector<FaceSelector>& selectors,
+                           std::vector<std::vector<int>>& surfaces) {
+    LogFlush log_flush;
+    GmshSession session;
+
+    // Geometry only; a cached mesh stays as it is
+    bool meshed = false;
+    int status = model_cache_ ? model_cache_->open(step_file, "", mesh_generator_, node_renumberer_, meshed)
+                              : mesh_generator_.importGeometry(step_file);
+    if (status != 0) {
+        return 1;
+    }
+
+    const FaceLocator& locator = mesh_generator_.getFaceLocator();
+    LOG_INFO("面の選択 (" << locator.getNumberOfFaces() << " faces):");
+    surfaces.clear();
+    for (std::size_t i = 0; i < selectors.size(); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        surfaces.push_back(locator.select(selectors[i]));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::ostringstream matched;
+        for (int surface : surfaces.back()) {
+            matched << " Surface " << surface;
+        }
+        if (surfaces.back().empty()) {
+            matched << " (一致なし)";
+        }
+        LOG_INFO("  Selector " << i + 1 << ":" << matched.str() << " [" << elapsed.count() << " ms]");
+    }
+
+    return 0;
+}
+
+void Step2Inp::setPlanOnly(bool plan_only) {
+    plan_only_ = plan_only;
+    mesh_generator_.setPlanOnly(plan_only);
+}
+
+std::string Step2Inp::getMeshKey() const {
+    return mesh_generator_.getSettingsKey() + "/" + std::to_string(static_cast<int>(node_renumberer_.getMethod()));
+}
+
 int convertStepToInp(const std::string& step_file,
                      const std::vector<ConstraintCondition>& constraints,
                      const std::vector<LoadCondition>& loads) {
@@ -9,6 +9,9 @@
 #include "step2inp/MaterialSetter.h"
 #include "step2inp/LoadConditionSetter.h"
 #include "step2inp/InpWriter.h"
+#include "step2inp/NodeRenumberer.h"
+#include "step2inp/ModelCache.h"
+#include "step2inp/SymmetryReducer.h"
 
 class Step2Inp {
 public:
@@ -20,20 +23,47 @@ public:
                 const std::vector<ConstraintCondition>& constraints,
                 const std::vector<LoadCondition>& loads);
 
+    // Import geometry only and resolve each selector to the surface tags it matches
+    int resolveFaces(const std::string& step_file,
+                     const std::vector<FaceSelector>& selectors,
+                     std::vector<std::vector<int>>& surfaces);
+
     // Access to components for advanced usage
     MeshGenerator& getMeshGenerator() { return mesh_generator_; }
     ConstraintSetter& getConstraintSetter() { return constraint_setter_; }
     MaterialSetter& getMaterialSetter() { return material_setter_; }
     LoadConditionSetter& getLoadConditionSetter() { return load_setter_; }
     InpWriter& getInpWriter() { return inp_writer_; }
+    NodeRenumberer& getNodeRenumberer() { return node_renumberer_; }
+    SymmetryReducer& getSymmetryReducer() { return symmetry_reducer_; }
+
+    // Take geometry and meshes from a cache of live gmsh models instead of
+    // importing the STEP file on every call (the cache must outlive the converter)
+    void setModelCache(ModelCache* model_cache) { model_cache_ = model_cache; }
+
+    // Only mesh to first order and estimate the solve; convert() then writes nothing
+    void setPlanOnly(bool plan_only);
+
+    // Solve a half or quarter model when the geometry and the conditions are mirror
+    // symmetric; the planes are written to <base>.sym for mirroring the results back.
+    // Not used for shell models and unit load cases.
+    void setSymmetry(bool symmetry) { symmetry_ = symmetry; }
 
 private:
+    // Everything that determines the mesh written to the INP file
+    std::string getMeshKey() const;
+
     // Component objects
     MeshGenerator mesh_generator_;
     ConstraintSetter constraint_setter_;
     MaterialSetter material_setter_;
     LoadConditionSetter load_setter_;
     InpWriter inp_writer_;
+    NodeRenumberer node_renumberer_;
+    SymmetryReducer symmetry_reducer_;
+    ModelCache* model_cache_;
+    bool plan_only_;
+    bool symmetry_;
 };
 
 // Utility function
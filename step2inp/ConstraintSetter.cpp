@@ -1,8 +1,7 @@
 #include "ConstraintSetter.h"
-#include <gmsh.h>
-#include <iostream>
+#include "InpWriter.h"
 
-ConstraintSetter::ConstraintSetter() {
+ConstraintSetter::ConstraintSetter() : fix_rotations_(false) {
 }
 
 ConstraintSetter::~ConstraintSetter() {
@@ -16,27 +15,41 @@ void ConstraintSetter::addConstraint(int surface_number) {
     constraints_.push_back({surface_number});
 }
 
-std::vector<int> ConstraintSetter::getConstraintNodeTags(int surface_number) const {
-    std::vector<std::size_t> node_tags;
-    std::vector<double> coord, parametricCoord;
-    gmsh::model::mesh::getNodes(node_tags, coord, parametricCoord, 2, surface_number, true);
+void ConstraintSetter::setFixRotations(bool fix_rotations) {
+    fix_rotations_ = fix_rotations;
+}
 
-    std::vector<int> int_node_tags(node_tags.begin(), node_tags.end());
-    return int_node_tags;
+void ConstraintSetter::addSymmetryPlane(int axis, const std::vector<int>& surfaces) {
+    symmetry_planes_.push_back({axis, surfaces});
 }
 
-void ConstraintSetter::writeConstraintNodeSet(std::ofstream& f, int surface_number) const {
-    std::vector<int> node_tags = getConstraintNodeTags(surface_number);
+void ConstraintSetter::clearSymmetryPlanes() {
+    symmetry_planes_.clear();
+}
 
+std::string ConstraintSetter::getSymmetryNodeSetName(int axis) {
+    const char* names[] = {"SymmetryX", "SymmetryY", "SymmetryZ"};
+    return names[axis];
+}
+
+void ConstraintSetter::writeConstraintNodeSet(std::ofstream& f, int surface_number) const {
+    // The nodes are listed once in the surface node set of the mesh file
     f << "***********************************************************\n";
     f << "** constraints fixed node sets\n";
     f << "** ConstraintFixed\n";
     f << "*NSET,NSET=ConstraintFixed\n";
-    for (int tag : node_tags) {
-        f << tag << ",\n";
-    }
+    f << InpWriter::getSurfaceNodeSetName(surface_number) << ",\n";
+}
 
-    std::cout << "Surface " << surface_number << " のノード数: " << node_tags.size() << std::endl;
+void ConstraintSetter::writeSymmetryNodeSets(std::ofstream& f) const {
+    for (const auto& [axis, surfaces] : symmetry_planes_) {
+        f << "***********************************************************\n";
+        f << "** symmetry plane node sets\n";
+        f << "*NSET,NSET=" << getSymmetryNodeSetName(axis) << "\n";
+        for (int surface : surfaces) {
+            f << InpWriter::getSurfaceNodeSetName(surface) << ",\n";
+        }
+    }
 }
 
 void ConstraintSetter::writeFixedConstraints(std::ofstream& f) const {
@@ -47,6 +60,14 @@ void ConstraintSetter::writeFixedConstraints(std::ofstream& f) const {
     f << "ConstraintFixed,1\n";
     f << "ConstraintFixed,2\n";
     f << "ConstraintFixed,3\n";
+    if (fix_rotations_) {
+        f << "ConstraintFixed,4\n";
+        f << "ConstraintFixed,5\n";
+        f << "ConstraintFixed,6\n";
+    }
+    for (const auto& [axis, surfaces] : symmetry_planes_) {
+        f << getSymmetryNodeSetName(axis) << "," << axis + 1 << "\n";
+    }
 }
 
 const std::vector<ConstraintCondition>& ConstraintSetter::getConstraints() const {
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <fstream>
+#include <string>
 
 struct ConstraintCondition {
     int surface_number;
@@ -17,11 +18,18 @@ public:
     void addConstraint(const ConstraintCondition& constraint);
     void addConstraint(int surface_number);
 
-    // Get node tags for a surface
-    std::vector<int> getConstraintNodeTags(int surface_number) const;
+    // Also fix the rotations (DOF 4-6), which shell nodes carry: a clamped edge
+    void setFixRotations(bool fix_rotations);
 
-    // Write constraint node sets to file
+    // Symmetry condition: the nodes of these faces keep their position along the
+    // axis (the faces where a symmetric model was cut)
+    void addSymmetryPlane(int axis, const std::vector<int>& surfaces);
+    void clearSymmetryPlanes();
+    static std::string getSymmetryNodeSetName(int axis);
+
+    // Write constraint node sets to file, by reference to the surface node sets of the mesh file
     void writeConstraintNodeSet(std::ofstream& f, int surface_number) const;
+    void writeSymmetryNodeSets(std::ofstream& f) const;
     void writeFixedConstraints(std::ofstream& f) const;
 
     // Get all constraints
@@ -29,6 +37,8 @@ public:
 
 private:
     std::vector<ConstraintCondition> constraints_;
+    bool fix_rotations_;
+    std::vector<std::pair<int, std::vector<int>>> symmetry_planes_;  // Axis and faces
 };
 
 // Utility function
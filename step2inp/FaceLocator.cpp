@@ -0,0 +1,258 @@
+#include "FaceLocator.h"
+#include <gmsh.h>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <cmath>
+
+namespace {
+
+// Faces per BVH leaf
+const int kLeafSize = 4;
+
+// Parametric samples (fractions of the bounds) used to test planarity
+const double kSamples[5][2] = {{0.5, 0.5}, {0.1, 0.1}, {0.9, 0.1}, {0.1, 0.9}, {0.9, 0.9}};
+
+double dot(const double* a, const double* b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+bool normalize(std::array<double, 3>& v) {
+    double length = std::sqrt(dot(v.data(), v.data()));
+    if (length <= 0) return false;
+    for (double& c : v) c /= length;
+    return true;
+}
+
+} // namespace
+
+bool FaceSelector::empty() const {
+    return point.empty() && box.empty() && normal.empty() && plane_point.empty() && plane_normal.empty();
+}
+
+bool FaceSelector::isValid() const {
+    return !empty() &&
+           (point.empty() || point.size() == 3) &&
+           (box.empty() || box.size() == 6) &&
+           (normal.empty() || normal.size() == 3) &&
+           plane_point.size() == plane_normal.size() &&
+           (plane_point.empty() || plane_point.size() == 3);
+}
+
+FaceLocator::FaceLocator() {
+}
+
+FaceLocator::~FaceLocator() {
+}
+
+std::size_t FaceLocator::getNumberOfFaces() const {
+    return tags_.size();
+}
+
+int FaceLocator::build() {
+    tags_.clear();
+    bounds_.clear();
+    centers_.clear();
+    normals_.clear();
+    planar_.clear();
+    order_.clear();
+    nodes_.clear();
+
+    try {
+        // Orientation of each face as seen from the volume it bounds
+        std::map<int, int> orientation;
+        std::vector<std::pair<int, int>> volumes;
+        gmsh::model::getEntities(volumes, 3);
+        for (const auto& volume : volumes) {
+            std::vector<std::pair<int, int>> boundary;
+            gmsh::model::getBoundary({volume}, boundary, false, true, false);
+            for (const auto& face : boundary) {
+                orientation.emplace(std::abs(face.second), face.second < 0 ? -1 : 1);
+            }
+        }
+
+        std::vector<std::pair<int, int>> surfaces;
+        gmsh::model::getEntities(surfaces, 2);
+        for (const auto& surface : surfaces) {
+            int tag = surface.second;
+            std::array<double, 6> box;
+            gmsh::model::getBoundingBox(2, tag, box[0], box[1], box[2], box[3], box[4], box[5]);
+
+            std::vector<double> param_min, param_max;
+            gmsh::model::getParametrizationBounds(2, tag, param_min, param_max);
+            std::vector<double> params;
+            for (const auto& sample : kSamples) {
+                params.push_back(param_min[0] + sample[0] * (param_max[0] - param_min[0]));
+                params.push_back(param_min[1] + sample[1] * (param_max[1] - param_min[1]));
+            }
+            std::vector<double> normals, center;
+            gmsh::model::getNormal(tag, params, normals);
+            gmsh::model::getValue(2, tag, {params[0], params[1]}, center);
+
+            auto it = orientation.find(tag);
+            double sign = (it != orientation.end()) ? it->second : 1.0;
+            std::array<double, 3> normal = {sign * normals[0], sign * normals[1], sign * normals[2]};
+            bool planar = normalize(normal);
+            for (std::size_t s = 1; planar && s < normals.size() / 3; ++s) {
+                std::array<double, 3> other = {normals[3 * s], normals[3 * s + 1], normals[3 * s + 2]};
+                planar = normalize(other) && std::abs(dot(normal.data(), other.data())) > 1.0 - 1e-9;
+            }
+
+            tags_.push_back(tag);
+            bounds_.push_back(box);
+            centers_.push_back({center[0], center[1], center[2]});
+            normals_.push_back(normal);
+            planar_.push_back(planar);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "面インデックス作成エラー: " << e.what() << std::endl;
+        return 1;
+    }
+
+    for (std::size_t i = 0; i < tags_.size(); ++i) {
+        order_.push_back(static_cast<int>(i));
+    }
+    if (!tags_.empty()) {
+        nodes_.reserve(2 * tags_.size() / kLeafSize + 1);
+        buildNode(0, static_cast<int>(tags_.size()));
+    }
+    return 0;
+}
+
+int FaceLocator::buildNode(int first, int count) {
+    int index = static_cast<int>(nodes_.size());
+    nodes_.push_back(Node());
+    Node node;
+    node.left = node.right = -1;
+    node.first = first;
+    node.count = count;
+    for (int a = 0; a < 3; ++a) {
+        node.min[a] = bounds_[order_[first]][a];
+        node.max[a] = bounds_[order_[first]][a + 3];
+    }
+    for (int i = first + 1; i < first + count; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            node.min[a] = std::min(node.min[a], bounds_[order_[i]][a]);
+            node.max[a] = std::max(node.max[a], bounds_[order_[i]][a + 3]);
+        }
+    }
+
+    if (count > kLeafSize) {
+        // Median split along the longest axis of the node box
+        int axis = 0;
+        for (int a = 1; a < 3; ++a) {
+            if (node.max[a] - node.min[a] > node.max[axis] - node.min[axis]) axis = a;
+        }
+        int half = count / 2;
+        std::nth_element(order_.begin() + first, order_.begin() + first + half, order_.begin() + first + count,
+                         [this, axis](int a, int b) {
+                             return bounds_[a][axis] + bounds_[a][axis + 3] < bounds_[b][axis] + bounds_[b][axis + 3];
+                         });
+        node.left = buildNode(first, half);
+        node.right = buildNode(first + half, count - half);
+    }
+    nodes_[index] = node;
+    return index;
+}
+
+void FaceLocator::traverse(const std::function<bool(const double* min, const double* max)>& overlaps,
+                           std::vector<int>& candidates) const {
+    if (nodes_.empty()) return;
+    std::vector<int> stack = {0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (!overlaps(node.min, node.max)) continue;
+        if (node.left < 0) {
+            candidates.insert(candidates.end(), order_.begin() + node.first, order_.begin() + node.first + node.count);
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+std::vector<int> FaceLocator::select(const FaceSelector& selector) const {
+    const double tol = selector.tolerance;
+    const double min_cos = std::cos(selector.angle_tolerance * M_PI / 180.0);
+
+    std::array<double, 3> direction = {0.0, 0.0, 0.0};
+    if (!selector.normal.empty()) {
+        direction = {selector.normal[0], selector.normal[1], selector.normal[2]};
+        normalize(direction);
+    }
+    std::array<double, 3> plane_normal = {0.0, 0.0, 0.0};
+    if (!selector.plane_normal.empty()) {
+        plane_normal = {selector.plane_normal[0], selector.plane_normal[1], selector.plane_normal[2]};
+        normalize(plane_normal);
+    }
+    auto planeDistance = [&](const double* p) {
+        return (p[0] - selector.plane_point[0]) * plane_normal[0] +
+               (p[1] - selector.plane_point[1]) * plane_normal[1] +
+               (p[2] - selector.plane_point[2]) * plane_normal[2];
+    };
+
+    // Spatial predicates prune the BVH; the normal alone has to look at every face
+    std::vector<int> candidates;
+    if (!selector.point.empty()) {
+        const double* p = selector.point.data();
+        traverse([p, tol](const double* min, const double* max) {
+            for (int a = 0; a < 3; ++a) {
+                if (p[a] < min[a] - tol || p[a] > max[a] + tol) return false;
+            }
+            return true;
+        }, candidates);
+    } else if (!selector.box.empty()) {
+        const double* b = selector.box.data();
+        traverse([b, tol](const double* min, const double* max) {
+            for (int a = 0; a < 3; ++a) {
+                if (max[a] < b[a] - tol || min[a] > b[a + 3] + tol) return false;
+            }
+            return true;
+        }, candidates);
+    } else if (!selector.plane_point.empty()) {
+        traverse([&planeDistance, tol](const double* min, const double* max) {
+            // The box straddles the plane unless all corners are on one side
+            bool below = false, above = false;
+            for (int corner = 0; corner < 8; ++corner) {
+                double p[3] = {(corner & 1) ? max[0] : min[0], (corner & 2) ? max[1] : min[1], (corner & 4) ? max[2] : min[2]};
+                double d = planeDistance(p);
+                below = below || d <= tol;
+                above = above || d >= -tol;
+            }
+            return below && above;
+        }, candidates);
+    } else {
+        candidates = order_;
+    }
+
+    std::vector<int> matches;
+    for (int face : candidates) {
+        const auto& box = bounds_[face];
+        if (!selector.box.empty()) {
+            bool inside = true;
+            for (int a = 0; a < 3; ++a) {
+                inside = inside && box[a] >= selector.box[a] - tol && box[a + 3] <= selector.box[a + 3] + tol;
+            }
+            if (!inside) continue;
+        }
+        if (!selector.normal.empty()) {
+            if (!planar_[face] || dot(normals_[face].data(), direction.data()) < min_cos) continue;
+        }
+        if (!selector.plane_point.empty()) {
+            if (!planar_[face] || std::abs(dot(normals_[face].data(), plane_normal.data())) < min_cos ||
+                std::abs(planeDistance(centers_[face].data())) > tol) continue;
+        }
+        if (!selector.point.empty()) {
+            // Exact distance to the surface only for faces whose box contains the point
+            std::vector<double> closest, parametric;
+            gmsh::model::getClosestPoint(2, tags_[face], selector.point, closest, parametric);
+            if (closest.size() < 3) continue;
+            double d[3] = {closest[0] - selector.point[0], closest[1] - selector.point[1], closest[2] - selector.point[2]};
+            if (std::sqrt(dot(d, d)) > tol) continue;
+        }
+        matches.push_back(tags_[face]);
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
@@ -0,0 +1,60 @@
+#ifndef FACE_LOCATOR_H
+#define FACE_LOCATOR_H
+
+#include <vector>
+#include <array>
+#include <functional>
+
+// Geometric face predicates; unset (empty) predicates are ignored, set ones must all hold
+struct FaceSelector {
+    std::vector<double> point;         // Face passes within `tolerance` of this point
+    std::vector<double> box;           // Face lies inside {xmin, ymin, zmin, xmax, ymax, zmax}
+    std::vector<double> normal;        // Planar face with outward normal within `angle_tolerance`
+    std::vector<double> plane_point;   // Planar face lying in the plane through plane_point
+    std::vector<double> plane_normal;  // with this normal
+    double tolerance = 1e-6;           // Distance tolerance in model units
+    double angle_tolerance = 1.0;      // Degrees
+
+    bool empty() const;
+    bool isValid() const;
+};
+
+class FaceLocator {
+public:
+    FaceLocator();
+    ~FaceLocator();
+
+    // Index all surfaces of the current gmsh model (geometry only, no mesh needed)
+    int build();
+
+    // Surface tags matching every predicate of the selector, in ascending order
+    std::vector<int> select(const FaceSelector& selector) const;
+
+    std::size_t getNumberOfFaces() const;
+
+private:
+    struct Node {
+        double min[3];
+        double max[3];
+        int left;    // Child node indices; -1 for leaves
+        int right;
+        int first;   // Range of order_ covered by a leaf
+        int count;
+    };
+
+    int buildNode(int first, int count);
+
+    // Candidate faces of all leaves whose boxes pass the test
+    void traverse(const std::function<bool(const double* min, const double* max)>& overlaps,
+                  std::vector<int>& candidates) const;
+
+    std::vector<int> tags_;
+    std::vector<std::array<double, 6>> bounds_;   // xmin, ymin, zmin, xmax, ymax, zmax
+    std::vector<std::array<double, 3>> centers_;  // Point at the parametric center
+    std::vector<std::array<double, 3>> normals_;  // Outward normal at the parametric center
+    std::vector<bool> planar_;
+    std::vector<int> order_;
+    std::vector<Node> nodes_;
+};
+
+#endif // FACE_LOCATOR_H
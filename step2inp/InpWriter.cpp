@@ -1,7 +1,110 @@
 #include "InpWriter.h"
+#include "MaterialSetter.h"
 #include <gmsh.h>
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+#include "logging/Logger.h"
+
+namespace {
+
+// CalculiX shell element of a gmsh surface element type; nullptr if there is none
+const char* shellElementName(int gmsh_type) {
+    switch (gmsh_type) {
+        case 2: return "S3";   // 3-node triangle
+        case 9: return "S6";   // 6-node triangle
+        case 3: return "S4";   // 4-node quadrangle
+        case 16: return "S8";  // 8-node quadrangle
+        default: return nullptr;
+    }
+}
+
+// Layout of the mesh files; bump when their content changes for the same mesh
+const char* kMeshIncludeFormat = "strecsfem-mesh 1";
+
+const char* kIncludeCard = "*INCLUDE, INPUT=";
+
+// Mesh file named by the *INCLUDE card of a deck; empty if there is none
+std::string includedMeshFile(const std::filesystem::path& deck) {
+    std::ifstream f(deck);
+    std::string line;
+    std::size_t length = std::strlen(kIncludeCard);
+    while (std::getline(f, line)) {
+        if (line.compare(0, length, kIncludeCard) == 0) return line.substr(length);
+    }
+    return "";
+}
+
+// Remove a mesh file of the deck's directory once no other deck there includes it
+void removeUnusedMeshFile(const std::string& mesh_file, const std::string& deck) {
+    std::filesystem::path mesh_path(mesh_file);
+    std::filesystem::path directory = std::filesystem::path(deck).parent_path();
+    if (mesh_path.parent_path() != directory || mesh_path.filename().string().compare(0, 5, "mesh_") != 0) {
+        return;  // Not a mesh file written for this deck
+    }
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory.empty() ? "." : directory, ec)) {
+        const std::filesystem::path& other = entry.path();
+        if (other.extension() != ".inp" || other.filename() == std::filesystem::path(deck).filename() ||
+            other.filename().string().compare(0, 5, "mesh_") == 0) {
+            continue;
+        }
+        if (std::filesystem::path(includedMeshFile(other)).filename() == mesh_path.filename()) {
+            return;  // Still shared with another deck
+        }
+    }
+    if (!ec && std::filesystem::remove(mesh_file, ec)) {
+        LOG_INFO("使われなくなったメッシュファイルを削除しました: " << mesh_file);
+    }
+}
+
+// 128-bit content hash from two independently mixed 64-bit lanes, fed word by word
+class MeshHash {
+public:
+    void update(const void* data, std::size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (; bytes >= 8; p += 8, bytes -= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p, 8);
+            mix(word);
+        }
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, p, bytes);
+        mix(tail ^ (static_cast<std::uint64_t>(bytes) << 56));
+    }
+
+    template <class T>
+    void update(const std::vector<T>& values) {
+        std::uint64_t size = values.size();
+        update(&size, sizeof(size));
+        update(values.data(), values.size() * sizeof(T));
+    }
+
+    std::string hex() const {
+        std::ostringstream out;
+        out << std::hex << std::setfill('0') << std::setw(16) << a_ << std::setw(16) << b_;
+        return out.str();
+    }
+
+private:
+    void mix(std::uint64_t word) {
+        a_ = (a_ ^ word) * 1099511628211ull;  // FNV-1a
+        b_ = (b_ ^ word) * 0xff51afd7ed558ccdull;
+        b_ ^= b_ >> 29;
+    }
+
+    std::uint64_t a_ = 14695981039346656037ull;
+    std::uint64_t b_ = 0x9e3779b97f4a7c15ull;
+};
+
+} // namespace
 
 InpWriter::InpWriter() {
 }
@@ -17,9 +120,16 @@ std::string InpWriter::getBaseFilename(const std::string& filename) {
     return path.stem().string();
 }
 
+void InpWriter::setShellSurfaces(const std::vector<int>& surfaces) {
+    shell_surfaces_ = surfaces;
+}
+
 int InpWriter::initializeInpFile(const std::string& step_file, const std::string& inp_file) {
     try {
-        std::cout << "INPファイルを出力中: " << inp_file << std::endl;
+        LOG_INFO("INPファイルを出力中: " << inp_file);
+        if (!shell_surfaces_.empty()) {
+            return writeShellMesh(inp_file);
+        }
         gmsh::write(inp_file);
         return 0;
     } catch (const std::exception& e) {
@@ -28,6 +138,158 @@ int InpWriter::initializeInpFile(const std::string& step_file, const std::string
     }
 }
 
+int InpWriter::writeShellMesh(const std::string& inp_file) const {
+    std::ofstream f(inp_file, std::ios::trunc);
+    if (!f.is_open()) {
+        std::cerr << "エラー: ファイルを開けませんでした: " << inp_file << std::endl;
+        return 1;
+    }
+
+    // Nodes of all shell faces, each once, in tag order
+    std::vector<std::pair<std::size_t, std::size_t>> nodes;  // Tag and position in coords
+    std::vector<double> coords;
+    for (int surface : shell_surfaces_) {
+        std::vector<std::size_t> node_tags;
+        std::vector<double> surface_coords, parametric_coords;
+        gmsh::model::mesh::getNodes(node_tags, surface_coords, parametric_coords, 2, surface, true, false);
+        for (std::size_t i = 0; i < node_tags.size(); ++i) {
+            nodes.push_back({node_tags[i], coords.size() / 3});
+            coords.insert(coords.end(), surface_coords.begin() + 3 * i, surface_coords.begin() + 3 * i + 3);
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end(),
+                            [](const auto& a, const auto& b) { return a.first == b.first; }), nodes.end());
+
+    f << "*HEADING\n";
+    f << InpWriter::getBaseFilename(inp_file) << " (shell model)\n";
+    f << "*NODE\n";
+    f << std::setprecision(16);
+    for (const auto& [tag, position] : nodes) {
+        const double* x = &coords[3 * position];
+        f << tag << ", " << x[0] << ", " << x[1] << ", " << x[2] << "\n";
+    }
+
+    // Elements of each face as its own set, so each gets its own section
+    std::size_t num_elements = 0;
+    for (int surface : shell_surfaces_) {
+        std::vector<int> element_types;
+        std::vector<std::vector<std::size_t>> element_tags, node_tags;
+        gmsh::model::mesh::getElements(element_types, element_tags, node_tags, 2, surface);
+        for (std::size_t t = 0; t < element_types.size(); ++t) {
+            const char* name = shellElementName(element_types[t]);
+            if (name == nullptr) {
+                std::cerr << "エラー: Surface " << surface << " にシェル要素にできない要素型 "
+                          << element_types[t] << " があります" << std::endl;
+                return 1;
+            }
+            std::size_t num_nodes = node_tags[t].size() / element_tags[t].size();
+            f << "*ELEMENT, TYPE=" << name << ", ELSET=" << MaterialSetter::getShellElementSetName(surface) << "\n";
+            for (std::size_t e = 0; e < element_tags[t].size(); ++e) {
+                f << element_tags[t][e];
+                for (std::size_t k = 0; k < num_nodes; ++k) {
+                    f << ", " << node_tags[t][e * num_nodes + k];
+                }
+                f << "\n";
+            }
+            num_elements += element_tags[t].size();
+        }
+    }
+    LOG_INFO("シェル要素 " << num_elements << " 個, 節点 " << nodes.size() << " 個を出力しました");
+    return f.good() ? 0 : 1;
+}
+
+std::string InpWriter::computeMeshHash(const std::vector<int>& surfaces) const {
+    MeshHash hash;
+    hash.update(kMeshIncludeFormat, std::strlen(kMeshIncludeFormat));
+    hash.update(shell_surfaces_);
+    hash.update(surfaces);
+
+    std::vector<std::size_t> node_tags;
+    std::vector<double> coords, parametric_coords;
+    gmsh::model::mesh::getNodes(node_tags, coords, parametric_coords, -1, -1, false, false);
+    hash.update(node_tags);
+    hash.update(coords);
+
+    // Elements per entity: the export groups them into one element set per entity
+    gmsh::vectorpair entities;
+    gmsh::model::getEntities(entities);
+    for (const auto& [dim, tag] : entities) {
+        std::vector<int> element_types;
+        std::vector<std::vector<std::size_t>> element_tags, element_nodes;
+        gmsh::model::mesh::getElements(element_types, element_tags, element_nodes, dim, tag);
+        int entity[2] = {dim, tag};
+        hash.update(entity, sizeof(entity));
+        hash.update(element_types);
+        for (std::size_t t = 0; t < element_types.size(); ++t) {
+            hash.update(element_tags[t]);
+            hash.update(element_nodes[t]);
+        }
+    }
+    return hash.hex();
+}
+
+int InpWriter::writeMeshInclude(const std::string& inp_file, const std::vector<int>& surfaces) {
+    std::filesystem::path directory = std::filesystem::path(inp_file).parent_path();
+    std::string name = "mesh_" + computeMeshHash(surfaces);
+    mesh_file_ = (directory / (name + ".inp")).string();
+
+    // The mesh the deck included before goes with it, unless another deck shares it
+    std::string previous_file = includedMeshFile(inp_file);
+    if (!previous_file.empty() && previous_file != mesh_file_) {
+        removeUnusedMeshFile(previous_file, inp_file);
+    }
+
+    std::error_code ec;
+    if (std::filesystem::exists(mesh_file_, ec)) {
+        LOG_INFO("メッシュファイルを再利用します: " << mesh_file_);
+        return 0;
+    }
+
+    // Written under a private name and renamed, so that a concurrent job never
+    // includes a partial file; gmsh picks the format from the .inp extension
+    std::string partial_file = (directory / (name + "." + std::to_string(getpid()) + ".inp")).string();
+    if (initializeInpFile("", partial_file) != 0) {
+        std::filesystem::remove(partial_file, ec);
+        return 1;
+    }
+    {
+        std::ofstream f(partial_file, std::ios::app);
+        if (!f.is_open()) {
+            std::cerr << "エラー: ファイルを開けませんでした: " << partial_file << std::endl;
+            return 1;
+        }
+        for (int surface : surfaces) {
+            writeSurfaceNodeSet(f, surface);
+        }
+        if (!f.good()) {
+            std::cerr << "エラー: メッシュファイルを書き込めませんでした: " << partial_file << std::endl;
+            std::filesystem::remove(partial_file, ec);
+            return 1;
+        }
+    }
+    std::filesystem::rename(partial_file, mesh_file_, ec);
+    if (ec) {
+        std::cerr << "エラー: メッシュファイルを作成できませんでした: " << mesh_file_ << " (" << ec.message() << ")" << std::endl;
+        std::filesystem::remove(partial_file, ec);
+        return 1;
+    }
+    return 0;
+}
+
+const std::string& InpWriter::getMeshFile() const {
+    return mesh_file_;
+}
+
+void InpWriter::writeInclude(std::ofstream& f) const {
+    f << "** mesh and surface node sets, shared by the decks of the same mesh\n";
+    f << kIncludeCard << mesh_file_ << "\n";
+}
+
+std::string InpWriter::getSurfaceNodeSetName(int surface_number) {
+    return "Surface" + std::to_string(surface_number);
+}
+
 bool InpWriter::openForAppend(const std::string& inp_file) {
     file_.open(inp_file, std::ios::app);
     if (!file_.is_open()) {
@@ -43,6 +305,27 @@ void InpWriter::close() {
     }
 }
 
+bool InpWriter::hasSurfaceNodes(int surface_number) {
+    std::vector<std::size_t> node_tags;
+    std::vector<double> coord, parametricCoord;
+    gmsh::model::mesh::getNodes(node_tags, coord, parametricCoord, 2, surface_number, true, false);
+    return !node_tags.empty();
+}
+
+void InpWriter::writeSurfaceNodeSet(std::ofstream& f, int surface_number) const {
+    std::vector<std::size_t> node_tags;
+    std::vector<double> coord, parametricCoord;
+    gmsh::model::mesh::getNodes(node_tags, coord, parametricCoord, 2, surface_number, true, false);
+    if (node_tags.empty()) return;  // Faces without a mesh, such as the solid faces of a shell model
+
+    f << "***********************************************************\n";
+    f << "** surface node set (used by boundary conditions and result queries)\n";
+    f << "*NSET,NSET=" << getSurfaceNodeSetName(surface_number) << "\n";
+    for (std::size_t tag : node_tags) {
+        f << tag << ",\n";
+    }
+}
+
 void InpWriter::writeStep(std::ofstream& f) const {
     f << "***********************************************************\n";
     f << "** At least one step is needed to run an CalculiX analysis of FreeCAD\n";
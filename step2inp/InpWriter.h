@@ -3,6 +3,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 
 class InpWriter {
 public:
@@ -12,12 +13,32 @@ public:
     // Initialize INP file (write initial mesh)
     int initializeInpFile(const std::string& step_file, const std::string& inp_file);
 
+    // Shell model: write the shell elements of these faces, one set each, instead of the gmsh export
+    void setShellSurfaces(const std::vector<int>& surfaces);
+
     // Open file for appending
     bool openForAppend(const std::string& inp_file);
 
     // Close file
     void close();
 
+    // Mesh of the current model and a node set per face, written once to
+    // mesh_<hash>.inp next to inp_file; the hash covers the nodes, the elements
+    // and the faces, so an existing file of the same mesh is reused as it is.
+    // The mesh file inp_file included before is removed when no other deck of
+    // the directory includes it.
+    int writeMeshInclude(const std::string& inp_file, const std::vector<int>& surfaces);
+    const std::string& getMeshFile() const;
+
+    // *INCLUDE card of the mesh file
+    void writeInclude(std::ofstream& f) const;
+
+    // Write a node set named Surface<id> with all nodes of a surface; a face
+    // without mesh nodes gets no set
+    void writeSurfaceNodeSet(std::ofstream& f, int surface_number) const;
+    static bool hasSurfaceNodes(int surface_number);
+    static std::string getSurfaceNodeSetName(int surface_number);
+
     // Write analysis step configuration
     void writeStep(std::ofstream& f) const;
     void writeOutputs(std::ofstream& f) const;
@@ -27,7 +48,13 @@ public:
     static std::string getBaseFilename(const std::string& filename);
 
 private:
+    // *NODE and *ELEMENT blocks of the shell faces
+    int writeShellMesh(const std::string& inp_file) const;
+    std::string computeMeshHash(const std::vector<int>& surfaces) const;
+
     std::ofstream file_;
+    std::vector<int> shell_surfaces_;
+    std::string mesh_file_;
 };
 
 #endif // INP_WRITER_H
@@ -4,8 +4,30 @@
 #include <cmath>
 #include <map>
 #include <iomanip>
+#include <set>
+#include <array>
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+#include "parallel/TaskScheduler.h"
+#include "logging/Logger.h"
+
+namespace {
+
+// Corner nodes of the CalculiX tetrahedron faces S1..S4 and the node opposite each
+const int kTetFaces[4][4] = {{0, 1, 2, 3}, {0, 3, 1, 2}, {1, 3, 2, 0}, {2, 3, 0, 1}};
+
+std::array<std::size_t, 3> sortedCorners(std::size_t a, std::size_t b, std::size_t c) {
+    std::array<std::size_t, 3> key = {a, b, c};
+    std::sort(key.begin(), key.end());
+    return key;
+}
+
+} // namespace
 
-LoadConditionSetter::LoadConditionSetter() {
+LoadConditionSetter::LoadConditionSetter()
+    : unit_load_cases_(false)
+{
 }
 
 LoadConditionSetter::~LoadConditionSetter() {
@@ -84,10 +106,11 @@ double LoadConditionSetter::calculateElementArea(const std::vector<std::vector<d
 
 void LoadConditionSetter::writeForceBoundaryCondition(std::ofstream& f, int surface_number,
                                                       double total_force,
-                                                      const std::vector<double>& force_direction) const {
+                                                      const std::vector<double>& force_direction,
+                                                      bool replace) const {
     f << "***********************************************************\n";
     f << "** constraints force node loads\n";
-    f << "*CLOAD\n";
+    f << (replace ? "*CLOAD, OP=NEW\n" : "*CLOAD\n");
     f << "** ConstraintForce\n";
     f << "** node loads on shape: Part__Feature:Face" << surface_number << "\n";
     f << "** Total force: " << total_force << " N, Direction: ["
@@ -103,9 +126,16 @@ void LoadConditionSetter::writeForceBoundaryCondition(std::ofstream& f, int surf
     std::vector<std::vector<std::size_t>> node_tags;     // 節点番号
     gmsh::model::mesh::getElements(element_types, element_tags, node_tags, 2, surface_number);
 
-    // ステップ2: 全要素をループして面積を計算・分配
-    std::vector<double> element_areas;  // 要素面積の記録用
+    // 面上の節点座標を一括取得 (要素ごとの getElement/getNode 呼び出しを避ける)
+    std::vector<std::size_t> surface_nodes;
+    std::vector<double> surface_coords, surface_params;
+    gmsh::model::mesh::getNodes(surface_nodes, surface_coords, surface_params, 2, surface_number, true, false);
+    std::unordered_map<std::size_t, std::size_t> node_position;
+    for (std::size_t n = 0; n < surface_nodes.size(); ++n) {
+        node_position[surface_nodes[n]] = n;
+    }
 
+    // ステップ2: 全要素をループして面積を計算・分配
     for (size_t i = 0; i < element_types.size(); ++i) {
         int elem_type = element_types[i];
 
@@ -115,44 +145,26 @@ void LoadConditionSetter::writeForceBoundaryCondition(std::ofstream& f, int surf
         std::vector<double> parametric_coords;
         gmsh::model::mesh::getElementProperties(elem_type, element_name, dim, order, num_nodes, parametric_coords, num_primary_nodes);
 
-        // この要素タイプの全要素を処理
-        const auto& current_element_tags = element_tags[i];
-        int num_elements = current_element_tags.size();
-
-        for (int j = 0; j < num_elements; ++j) {
-            std::size_t element_tag = current_element_tags[j];
-
-            // 要素の節点タグを取得
-            std::vector<std::size_t> element_node_tags;
-            int element_type_out, entity_dim, entity_tag;
-            gmsh::model::mesh::getElement(element_tag, element_type_out, element_node_tags, entity_dim, entity_tag);
-
-            // 節点の座標を取得
-            std::vector<std::vector<double>> coords;
-            for (std::size_t node_tag : element_node_tags) {
-                std::vector<double> coord;
-                std::vector<double> parametric_coord;
-                int entity_dim, entity_tag;
-                gmsh::model::mesh::getNode(node_tag, coord, parametric_coord, entity_dim, entity_tag);
-
-                if (coord.size() >= 3) {
-                    coords.push_back({coord[0], coord[1], coord[2]});
-                } else {
-                    coords.push_back(coord);
+        // 要素面積は並列に計算し、合計と分配は要素順に行う (スレッド数で荷重が変わらないように)
+        const std::vector<std::size_t>& type_nodes = node_tags[i];
+        std::size_t num_elements = element_tags[i].size();
+        std::vector<double> element_areas(num_elements);
+        TaskScheduler::instance().parallelFor(0, num_elements, 256, [&](std::size_t first, std::size_t last) {
+            std::vector<std::vector<double>> coords(num_nodes);
+            for (std::size_t e = first; e < last; ++e) {
+                for (int k = 0; k < num_nodes; ++k) {
+                    std::size_t p = node_position.at(type_nodes[e * num_nodes + k]);
+                    coords[k] = {surface_coords[3 * p], surface_coords[3 * p + 1], surface_coords[3 * p + 2]};
                 }
+                element_areas[e] = calculateElementArea(coords);
             }
+        });
 
-            // 要素の面積を計算
-            double element_area = calculateElementArea(coords);
-            total_surface_area += element_area;
-            element_areas.push_back(element_area);  // 面積を記録
-
-            // 要素面積を節点に分配
-            double area_portion = element_area / num_nodes;
-            std::cout << "  各ノードへの面積分配: " << std::fixed << std::setprecision(8) << area_portion << std::endl;
-
-            for (std::size_t node_tag : element_node_tags) {
-                node_areas[node_tag] += area_portion;
+        for (std::size_t e = 0; e < num_elements; ++e) {
+            total_surface_area += element_areas[e];
+            double area_portion = element_areas[e] / num_nodes;
+            for (int k = 0; k < num_nodes; ++k) {
+                node_areas[type_nodes[e * num_nodes + k]] += area_portion;
             }
         }
     }
@@ -175,25 +187,191 @@ void LoadConditionSetter::writeForceBoundaryCondition(std::ofstream& f, int surf
         f << "** Total surface area: " << std::fixed << std::setprecision(6) << total_surface_area << "\n";
         f << "** Pressure: " << std::fixed << std::setprecision(6) << pressure << " N/unit_area\n";
 
-        // 各節点への力を計算・出力
-        for (const auto& [node_tag, node_area] : node_areas) {
-            double force_magnitude = pressure * node_area;
-            std::vector<double> force_vector = {
-                force_magnitude * normalized_direction[0],
-                force_magnitude * normalized_direction[1],
-                force_magnitude * normalized_direction[2]
-            };
-
-            // 各自由度に対する力成分を出力
-            for (int dof = 1; dof <= 3; ++dof) {
-                if (std::abs(force_vector[dof-1]) > 1e-12) {  // 微小な値は無視
-                    f << node_tag << "," << dof << ","
-                      << std::fixed << std::setprecision(6) << force_vector[dof-1] << "\n";
+        // 各節点への力を計算・出力 (行の整形はチャンクごとに並列、書き出しは節点順)
+        std::vector<std::pair<std::size_t, double>> nodes(node_areas.begin(), node_areas.end());
+        const std::size_t chunk_size = 1024;
+        std::vector<std::string> chunks((nodes.size() + chunk_size - 1) / chunk_size);
+        TaskScheduler::instance().parallelFor(0, chunks.size(), 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; ++c) {
+                std::ostringstream out;
+                out << std::fixed << std::setprecision(6);
+                std::size_t end = std::min(nodes.size(), (c + 1) * chunk_size);
+                for (std::size_t n = c * chunk_size; n < end; ++n) {
+                    double force_magnitude = pressure * nodes[n].second;
+
+                    // 各自由度に対する力成分を出力
+                    for (int dof = 1; dof <= 3; ++dof) {
+                        double force = force_magnitude * normalized_direction[dof - 1];
+                        if (std::abs(force) > 1e-12) {  // 微小な値は無視
+                            out << nodes[n].first << "," << dof << "," << force << "\n";
+                            LOG_TRACE("Surface " << surface_number << " node " << nodes[n].first
+                                      << " dof " << dof << ": " << force);
+                        }
+                    }
                 }
+                chunks[c] = out.str();
             }
+        });
+        for (const std::string& chunk : chunks) {
+            f << chunk;
         }
     } else {
-        std::cout << "警告: Surface " << surface_number << " の面積が0です。力の境界条件を適用できません。" << std::endl;
+        LOG_WARNING("警告: Surface " << surface_number << " の面積が0です。力の境界条件を適用できません。");
+    }
+}
+
+std::string LoadConditionSetter::getLoadSurfaceName(int surface_number) {
+    return "LoadFace" + std::to_string(surface_number);
+}
+
+int LoadConditionSetter::writeLoadSurface(std::ofstream& f, int surface_number) {
+    LoadSurface surface;
+
+    // Corner triples of the surface triangles (linear and quadratic)
+    std::vector<int> element_types;
+    std::vector<std::vector<std::size_t>> element_tags, node_tags;
+    gmsh::model::mesh::getElements(element_types, element_tags, node_tags, 2, surface_number);
+    std::set<std::array<std::size_t, 3>> triangles;
+    for (std::size_t t = 0; t < element_types.size(); ++t) {
+        std::string name;
+        int dim, order, num_nodes, num_primary_nodes;
+        std::vector<double> local_coords;
+        gmsh::model::mesh::getElementProperties(element_types[t], name, dim, order, num_nodes,
+                                                local_coords, num_primary_nodes);
+        if (num_primary_nodes != 3) continue;
+        for (std::size_t e = 0; e + num_nodes <= node_tags[t].size(); e += num_nodes) {
+            triangles.insert(sortedCorners(node_tags[t][e], node_tags[t][e + 1], node_tags[t][e + 2]));
+        }
+    }
+
+    // Coordinates of every node on the surface
+    std::vector<std::size_t> surface_nodes;
+    std::vector<double> coords, parametric_coords;
+    gmsh::model::mesh::getNodes(surface_nodes, coords, parametric_coords, 2, surface_number, true, false);
+    std::map<std::size_t, const double*> position;
+    for (std::size_t i = 0; i < surface_nodes.size(); ++i) {
+        position[surface_nodes[i]] = &coords[3 * i];
+    }
+
+    // Find the tetrahedron face behind each triangle; on an interface the first body wins
+    std::vector<int> volume_types;
+    std::vector<std::vector<std::size_t>> volume_tags, volume_nodes;
+    gmsh::model::mesh::getElements(volume_types, volume_tags, volume_nodes, 3, -1);
+    for (std::size_t t = 0; t < volume_types.size() && !triangles.empty(); ++t) {
+        std::string name;
+        int dim, order, num_nodes, num_primary_nodes;
+        std::vector<double> local_coords;
+        gmsh::model::mesh::getElementProperties(volume_types[t], name, dim, order, num_nodes,
+                                                local_coords, num_primary_nodes);
+        if (num_primary_nodes != 4) continue;
+
+        for (std::size_t e = 0; e < volume_tags[t].size(); ++e) {
+            const std::size_t* corners = &volume_nodes[t][e * num_nodes];
+            for (int face = 0; face < 4; ++face) {
+                const int* local = kTetFaces[face];
+                auto it = triangles.find(sortedCorners(corners[local[0]], corners[local[1]], corners[local[2]]));
+                if (it == triangles.end()) continue;
+                triangles.erase(it);
+                surface.faces.push_back({volume_tags[t][e], face + 1});
+
+                // Triangle normal, turned away from the opposite corner
+                const double* p0 = position[corners[local[0]]];
+                const double* p1 = position[corners[local[1]]];
+                const double* p2 = position[corners[local[2]]];
+                std::vector<double> opposite, parametric;
+                int entity_dim, entity_tag;
+                gmsh::model::mesh::getNode(corners[local[3]], opposite, parametric, entity_dim, entity_tag);
+                double u[3], v[3], w[3], n[3];
+                for (int a = 0; a < 3; ++a) {
+                    u[a] = p1[a] - p0[a];
+                    v[a] = p2[a] - p0[a];
+                    w[a] = opposite[a] - p0[a];
+                }
+                n[0] = 0.5 * (u[1] * v[2] - u[2] * v[1]);
+                n[1] = 0.5 * (u[2] * v[0] - u[0] * v[2]);
+                n[2] = 0.5 * (u[0] * v[1] - u[1] * v[0]);
+                double sign = (n[0] * w[0] + n[1] * w[1] + n[2] * w[2]) > 0 ? -1.0 : 1.0;
+                surface.area += std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                for (int a = 0; a < 3; ++a) {
+                    surface.normal[a] += sign * n[a];
+                }
+            }
+        }
+    }
+
+    if (surface.faces.empty() || !triangles.empty()) {
+        std::cerr << "エラー: Surface " << surface_number << " の要素面を特定できませんでした ("
+                  << triangles.size() << " 面が未対応)" << std::endl;
+        return 1;
+    }
+
+    // A flat face has |sum of area vectors| == area
+    double length = std::sqrt(surface.normal[0] * surface.normal[0] +
+                              surface.normal[1] * surface.normal[1] +
+                              surface.normal[2] * surface.normal[2]);
+    surface.planar = length > (1.0 - 1e-6) * surface.area;
+    for (double& component : surface.normal) {
+        component /= length > 0 ? length : 1.0;
+    }
+
+    f << "***********************************************************\n";
+    f << "** element face surface on shape: Part__Feature:Face" << surface_number << "\n";
+    f << "*SURFACE, NAME=" << getLoadSurfaceName(surface_number) << ", TYPE=ELEMENT\n";
+    for (const auto& [element, face] : surface.faces) {
+        f << element << ", S" << face << "\n";
+    }
+    LOG_INFO("Surface " << surface_number << ": " << surface.faces.size() << " 要素面を *SURFACE に定義しました"
+             << (surface.planar ? "" : " (曲面)"));
+
+    load_surfaces_[surface_number] = surface;
+    return 0;
+}
+
+void LoadConditionSetter::writePressureLoad(std::ofstream& f, int surface_number,
+                                            double total_force,
+                                            const std::vector<double>& force_direction) const {
+    auto it = load_surfaces_.find(surface_number);
+    if (it == load_surfaces_.end() || !it->second.planar) {
+        // A uniform pressure on a curved face has a different resultant than the requested force
+        LOG_WARNING("警告: Surface " << surface_number << " は平面ではないため節点荷重で与えます");
+        writeForceBoundaryCondition(f, surface_number, total_force, force_direction);
+        return;
+    }
+    const LoadSurface& surface = it->second;
+
+    double norm = std::sqrt(force_direction[0] * force_direction[0] +
+                            force_direction[1] * force_direction[1] +
+                            force_direction[2] * force_direction[2]);
+    double force[3] = {0.0, 0.0, 0.0};
+    for (int a = 0; a < 3 && norm > 0; ++a) {
+        force[a] = total_force * force_direction[a] / norm;
+    }
+
+    // CalculiX pressure pushes against the outward normal: F_n = -p * A
+    double normal_force = force[0] * surface.normal[0] + force[1] * surface.normal[1] + force[2] * surface.normal[2];
+    double pressure = -normal_force / surface.area;
+
+    f << "***********************************************************\n";
+    f << "** distributed load on shape: Part__Feature:Face" << surface_number << "\n";
+    f << "** Total force: " << total_force << " N, Direction: ["
+      << force_direction[0] << ", " << force_direction[1] << ", " << force_direction[2] << "]\n";
+    f << "** Surface area: " << std::fixed << std::setprecision(6) << surface.area
+      << ", normal force: " << normal_force << "\n";
+    f << "*DLOAD\n";
+    f << getLoadSurfaceName(surface_number) << ", P, " << std::scientific << std::setprecision(9) << pressure << "\n";
+    f << std::defaultfloat;
+    LOG_INFO("Surface " << surface_number << " に等分布圧力 " << pressure << " を追加しました");
+
+    // Shear part of the force
+    std::vector<double> tangential = {force[0] - normal_force * surface.normal[0],
+                                      force[1] - normal_force * surface.normal[1],
+                                      force[2] - normal_force * surface.normal[2]};
+    double tangential_force = std::sqrt(tangential[0] * tangential[0] +
+                                        tangential[1] * tangential[1] +
+                                        tangential[2] * tangential[2]);
+    if (tangential_force > 1e-9 * std::abs(total_force)) {
+        LOG_INFO("  面に平行な成分 " << tangential_force << " N は節点荷重で与えます");
+        writeForceBoundaryCondition(f, surface_number, tangential_force, tangential);
     }
 }
 
@@ -201,6 +379,45 @@ const std::vector<LoadCondition>& LoadConditionSetter::getLoads() const {
     return loads_;
 }
 
+void LoadConditionSetter::setUnitLoadCases(bool enabled) {
+    unit_load_cases_ = enabled;
+}
+
+bool LoadConditionSetter::getUnitLoadCases() const {
+    return unit_load_cases_;
+}
+
+std::vector<UnitLoadCase> LoadConditionSetter::createUnitLoadCases(const std::vector<LoadCondition>& loads) {
+    std::set<int> surfaces;
+    for (const auto& load : loads) {
+        surfaces.insert(load.surface_number);
+    }
+
+    std::vector<UnitLoadCase> cases;
+    for (int surface : surfaces) {
+        for (int axis = 0; axis < 3; ++axis) {
+            cases.push_back({static_cast<int>(cases.size()) + 1, surface, axis});
+        }
+    }
+    return cases;
+}
+
+double LoadConditionSetter::getUnitLoadWeight(const UnitLoadCase& unit_case, const std::vector<LoadCondition>& loads) {
+    // The solution is linear in the force vector, so each load contributes
+    // its magnitude times the normalized direction component
+    double weight = 0.0;
+    for (const auto& load : loads) {
+        if (load.surface_number != unit_case.surface_number) continue;
+        double norm = std::sqrt(load.direction[0] * load.direction[0] +
+                                load.direction[1] * load.direction[1] +
+                                load.direction[2] * load.direction[2]);
+        if (norm > 0) {
+            weight += load.magnitude * load.direction[unit_case.axis] / norm;
+        }
+    }
+    return weight;
+}
+
 LoadCondition createLoadCondition(int surface_number, double magnitude,
                                   const std::vector<double>& direction) {
     return {surface_number, magnitude, direction};
@@ -3,11 +3,30 @@
 
 #include <vector>
 #include <fstream>
+#include <string>
+#include <map>
+#include <cstddef>
 
 struct LoadCondition {
     int surface_number;
     double magnitude;
     std::vector<double> direction;
+    bool pressure = false;  // Uniform *DLOAD pressure on an element-face surface instead of nodal *CLOAD
+};
+
+// Volume element faces covering one gmsh surface
+struct LoadSurface {
+    std::vector<std::pair<std::size_t, int>> faces;  // Element tag and CalculiX face number (S1..S4)
+    double area = 0.0;
+    double normal[3] = {0.0, 0.0, 0.0};  // Area-weighted mean outward normal, normalized
+    bool planar = false;
+};
+
+// Unit force along one global axis on one surface, solved as its own *STEP
+struct UnitLoadCase {
+    int step;             // 1-based analysis step in the result file
+    int surface_number;
+    int axis;             // 0 = x, 1 = y, 2 = z
 };
 
 class LoadConditionSetter {
@@ -22,16 +41,40 @@ public:
     // Calculate element area (geometry utility)
     static double calculateElementArea(const std::vector<std::vector<double>>& coords);
 
-    // Write load boundary conditions
+    // Write load boundary conditions; `replace` drops loads of previous steps
     void writeForceBoundaryCondition(std::ofstream& f, int surface_number,
                                      double total_force,
-                                     const std::vector<double>& force_direction) const;
+                                     const std::vector<double>& force_direction,
+                                     bool replace = false) const;
+
+    // Define the faces of the volume elements on a surface as *SURFACE (model data, before *STEP)
+    int writeLoadSurface(std::ofstream& f, int surface_number);
+
+    // Total force as uniform *DLOAD pressure on a surface defined by writeLoadSurface.
+    // The part not normal to the face, or the whole force on a curved face, stays a nodal load.
+    void writePressureLoad(std::ofstream& f, int surface_number,
+                           double total_force,
+                           const std::vector<double>& force_direction) const;
+
+    static std::string getLoadSurfaceName(int surface_number);
 
     // Get all load conditions
     const std::vector<LoadCondition>& getLoads() const;
 
+    // Solve unit x/y/z loads per loaded surface instead of the given loads
+    void setUnitLoadCases(bool enabled);
+    bool getUnitLoadCases() const;
+
+    // One case per loaded surface and axis, numbered in step order
+    static std::vector<UnitLoadCase> createUnitLoadCases(const std::vector<LoadCondition>& loads);
+
+    // Weight of a unit case so that the weighted sum reproduces the given loads
+    static double getUnitLoadWeight(const UnitLoadCase& unit_case, const std::vector<LoadCondition>& loads);
+
 private:
     std::vector<LoadCondition> loads_;
+    bool unit_load_cases_;
+    std::map<int, LoadSurface> load_surfaces_;
 };
 
 // Utility function
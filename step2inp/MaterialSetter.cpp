@@ -1,4 +1,5 @@
 #include "MaterialSetter.h"
+#include <iostream>
 
 MaterialSetter::MaterialSetter()
     : material_{"MaterialSolid", 3640.0, 0.36}  // Default: PLA-Generic
@@ -18,18 +19,96 @@ void MaterialSetter::setMaterial(const MaterialProperties& material) {
     material_ = material;
 }
 
+void MaterialSetter::setVolumes(const std::vector<int>& volume_tags) {
+    volume_tags_ = volume_tags;
+}
+
+void MaterialSetter::setVolumeMaterial(int volume_tag, const MaterialProperties& material) {
+    volume_materials_[volume_tag] = material;
+}
+
+void MaterialSetter::renumberVolumes(const std::map<int, std::vector<int>>& volume_map) {
+    std::map<int, MaterialProperties> renumbered;
+    for (const auto& [volume, material] : volume_materials_) {
+        auto it = volume_map.find(volume);
+        if (it == volume_map.end()) continue;
+        for (int tag : it->second) {
+            renumbered[tag] = material;
+        }
+    }
+    volume_materials_ = renumbered;
+}
+
+void MaterialSetter::setShellSections(const std::vector<ShellSection>& sections) {
+    shell_sections_ = sections;
+}
+
+std::string MaterialSetter::getShellElementSetName(int surface_tag) {
+    return "Shell" + std::to_string(surface_tag);
+}
+
+const MaterialProperties& MaterialSetter::getVolumeMaterial(int volume_tag) const {
+    auto it = volume_materials_.find(volume_tag);
+    return it != volume_materials_.end() ? it->second : material_;
+}
+
+std::map<std::string, std::vector<int>> MaterialSetter::getMaterialVolumes() const {
+    std::vector<int> volumes = volume_tags_;
+    if (volumes.empty()) {
+        volumes.push_back(1);  // Single-body model
+    }
+    std::map<std::string, std::vector<int>> material_volumes;
+    for (int volume : volumes) {
+        material_volumes[getVolumeMaterial(volume).name].push_back(volume);
+    }
+    return material_volumes;
+}
+
+int MaterialSetter::checkMaterials() const {
+    for (const auto& [name, volumes] : getMaterialVolumes()) {
+        const MaterialProperties& first = getVolumeMaterial(volumes.front());
+        for (int volume : volumes) {
+            const MaterialProperties& material = getVolumeMaterial(volume);
+            if (material.youngs_modulus != first.youngs_modulus || material.poisson_ratio != first.poisson_ratio) {
+                std::cerr << "エラー: 材料 " << name << " に異なる物性値が指定されています (Volume "
+                          << volumes.front() << ", Volume " << volume << ")" << std::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
 void MaterialSetter::writeEall(std::ofstream& f) const {
     f << "***********************************************************\n";
     f << "** Define element set Eall\n";
     f << "*ELSET, ELSET=Eall\n";
-    f << "volume1\n";
+    if (!shell_sections_.empty()) {
+        for (const ShellSection& section : shell_sections_) {
+            f << getShellElementSetName(section.surface) << "\n";
+        }
+        return;
+    }
+    for (const auto& [name, volumes] : getMaterialVolumes()) {
+        for (int volume : volumes) {
+            f << "volume" << volume << "\n";
+        }
+    }
 }
 
 void MaterialSetter::writeMaterialElementSet(std::ofstream& f) const {
     f << "***********************************************************\n";
     f << "** Element sets for materials and FEM element type (solid, shell, beam, fluid)\n";
-    f << "*ELSET, ELSET=MaterialSolidSolid\n";
-    f << "volume1\n";
+    if (!shell_sections_.empty()) {
+        f << "** shell element sets are defined with the mesh, one section each\n";
+        return;
+    }
+    for (const auto& [name, volumes] : getMaterialVolumes()) {
+        f << "*ELSET, ELSET=" << name << "Solid\n";
+        for (int volume : volumes) {
+            f << "volume" << volume << "\n";
+        }
+    }
 }
 
 void MaterialSetter::writePhysicalConstants(std::ofstream& f) const {
@@ -41,17 +120,30 @@ void MaterialSetter::writeMaterial(std::ofstream& f) const {
     f << "***********************************************************\n";
     f << "** Materials\n";
     f << "** see information about units at file end\n";
-    f << "** FreeCAD material name: " << material_.name << "\n";
-    f << "** " << material_.name << "\n";
-    f << "*MATERIAL, NAME=" << material_.name << "\n";
-    f << "*ELASTIC\n";
-    f << material_.youngs_modulus << "," << material_.poisson_ratio << "\n";
+    for (const auto& [name, volumes] : getMaterialVolumes()) {
+        const MaterialProperties& material = getVolumeMaterial(volumes.front());
+        f << "** FreeCAD material name: " << material.name << "\n";
+        f << "** " << material.name << "\n";
+        f << "*MATERIAL, NAME=" << material.name << "\n";
+        f << "*ELASTIC\n";
+        f << material.youngs_modulus << "," << material.poisson_ratio << "\n";
+    }
 }
 
 void MaterialSetter::writeSections(std::ofstream& f) const {
     f << "***********************************************************\n";
     f << "** Sections\n";
-    f << "*SOLID SECTION, ELSET=MaterialSolidSolid, MATERIAL=" << material_.name << "\n";
+    if (!shell_sections_.empty()) {
+        for (const ShellSection& section : shell_sections_) {
+            f << "*SHELL SECTION, ELSET=" << getShellElementSetName(section.surface)
+              << ", MATERIAL=" << getVolumeMaterial(section.volume).name << ", OFFSET=" << section.offset << "\n";
+            f << section.thickness << "\n";
+        }
+        return;
+    }
+    for (const auto& [name, volumes] : getMaterialVolumes()) {
+        f << "*SOLID SECTION, ELSET=" << name << "Solid, MATERIAL=" << name << "\n";
+    }
 }
 
 const MaterialProperties& MaterialSetter::getMaterial() const {
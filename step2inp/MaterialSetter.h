@@ -3,6 +3,8 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
+#include <map>
 
 struct MaterialProperties {
     std::string name;
@@ -10,6 +12,15 @@ struct MaterialProperties {
     double poisson_ratio;
 };
 
+// Shell elements meshed on one face of a body; the nodes lie on that face,
+// and the offset (in thicknesses) moves the mid-surface into the body
+struct ShellSection {
+    int surface;
+    int volume;
+    double thickness;
+    double offset;
+};
+
 class MaterialSetter {
 public:
     MaterialSetter();
@@ -19,6 +30,19 @@ public:
     void setMaterial(const std::string& name, double youngs_modulus, double poisson_ratio);
     void setMaterial(const MaterialProperties& material);
 
+    // Volumes of the meshed model; each is the gmsh element set Volume<tag>
+    void setVolumes(const std::vector<int>& volume_tags);
+
+    // Material of one body; other volumes use the default material
+    void setVolumeMaterial(int volume_tag, const MaterialProperties& material);
+
+    // Move body materials to the volumes the bodies were cut into
+    void renumberVolumes(const std::map<int, std::vector<int>>& volume_map);
+
+    // Shell model: one element set Shell<surface> per section instead of the volumes
+    void setShellSections(const std::vector<ShellSection>& sections);
+    static std::string getShellElementSetName(int surface_tag);
+
     // Write material-related sections to file
     void writeEall(std::ofstream& f) const;
     void writeMaterialElementSet(std::ofstream& f) const;
@@ -26,11 +50,22 @@ public:
     void writeMaterial(std::ofstream& f) const;
     void writeSections(std::ofstream& f) const;
 
+    // Bodies are grouped into one *MATERIAL per name; 1 if two bodies give
+    // different properties under the same name
+    int checkMaterials() const;
+
     // Get material properties
     const MaterialProperties& getMaterial() const;
+    const MaterialProperties& getVolumeMaterial(int volume_tag) const;
 
 private:
+    // Volumes grouped by material name, in name order
+    std::map<std::string, std::vector<int>> getMaterialVolumes() const;
+
     MaterialProperties material_;
+    std::vector<int> volume_tags_;
+    std::map<int, MaterialProperties> volume_materials_;
+    std::vector<ShellSection> shell_sections_;
 };
 
 #endif // MATERIAL_SETTER_H
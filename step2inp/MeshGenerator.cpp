@@ -1,13 +1,90 @@
 #include "MeshGenerator.h"
 #include <gmsh.h>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <algorithm>
+#include <filesystem>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cerrno>
+#include <set>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "logging/Logger.h"
+
+namespace {
+
+// Interior nodes and 3D elements of one volume, as produced by a worker
+struct VolumeMesh {
+    std::vector<std::size_t> node_tags;
+    std::vector<double> coords;
+    std::vector<int> element_types;
+    std::vector<std::vector<std::size_t>> element_node_tags;
+};
+
+template <class T>
+void writeVector(std::ofstream& f, const std::vector<T>& values) {
+    std::uint64_t size = values.size();
+    f.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    f.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+template <class T>
+bool readVector(std::ifstream& f, std::vector<T>& values) {
+    std::uint64_t size = 0;
+    if (!f.read(reinterpret_cast<char*>(&size), sizeof(size))) return false;
+    values.resize(static_cast<std::size_t>(size));
+    return static_cast<bool>(f.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T))));
+}
+
+int writeVolumeMesh(const std::string& filename, int volume) {
+    VolumeMesh mesh;
+    std::vector<double> parametric_coords;
+    gmsh::model::mesh::getNodes(mesh.node_tags, mesh.coords, parametric_coords, 3, volume, false, false);
+    std::vector<std::vector<std::size_t>> element_tags;
+    gmsh::model::mesh::getElements(mesh.element_types, element_tags, mesh.element_node_tags, 3, volume);
+
+    std::ofstream f(filename, std::ios::binary | std::ios::trunc);
+    writeVector(f, mesh.node_tags);
+    writeVector(f, mesh.coords);
+    writeVector(f, mesh.element_types);
+    for (const auto& node_tags : mesh.element_node_tags) {
+        writeVector(f, node_tags);
+    }
+    return f.good() ? 0 : 1;
+}
+
+bool readVolumeMesh(const std::string& filename, VolumeMesh& mesh) {
+    std::ifstream f(filename, std::ios::binary);
+    if (!readVector(f, mesh.node_tags) || !readVector(f, mesh.coords) || !readVector(f, mesh.element_types)) {
+        return false;
+    }
+    mesh.element_node_tags.resize(mesh.element_types.size());
+    for (auto& node_tags : mesh.element_node_tags) {
+        if (!readVector(f, node_tags)) return false;
+    }
+    return true;
+}
+
+} // namespace
 
 MeshGenerator::MeshGenerator()
     : char_length_min_(1.0)
     , char_length_max_(5.0)
     , mesh_algorithm_(1)  
     , mesh_order_(2)
+    , workers_(0)
+    , curvature_points_(0)
+    , shell_thickness_(0.0)
+    , shell_quads_(false)
+    , memory_budget_mb_(0.0)
+    , time_budget_seconds_(0.0)
+    , plan_only_(false)
 {
 }
 
@@ -27,10 +104,72 @@ void MeshGenerator::setMeshOrder(int order) {
     mesh_order_ = order;
 }
 
+void MeshGenerator::setWorkers(int workers) {
+    workers_ = workers;
+}
+
+void MeshGenerator::addRefinement(const std::vector<int>& surfaces, double size,
+                                  double distance_min, double distance_max) {
+    if (surfaces.empty() || size <= 0.0) return;
+    RefinementRegion region;
+    region.surfaces = surfaces;
+    std::sort(region.surfaces.begin(), region.surfaces.end());
+    region.surfaces.erase(std::unique(region.surfaces.begin(), region.surfaces.end()), region.surfaces.end());
+    region.size = size;
+    region.distance_min = distance_min;
+    region.distance_max = distance_max > distance_min ? distance_max : distance_min + 10.0 * size;
+    refinements_.push_back(region);
+}
+
+void MeshGenerator::clearRefinements() {
+    refinements_.clear();
+}
+
+void MeshGenerator::setCurvatureRefinement(int points_per_circle) {
+    curvature_points_ = points_per_circle;
+}
+
+void MeshGenerator::setShellSurfaces(const std::vector<int>& surfaces, double thickness, bool quads) {
+    shell_surfaces_ = surfaces;
+    std::sort(shell_surfaces_.begin(), shell_surfaces_.end());
+    shell_surfaces_.erase(std::unique(shell_surfaces_.begin(), shell_surfaces_.end()), shell_surfaces_.end());
+    shell_thickness_ = thickness;
+    shell_quads_ = quads;
+}
+
+bool MeshGenerator::isShellModel() const {
+    return !shell_surfaces_.empty();
+}
+
+const std::vector<ShellSection>& MeshGenerator::getShellSections() const {
+    return shell_sections_;
+}
+
+void MeshGenerator::setResourceBudget(double memory_mb, double time_seconds) {
+    memory_budget_mb_ = memory_mb;
+    time_budget_seconds_ = time_seconds;
+}
+
+void MeshGenerator::setPlanOnly(bool plan_only) {
+    plan_only_ = plan_only;
+}
+
+const ResourceEstimate& MeshGenerator::getResourceEstimate() const {
+    return estimate_;
+}
+
 int MeshGenerator::generateMesh(const std::string& step_file) {
+    if (importGeometry(step_file) != 0) {
+        return 1;
+    }
+    return generateMesh();
+}
+
+int MeshGenerator::importGeometry(const std::string& step_file) {
     try {
-        std::cout << "STEPファイルを読み込み中: " << step_file << std::endl;
-        gmsh::open(step_file);
+        LOG_INFO("STEPファイルを読み込み中: " << step_file);
+        // Merge into the current model so that callers can keep several named models
+        gmsh::merge(step_file);
 
         gmsh::model::geo::synchronize();
 
@@ -43,26 +182,49 @@ int MeshGenerator::generateMesh(const std::string& step_file) {
             return 1;
         }
 
+        // Fragment assemblies so that touching bodies share their interface faces.
+        // This renumbers the faces, so keep where each face of the STEP file went.
+        imported_surfaces_.clear();
+        if (vols.size() > 1) {
+            std::vector<std::pair<int, int>> objects = vols;
+            std::vector<std::pair<int, int>> faces;
+            gmsh::model::getEntities(faces, 2);
+            objects.insert(objects.end(), faces.begin(), faces.end());
+
+            std::vector<std::pair<int, int>> fragments;
+            std::vector<std::vector<std::pair<int, int>>> fragment_map;
+            gmsh::model::occ::fragment(objects, {}, fragments, fragment_map);
+            gmsh::model::occ::synchronize();
+            for (std::size_t i = vols.size(); i < objects.size() && i < fragment_map.size(); ++i) {
+                std::vector<int>& pieces = imported_surfaces_[objects[i].second];
+                for (const auto& piece : fragment_map[i]) {
+                    if (piece.first == 2) pieces.push_back(piece.second);
+                }
+            }
+        }
+
+        return reindexGeometry();
+
+    } catch (const std::exception& e) {
+        std::cerr << "メッシュ生成エラー: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int MeshGenerator::reindexGeometry() {
+    try {
+        std::vector<std::pair<int, int>> vols;
+        gmsh::model::getEntities(vols, 3);
+
         // Add physical group for volumes
         std::vector<int> vol_tags;
         for (const auto& vol : vols) {
             vol_tags.push_back(vol.second);
         }
+        gmsh::model::removePhysicalGroups();
         gmsh::model::addPhysicalGroup(3, vol_tags, -1, "SolidVolume");
-
-        // Set mesh parameters
-        gmsh::option::setNumber("Mesh.CharacteristicLengthMin", char_length_min_);
-        gmsh::option::setNumber("Mesh.CharacteristicLengthMax", char_length_max_);
-        gmsh::option::setNumber("Mesh.HighOrderOptimize", 2);
-
-        // Generate 3D mesh
-        std::cout << "3Dメッシュを生成中..." << std::endl;
-        gmsh::option::setNumber("Mesh.Algorithm3D", mesh_algorithm_);
-        gmsh::model::mesh::generate(3);
-        gmsh::model::mesh::setOrder(mesh_order_);
-        gmsh::model::mesh::optimize("HighOrderElastic");
-
-        gmsh::option::setNumber("Mesh.SaveAll", 0);
+        volume_tags_ = vol_tags;
+        std::sort(volume_tags_.begin(), volume_tags_.end());
 
         // Get surface tags
         std::vector<std::pair<int, int>> surfaces;
@@ -72,10 +234,113 @@ int MeshGenerator::generateMesh(const std::string& step_file) {
         for (const auto& surface : surfaces) {
             surface_tags_.push_back(surface.second);
         }
+        std::sort(surface_tags_.begin(), surface_tags_.end());
+
+        // Index face bounding boxes once for geometric face selection
+        if (face_locator_.build() != 0) {
+            return 1;
+        }
 
-        std::cout << "利用可能な面 (Surface):" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "メッシュ生成エラー: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int MeshGenerator::mapImportedSurface(int surface, int& tag) const {
+    if (imported_surfaces_.empty()) {
+        tag = surface;
+        return 0;
+    }
+    auto it = imported_surfaces_.find(surface);
+    if (it == imported_surfaces_.end() || it->second.empty()) {
+        std::cerr << "エラー: Surface " << surface << " が見つかりません。" << std::endl;
+        return 1;
+    }
+    if (it->second.size() > 1) {
+        std::cerr << "エラー: Surface " << surface << " は接するボディとの境界で分割されました (Surface";
+        for (int piece : it->second) {
+            std::cerr << " " << piece;
+        }
+        std::cerr << ")。select で面を指定してください" << std::endl;
+        return 1;
+    }
+    tag = it->second.front();
+    return 0;
+}
+
+void MeshGenerator::renumberSurfaces(const std::map<int, std::vector<int>>& surface_map) {
+    auto renumber = [&surface_map](std::vector<int>& surfaces) {
+        std::vector<int> renumbered;
+        for (int surface : surfaces) {
+            auto it = surface_map.find(surface);
+            if (it != surface_map.end()) {
+                renumbered.insert(renumbered.end(), it->second.begin(), it->second.end());
+            }
+        }
+        std::sort(renumbered.begin(), renumbered.end());
+        renumbered.erase(std::unique(renumbered.begin(), renumbered.end()), renumbered.end());
+        surfaces = renumbered;
+    };
+    for (RefinementRegion& region : refinements_) {
+        renumber(region.surfaces);
+    }
+    refinements_.erase(std::remove_if(refinements_.begin(), refinements_.end(),
+                                      [](const RefinementRegion& region) { return region.surfaces.empty(); }),
+                       refinements_.end());
+    renumber(shell_surfaces_);
+}
+
+int MeshGenerator::generateMesh() {
+    try {
+        // The model may still hold a mesh generated with other settings
+        gmsh::model::mesh::clear();
+        if (generateLinearMesh(1.0) != 0) {
+            return 1;
+        }
+
+        // Predict the solve from the first-order mesh before elevating its order
+        MeshStatistics statistics;
+        if (ResourceEstimator::collectStatistics(statistics, isShellModel()) != 0) {
+            return 1;
+        }
+        ResourceBudget budget;
+        budget.memory_mb = memory_budget_mb_;
+        budget.time_seconds = time_budget_seconds_;
+        budget.order = mesh_order_;
+        ResourceEstimator estimator;
+        estimate_ = estimator.plan(statistics, budget);
+        ResourceEstimator::print(estimate_);
+        if (plan_only_) {
+            return 0;
+        }
+        if (!estimate_.fits) {
+            std::cerr << "エラー: 最も粗いメッシュでもリソース予算 (" << memory_budget_mb_ << " MB, "
+                      << time_budget_seconds_ << " 秒) に収まりません" << std::endl;
+            return 1;
+        }
+        if (estimate_.size_scale > 1.0) {
+            LOG_INFO("予算に合わせて要素サイズを x" << estimate_.size_scale << " に粗くします");
+            gmsh::model::mesh::clear();
+            if (generateLinearMesh(estimate_.size_scale) != 0) {
+                return 1;
+            }
+        }
+
+        gmsh::model::mesh::setOrder(estimate_.order);
+        gmsh::model::mesh::optimize("HighOrderElastic");
+        if (isShellModel() && computeShellSections() != 0) {
+            return 1;
+        }
+
+        gmsh::option::setNumber("Mesh.SaveAll", 0);
+
+        // One line per face only in verbose output; large assemblies have thousands
+        LOG_INFO("利用可能な面 (Surface): " << surface_tags_.size() << " 面");
         for (int tag : surface_tags_) {
-            std::cout << "  Surface " << tag << std::endl;
+            LOG_DEBUG("  Surface " << tag);
         }
 
         return 0;
@@ -86,10 +351,364 @@ int MeshGenerator::generateMesh(const std::string& step_file) {
     }
 }
 
+int MeshGenerator::generateLinearMesh(double size_scale) {
+    // Set mesh parameters
+    gmsh::option::setNumber("Mesh.CharacteristicLengthMin", char_length_min_ * size_scale);
+    gmsh::option::setNumber("Mesh.CharacteristicLengthMax", char_length_max_ * size_scale);
+    gmsh::option::setNumber("Mesh.HighOrderOptimize", 2);
+    applySizeFields(size_scale);
+
+    // Quadrilateral shells are recombined and elevated to 8-node serendipity elements
+    gmsh::option::setNumber("Mesh.RecombineAll", isShellModel() && shell_quads_ ? 1 : 0);
+    gmsh::option::setNumber("Mesh.SecondOrderIncomplete", isShellModel() && shell_quads_ ? 1 : 0);
+    if (isShellModel()) {
+        LOG_INFO("シェル面のメッシュを生成中 (" << shell_surfaces_.size() << " 面)...");
+        gmsh::model::mesh::generate(2);
+        clearNonShellMesh();
+        return 0;
+    }
+
+    // Generate 3D mesh
+    LOG_INFO("3Dメッシュを生成中...");
+    gmsh::option::setNumber("Mesh.Algorithm3D", mesh_algorithm_);
+    if (volume_tags_.size() > 1) {
+        return generateVolumesInParallel();
+    }
+    gmsh::model::mesh::generate(3);
+    return 0;
+}
+
+void MeshGenerator::applySizeFields(double size_scale) {
+    // Fields of an earlier pass, or of an earlier job on a cached model, are replaced
+    for (int field : size_fields_) {
+        gmsh::model::mesh::field::remove(field);
+    }
+    size_fields_.clear();
+
+    // Curvature sizing is applied by gmsh on top of the background field, taking the minimum
+    gmsh::option::setNumber("Mesh.MeshSizeFromCurvature", curvature_points_);
+    if (refinements_.empty()) {
+        gmsh::option::setNumber("Mesh.MeshSizeExtendFromBoundary", 1);
+        return;
+    }
+
+    // One Distance/Threshold pair per region, combined by a Min field
+    double size_min = char_length_min_;
+    std::vector<double> thresholds;
+    for (const RefinementRegion& region : refinements_) {
+        int distance = gmsh::model::mesh::field::add("Distance");
+        gmsh::model::mesh::field::setNumbers(distance, "SurfacesList",
+                                             std::vector<double>(region.surfaces.begin(), region.surfaces.end()));
+        gmsh::model::mesh::field::setNumber(distance, "Sampling", 100);
+
+        int threshold = gmsh::model::mesh::field::add("Threshold");
+        gmsh::model::mesh::field::setNumber(threshold, "InField", distance);
+        gmsh::model::mesh::field::setNumber(threshold, "SizeMin", region.size * size_scale);
+        gmsh::model::mesh::field::setNumber(threshold, "SizeMax", char_length_max_ * size_scale);
+        gmsh::model::mesh::field::setNumber(threshold, "DistMin", region.distance_min * size_scale);
+        gmsh::model::mesh::field::setNumber(threshold, "DistMax", region.distance_max * size_scale);
+
+        size_fields_.push_back(distance);
+        size_fields_.push_back(threshold);
+        thresholds.push_back(threshold);
+        size_min = std::min(size_min, region.size);
+        LOG_INFO(region.surfaces.size() << " 面の周囲を要素サイズ " << region.size * size_scale
+                 << " で細分化します");
+    }
+    int minimum = gmsh::model::mesh::field::add("Min");
+    gmsh::model::mesh::field::setNumbers(minimum, "FieldsList", thresholds);
+    gmsh::model::mesh::field::setAsBackgroundMesh(minimum);
+    size_fields_.push_back(minimum);
+
+    // Sizes then come from the fields, not from the boundary mesh spreading inwards,
+    // and the global minimum must not clip the refined size
+    gmsh::option::setNumber("Mesh.MeshSizeExtendFromBoundary", 0);
+    gmsh::option::setNumber("Mesh.CharacteristicLengthMin", size_min * size_scale);
+}
+
+void MeshGenerator::clearNonShellMesh() {
+    std::vector<std::pair<int, int>> shells;
+    for (int surface : shell_surfaces_) {
+        shells.push_back({2, surface});
+    }
+    std::vector<std::pair<int, int>> curves, points;
+    gmsh::model::getBoundary(shells, curves, false, false, false);
+    gmsh::model::getBoundary(curves, points, false, false, false);
+    std::set<std::pair<int, int>> keep(shells.begin(), shells.end());
+    for (const auto& entity : curves) {
+        keep.insert({entity.first, std::abs(entity.second)});
+    }
+    for (const auto& entity : points) {
+        keep.insert({entity.first, std::abs(entity.second)});
+    }
+
+    std::vector<std::pair<int, int>> entities, cleared;
+    gmsh::model::getEntities(entities, -1);
+    for (const auto& entity : entities) {
+        if (entity.first < 3 && keep.count(entity) == 0) cleared.push_back(entity);
+    }
+    if (!cleared.empty()) {
+        gmsh::model::mesh::clear(cleared);
+    }
+}
+
+int MeshGenerator::computeShellSections() {
+    shell_sections_.clear();
+    for (int surface : shell_surfaces_) {
+        std::vector<int> upward, downward;
+        gmsh::model::getAdjacencies(2, surface, upward, downward);
+        if (upward.empty()) {
+            std::cerr << "エラー: Surface " << surface << " はボリュームの面ではありません" << std::endl;
+            return 1;
+        }
+        int volume = upward.front();
+
+        // Centre and normal of the first element, as CalculiX orients the shell
+        std::vector<int> element_types;
+        std::vector<std::vector<std::size_t>> element_tags, node_tags;
+        gmsh::model::mesh::getElements(element_types, element_tags, node_tags, 2, surface);
+        if (element_types.empty() || node_tags.front().size() < 3) {
+            std::cerr << "エラー: Surface " << surface << " にシェル要素がありません" << std::endl;
+            return 1;
+        }
+        double corners[3][3];
+        for (int k = 0; k < 3; ++k) {
+            std::vector<double> coord, parametric_coord;
+            int entity_dim, entity_tag;
+            gmsh::model::mesh::getNode(node_tags.front()[k], coord, parametric_coord, entity_dim, entity_tag);
+            for (int a = 0; a < 3; ++a) corners[k][a] = coord[a];
+        }
+        double centre[3], u[3], v[3];
+        for (int a = 0; a < 3; ++a) {
+            centre[a] = (corners[0][a] + corners[1][a] + corners[2][a]) / 3.0;
+            u[a] = corners[1][a] - corners[0][a];
+            v[a] = corners[2][a] - corners[0][a];
+        }
+        double normal[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+        double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        for (double& component : normal) component /= length > 0 ? length : 1.0;
+
+        ShellSection section;
+        section.surface = surface;
+        section.volume = volume;
+        section.thickness = shell_thickness_ > 0 ? shell_thickness_ : measureThickness(surface, volume, centre, normal);
+        if (section.thickness <= 0) {
+            std::cerr << "エラー: Surface " << surface << " の板厚を測定できません。thickness を指定してください" << std::endl;
+            return 1;
+        }
+
+        // The body lies on one side of the face; shift the mid-surface into it
+        // (OFFSET=0.5 makes the nodes the top surface, on the positive normal side)
+        std::vector<double> ahead(3), behind(3);
+        for (int a = 0; a < 3; ++a) {
+            ahead[a] = centre[a] + 0.25 * section.thickness * normal[a];
+            behind[a] = centre[a] - 0.25 * section.thickness * normal[a];
+        }
+        bool inside_ahead = gmsh::model::isInside(3, volume, ahead) != 0;
+        bool inside_behind = gmsh::model::isInside(3, volume, behind) != 0;
+        if (inside_behind && !inside_ahead) {
+            section.offset = 0.5;
+        } else if (inside_ahead && !inside_behind) {
+            section.offset = -0.5;
+        } else {
+            std::cerr << "警告: Surface " << surface << " の板の向きを判定できないため面を中立面とみなします" << std::endl;
+            section.offset = 0.0;
+        }
+        shell_sections_.push_back(section);
+        LOG_INFO("Surface " << surface << ": シェル要素 板厚 " << section.thickness
+                 << (shell_thickness_ > 0 ? "" : " (測定)") << ", OFFSET " << section.offset);
+    }
+    return 0;
+}
+
+double MeshGenerator::measureThickness(int surface, int volume, const double point[3], const double normal[3]) const {
+    // Closest points on the other faces of the body that lie straight along the normal
+    std::vector<int> upward, faces;
+    gmsh::model::getAdjacencies(3, volume, upward, faces);
+    double thickness = 0.0;
+    for (int face : faces) {
+        if (face == surface) continue;
+        std::vector<double> closest, parametric_coord;
+        gmsh::model::getClosestPoint(2, face, {point[0], point[1], point[2]}, closest, parametric_coord);
+        double d[3] = {closest[0] - point[0], closest[1] - point[1], closest[2] - point[2]};
+        double distance = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        double along = std::abs(d[0] * normal[0] + d[1] * normal[1] + d[2] * normal[2]);
+        if (distance <= 0 || along < 0.95 * distance) continue;
+        thickness = thickness > 0 ? std::min(thickness, distance) : distance;
+    }
+    return thickness;
+}
+
+int MeshGenerator::generateVolumesInParallel() {
+    // The shared surface mesh is generated once here, so every interface is
+    // conforming; only the volume interiors are meshed by the workers
+    gmsh::model::mesh::generate(2);
+
+    int workers = workers_ > 0 ? workers_ : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string prefix = (std::filesystem::temp_directory_path() /
+                          ("strecsfem_" + std::to_string(getpid()) + "_volume")).string();
+    LOG_INFO(volume_tags_.size() << " ボリュームを " << workers << " ワーカーで並列にメッシュ生成します");
+
+    std::map<pid_t, int> running;  // worker pid -> volume
+    std::size_t next = 0;
+    bool failed = false;
+    while (next < volume_tags_.size() || !running.empty()) {
+        while (!failed && next < volume_tags_.size() && static_cast<int>(running.size()) < workers) {
+            int volume = volume_tags_[next++];
+            // The worker has no logging thread, so nothing may stay queued across fork()
+            Logger::instance().flush();
+            std::cout.flush();
+            std::cerr.flush();
+            pid_t pid = fork();
+            if (pid == 0) {
+                // Worker: drop the other volumes from its copy of the model and mesh the rest
+                int status = 1;
+                try {
+                    std::vector<std::pair<int, int>> others;
+                    for (int other : volume_tags_) {
+                        if (other != volume) others.push_back({3, other});
+                    }
+                    gmsh::model::removeEntities(others, false);
+                    gmsh::model::mesh::generate(3);
+                    status = writeVolumeMesh(prefix + std::to_string(volume) + ".bin", volume);
+                } catch (const std::exception& e) {
+                    std::cerr << "Volume " << volume << " のメッシュ生成エラー: " << e.what() << std::endl;
+                }
+                std::cout.flush();
+                std::cerr.flush();
+                _exit(status);
+            }
+            if (pid < 0) {
+                std::cerr << "エラー: メッシュ生成ワーカーを起動できませんでした" << std::endl;
+                failed = true;
+                break;
+            }
+            running[pid] = volume;
+        }
+        if (running.empty()) break;
+
+        // Reap only our own workers; other children of the process (the solver,
+        // other daemon jobs) belong to their owners. Poll them all so a slot
+        // refills as soon as any worker finishes, not just the oldest one.
+        int status = 0;
+        pid_t pid = 0;
+        bool lost = false;
+        for (const auto& worker : running) {
+            pid_t reaped = waitpid(worker.first, &status, WNOHANG);
+            if (reaped == worker.first) {
+                pid = worker.first;
+                break;
+            }
+            if (reaped < 0 && errno != EINTR) {
+                // The worker cannot be waited for any more; count it as failed
+                pid = worker.first;
+                lost = true;
+                break;
+            }
+        }
+        if (pid == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        auto it = running.find(pid);
+        if (it == running.end()) continue;
+        if (lost || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "エラー: Volume " << it->second << " のメッシュ生成に失敗しました" << std::endl;
+            failed = true;
+        } else {
+            LOG_INFO("  Volume " << it->second << " 完了");
+        }
+        running.erase(it);
+    }
+
+    // Merge: interior nodes get fresh tags, interface nodes keep the shared surface tags
+    std::size_t next_node_tag = 0, next_element_tag = 0;
+    gmsh::model::mesh::getMaxNodeTag(next_node_tag);
+    gmsh::model::mesh::getMaxElementTag(next_element_tag);
+    for (int volume : volume_tags_) {
+        std::string filename = prefix + std::to_string(volume) + ".bin";
+        VolumeMesh mesh;
+        if (!failed && !readVolumeMesh(filename, mesh)) {
+            std::cerr << "エラー: Volume " << volume << " のメッシュを読み込めませんでした" << std::endl;
+            failed = true;
+        }
+        std::error_code ec;
+        std::filesystem::remove(filename, ec);
+        if (failed) continue;
+
+        std::map<std::size_t, std::size_t> interior;
+        std::vector<std::size_t> new_tags;
+        for (std::size_t tag : mesh.node_tags) {
+            interior[tag] = ++next_node_tag;
+            new_tags.push_back(next_node_tag);
+        }
+        gmsh::model::mesh::addNodes(3, volume, new_tags, mesh.coords);
+
+        for (std::size_t t = 0; t < mesh.element_types.size(); ++t) {
+            std::vector<std::size_t>& node_tags = mesh.element_node_tags[t];
+            for (std::size_t& tag : node_tags) {
+                auto it = interior.find(tag);
+                if (it != interior.end()) tag = it->second;
+            }
+            std::string name;
+            int dim, order, num_nodes, num_primary_nodes;
+            std::vector<double> local_coords;
+            gmsh::model::mesh::getElementProperties(mesh.element_types[t], name, dim, order, num_nodes,
+                                                    local_coords, num_primary_nodes);
+            std::vector<std::size_t> element_tags(node_tags.size() / num_nodes);
+            for (std::size_t& tag : element_tags) {
+                tag = ++next_element_tag;
+            }
+            gmsh::model::mesh::addElementsByType(volume, mesh.element_types[t], element_tags, node_tags);
+        }
+    }
+    return failed ? 1 : 0;
+}
+
 std::vector<int> MeshGenerator::getSurfaceTags() const {
     return surface_tags_;
 }
 
+std::vector<int> MeshGenerator::getVolumeTags() const {
+    return volume_tags_;
+}
+
 bool MeshGenerator::hasSurface(int surface_number) const {
-    return std::find(surface_tags_.begin(), surface_tags_.end(), surface_number) != surface_tags_.end();
+    return std::binary_search(surface_tags_.begin(), surface_tags_.end(), surface_number);
+}
+
+const FaceLocator& MeshGenerator::getFaceLocator() const {
+    return face_locator_;
+}
+
+void MeshGenerator::adoptGeometry(const MeshGenerator& other) {
+    surface_tags_ = other.surface_tags_;
+    volume_tags_ = other.volume_tags_;
+    face_locator_ = other.face_locator_;
+    imported_surfaces_ = other.imported_surfaces_;
+    size_fields_ = other.size_fields_;
+    shell_sections_ = other.shell_sections_;
+}
+
+std::string MeshGenerator::getSettingsKey() const {
+    std::ostringstream key;
+    key << char_length_min_ << "/" << char_length_max_ << "/" << mesh_algorithm_ << "/" << mesh_order_
+        << "/" << memory_budget_mb_ << "/" << time_budget_seconds_
+        << "/" << curvature_points_;
+    for (const RefinementRegion& region : refinements_) {
+        key << "/" << region.size << ":" << region.distance_min << ":" << region.distance_max << ":";
+        for (int surface : region.surfaces) {
+            key << surface << ",";
+        }
+    }
+    if (isShellModel()) {
+        key << "/shell:" << shell_thickness_ << ":" << shell_quads_ << ":";
+        for (int surface : shell_surfaces_) {
+            key << surface << ",";
+        }
+    }
+    if (plan_only_) {
+        key << "/plan";
+    }
+    return key.str();
 }
@@ -3,6 +3,18 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include "FaceLocator.h"
+#include "ResourceEstimator.h"
+#include "MaterialSetter.h"
+
+// Faces refined to one element size
+struct RefinementRegion {
+    std::vector<int> surfaces;
+    double size;
+    double distance_min;
+    double distance_max;
+};
 
 class MeshGenerator {
 public:
@@ -12,23 +24,110 @@ public:
     // Generate mesh from STEP file
     int generateMesh(const std::string& step_file);
 
-    // Get available surface tags
+    // Import STEP geometry and index its faces, then mesh it separately
+    int importGeometry(const std::string& step_file);
+    int generateMesh();
+
+    // Re-read the bodies and faces after the geometry was modified in place
+    int reindexGeometry();
+
+    // Face of the model that a face of the STEP file became; an error if the
+    // fragmenting of an assembly split it
+    int mapImportedSurface(int surface, int& tag) const;
+
+    // Move refined and shell faces to the faces they were split into
+    void renumberSurfaces(const std::map<int, std::vector<int>>& surface_map);
+
+    // Get available surface and volume tags
     std::vector<int> getSurfaceTags() const;
+    std::vector<int> getVolumeTags() const;
 
     // Check if a surface exists
     bool hasSurface(int surface_number) const;
 
+    // Spatial index over the faces of the imported geometry
+    const FaceLocator& getFaceLocator() const;
+
+    // Take over the model state (surfaces, volumes, face index, size fields,
+    // shell sections) of another generator
+    void adoptGeometry(const MeshGenerator& other);
+
+    // Mesh parameters that determine the generated mesh, as a comparable string
+    std::string getSettingsKey() const;
+
     // Set mesh parameters
     void setCharacteristicLength(double min_length, double max_length);
     void setMeshAlgorithm(int algorithm);
-    void setMeshOrder(int order);
+    void setMeshOrder(int order);  // 0 lets the resource budget choose
+
+    // Local refinement: elements of the given size at the faces, growing back to the
+    // global maximum between distance_min and distance_max (0 picks 10x the size)
+    void addRefinement(const std::vector<int>& surfaces, double size, double distance_min, double distance_max);
+    void clearRefinements();
+
+    // Resolve curved faces with this many elements per full circle; 0 disables it
+    void setCurvatureRefinement(int points_per_circle);
+
+    // Shell model: mesh only these faces of the bodies, with shell elements (S3/S6,
+    // or S4/S8 with quads) instead of tetrahedra. The thickness is measured across
+    // the body at each face when 0.
+    void setShellSurfaces(const std::vector<int>& surfaces, double thickness, bool quads);
+    bool isShellModel() const;
+
+    // Sections of the shell faces of the last generated mesh
+    const std::vector<ShellSection>& getShellSections() const;
+
+    // Coarsen the mesh and choose its order so that the solve fits the budget
+    void setResourceBudget(double memory_mb, double time_seconds);
+
+    // Stop after the first-order mesh and its resource estimate
+    void setPlanOnly(bool plan_only);
+
+    // Estimate of the last generated mesh
+    const ResourceEstimate& getResourceEstimate() const;
+
+    // Worker processes for meshing volumes of an assembly; 0 uses all cores
+    void setWorkers(int workers);
 
 private:
-    std::vector<int> surface_tags_;
+    // First-order volume mesh with the characteristic lengths scaled by size_scale
+    int generateLinearMesh(double size_scale);
+
+    // Distance/Threshold fields per refined face set and curvature sizing, combined by a Min field
+    void applySizeFields(double size_scale);
+
+    // Mesh each volume's interior in a forked worker and merge the results
+    int generateVolumesInParallel();
+
+    // Drop the mesh of every entity that does not bound a shell face
+    void clearNonShellMesh();
+
+    // Thickness and offset of each shell face from its first element and its body
+    int computeShellSections();
+
+    // Distance from a point of a face straight across its body to an opposite face; 0 if none
+    double measureThickness(int surface, int volume, const double point[3], const double normal[3]) const;
+
+    std::vector<int> surface_tags_;  // Sorted
+    std::vector<int> volume_tags_;
+    FaceLocator face_locator_;
+    std::map<int, std::vector<int>> imported_surfaces_;  // STEP face -> model faces; empty if not fragmented
     double char_length_min_;
     double char_length_max_;
     int mesh_algorithm_;
     int mesh_order_;
+    int workers_;
+    std::vector<RefinementRegion> refinements_;
+    int curvature_points_;
+    std::vector<int> size_fields_;  // Fields this generator created in the model
+    std::vector<int> shell_surfaces_;  // Sorted; empty for a solid model
+    double shell_thickness_;
+    bool shell_quads_;
+    std::vector<ShellSection> shell_sections_;
+    double memory_budget_mb_;
+    double time_budget_seconds_;
+    bool plan_only_;
+    ResourceEstimate estimate_;
 };
 
 #endif // MESH_GENERATOR_H
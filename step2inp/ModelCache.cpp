@@ -0,0 +1,145 @@
+#include "ModelCache.h"
+#include <gmsh.h>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+
+ModelCache::ModelCache()
+    : capacity_(4)
+    , next_model_(0)
+    , owns_gmsh_(false)
+    , current_(nullptr)
+{
+}
+
+ModelCache::~ModelCache() {
+    finalize();
+}
+
+int ModelCache::initialize() {
+    try {
+        if (!gmsh::isInitialized()) {
+            gmsh::initialize();
+            owns_gmsh_ = true;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "gmsh 初期化エラー: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+void ModelCache::finalize() {
+    try {
+        while (!entries_.empty() && gmsh::isInitialized()) {
+            evict(entries_.begin());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "モデルキャッシュエラー: " << e.what() << std::endl;
+    }
+    entries_.clear();
+    index_.clear();
+    current_ = nullptr;
+    if (owns_gmsh_) {
+        gmsh::finalize();
+        owns_gmsh_ = false;
+    }
+}
+
+void ModelCache::setCapacity(std::size_t capacity) {
+    capacity_ = std::max<std::size_t>(1, capacity);
+}
+
+std::size_t ModelCache::getCapacity() const {
+    return capacity_;
+}
+
+std::size_t ModelCache::getSize() const {
+    return entries_.size();
+}
+
+const ModelCacheStatistics& ModelCache::getStatistics() const {
+    return statistics_;
+}
+
+int ModelCache::open(const std::string& step_file, const std::string& mesh_key,
+                     MeshGenerator& generator, NodeRenumberer& renumberer, bool& meshed) {
+    meshed = false;
+    current_ = nullptr;
+
+    std::error_code ec;
+    std::string path = std::filesystem::weakly_canonical(step_file, ec).string();
+    if (ec) path = step_file;
+    std::string stamp = std::to_string(std::filesystem::file_size(step_file, ec)) + ":" +
+        std::to_string(std::filesystem::last_write_time(step_file, ec).time_since_epoch().count());
+
+    try {
+        auto it = index_.find(path);
+        if (it != index_.end() && it->second->stamp != stamp) {
+            // The file changed since it was imported
+            evict(it->second);
+            it = index_.end();
+        }
+
+        if (it != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            Entry& entry = entries_.front();
+            gmsh::model::setCurrent(entry.model_name);
+            generator.adoptGeometry(entry.generator);
+            if (!mesh_key.empty() && entry.mesh_key == mesh_key) {
+                renumberer = entry.renumberer;
+                meshed = true;
+                ++statistics_.mesh_hits;
+            } else {
+                if (!mesh_key.empty() && !entry.mesh_key.empty()) {
+                    gmsh::model::mesh::clear();
+                    entry.mesh_key.clear();
+                }
+                ++statistics_.geometry_hits;
+            }
+            current_ = &entry;
+            return 0;
+        }
+
+        while (entries_.size() >= capacity_) {
+            evict(std::prev(entries_.end()));
+        }
+
+        Entry entry;
+        entry.path = path;
+        entry.stamp = stamp;
+        entry.model_name = "strecsfem_model_" + std::to_string(++next_model_);
+        gmsh::model::add(entry.model_name);
+        if (generator.importGeometry(step_file) != 0) {
+            gmsh::model::remove();
+            return 1;
+        }
+        entry.generator.adoptGeometry(generator);
+        entries_.push_front(std::move(entry));
+        index_[path] = entries_.begin();
+        current_ = &entries_.front();
+        ++statistics_.misses;
+    } catch (const std::exception& e) {
+        std::cerr << "モデルキャッシュエラー: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+void ModelCache::storeMesh(const std::string& mesh_key, const MeshGenerator& generator,
+                           const NodeRenumberer& renumberer) {
+    if (current_ == nullptr) return;
+    current_->mesh_key = mesh_key;
+    current_->generator.adoptGeometry(generator);
+    current_->renumberer = renumberer;
+}
+
+void ModelCache::evict(std::list<Entry>::iterator entry) {
+    gmsh::model::setCurrent(entry->model_name);
+    gmsh::model::remove();
+    if (current_ == &*entry) current_ = nullptr;
+    index_.erase(entry->path);
+    entries_.erase(entry);
+    ++statistics_.evictions;
+}
@@ -0,0 +1,71 @@
+#ifndef MODEL_CACHE_H
+#define MODEL_CACHE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+#include "MeshGenerator.h"
+#include "NodeRenumberer.h"
+
+struct ModelCacheStatistics {
+    std::size_t geometry_hits = 0;  // Geometry reused, mesh regenerated
+    std::size_t mesh_hits = 0;      // Geometry and mesh reused
+    std::size_t misses = 0;         // STEP file imported
+    std::size_t evictions = 0;
+};
+
+// gmsh models kept alive between conversions in a long-running process.
+// Each STEP file gets its own named gmsh model; the least recently used one
+// is removed when the capacity is exceeded.
+class ModelCache {
+public:
+    ModelCache();
+    ~ModelCache();
+
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    // Initialize gmsh for the lifetime of the cache
+    int initialize();
+    void finalize();
+
+    void setCapacity(std::size_t capacity);
+    std::size_t getCapacity() const;
+    std::size_t getSize() const;
+
+    // Make the model of step_file current, importing it on a miss. The generator
+    // takes over the cached geometry state; `meshed` tells whether the model
+    // already holds a mesh made with mesh_key, in which case the renumberer is
+    // restored as well. A stale mesh is cleared; an empty mesh_key asks for
+    // the geometry only and leaves any mesh in place.
+    int open(const std::string& step_file, const std::string& mesh_key,
+             MeshGenerator& generator, NodeRenumberer& renumberer, bool& meshed);
+
+    // Record the mesh just generated in the current model
+    void storeMesh(const std::string& mesh_key, const MeshGenerator& generator, const NodeRenumberer& renumberer);
+
+    const ModelCacheStatistics& getStatistics() const;
+
+private:
+    struct Entry {
+        std::string path;        // Canonical STEP path
+        std::string stamp;       // File size and modification time
+        std::string model_name;  // gmsh model holding the geometry
+        std::string mesh_key;    // Settings of the current mesh; empty if not meshed
+        MeshGenerator generator;
+        NodeRenumberer renumberer;
+    };
+
+    void evict(std::list<Entry>::iterator entry);
+
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::size_t capacity_;
+    std::size_t next_model_;
+    bool owns_gmsh_;
+    Entry* current_;
+    ModelCacheStatistics statistics_;
+};
+
+#endif // MODEL_CACHE_H
@@ -0,0 +1,442 @@
+#include "NodeRenumberer.h"
+#include <gmsh.h>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstdint>
+#include "logging/Logger.h"
+
+namespace {
+
+const std::size_t kNoIndex = std::numeric_limits<std::size_t>::max();
+
+// Breadth-first search from root; returns its eccentricity and the nodes on the
+// last level. Only the touched entries of `level` are reset afterwards.
+std::size_t bfsLastLevel(const std::vector<std::size_t>& offsets,
+                         const std::vector<std::size_t>& neighbors,
+                         std::size_t root,
+                         std::vector<std::size_t>& level,
+                         std::vector<std::size_t>& last_level) {
+    std::vector<std::size_t> visited{root};
+    level[root] = 0;
+    for (std::size_t head = 0; head < visited.size(); ++head) {
+        std::size_t v = visited[head];
+        for (std::size_t k = offsets[v]; k < offsets[v + 1]; ++k) {
+            std::size_t w = neighbors[k];
+            if (level[w] == kNoIndex) {
+                level[w] = level[v] + 1;
+                visited.push_back(w);
+            }
+        }
+    }
+
+    std::size_t eccentricity = level[visited.back()];
+    last_level.clear();
+    for (std::size_t v : visited) {
+        if (level[v] == eccentricity) {
+            last_level.push_back(v);
+        }
+        level[v] = kNoIndex;
+    }
+    return eccentricity;
+}
+
+// Skilling's transform of quantized coordinates to a 3D Hilbert key
+std::uint64_t hilbertKey(std::uint32_t x[3], int bits) {
+    std::uint32_t m = 1u << (bits - 1);
+    for (std::uint32_t q = m; q > 1; q >>= 1) {
+        std::uint32_t p = q - 1;
+        for (int i = 0; i < 3; ++i) {
+            if (x[i] & q) {
+                x[0] ^= p;
+            } else {
+                std::uint32_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    for (int i = 1; i < 3; ++i) {
+        x[i] ^= x[i - 1];
+    }
+    std::uint32_t t = 0;
+    for (std::uint32_t q = m; q > 1; q >>= 1) {
+        if (x[2] & q) t ^= q - 1;
+    }
+    for (int i = 0; i < 3; ++i) {
+        x[i] ^= t;
+    }
+
+    std::uint64_t key = 0;
+    for (int b = bits - 1; b >= 0; --b) {
+        for (int i = 0; i < 3; ++i) {
+            key = (key << 1) | ((x[i] >> b) & 1u);
+        }
+    }
+    return key;
+}
+
+} // namespace
+
+NodeRenumberer::NodeRenumberer()
+    : method_(RenumberingMethod::None)
+    , stats_before_{0, 0}
+    , stats_after_{0, 0}
+{
+}
+
+NodeRenumberer::~NodeRenumberer() {
+}
+
+void NodeRenumberer::setMethod(RenumberingMethod method) {
+    method_ = method;
+}
+
+RenumberingMethod NodeRenumberer::getMethod() const {
+    return method_;
+}
+
+bool NodeRenumberer::parseMethod(const std::string& name, RenumberingMethod& method) {
+    if (name == "none") {
+        method = RenumberingMethod::None;
+    } else if (name == "rcm") {
+        method = RenumberingMethod::ReverseCuthillMcKee;
+    } else if (name == "hilbert") {
+        method = RenumberingMethod::Hilbert;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+NodeRenumberer::Graph NodeRenumberer::buildGraph(std::size_t num_nodes,
+                                                 const std::vector<std::size_t>& element_offsets,
+                                                 const std::vector<std::size_t>& element_nodes) {
+    std::size_t num_elements = element_offsets.size() - 1;
+
+    // Node -> element incidence
+    std::vector<std::size_t> incidence_offsets(num_nodes + 1, 0);
+    for (std::size_t node : element_nodes) {
+        ++incidence_offsets[node + 1];
+    }
+    std::partial_sum(incidence_offsets.begin(), incidence_offsets.end(), incidence_offsets.begin());
+    std::vector<std::size_t> incidence(element_nodes.size());
+    std::vector<std::size_t> fill(incidence_offsets.begin(), incidence_offsets.end() - 1);
+    for (std::size_t e = 0; e < num_elements; ++e) {
+        for (std::size_t k = element_offsets[e]; k < element_offsets[e + 1]; ++k) {
+            incidence[fill[element_nodes[k]]++] = e;
+        }
+    }
+
+    // Node -> node adjacency through shared elements
+    Graph graph;
+    graph.offsets.resize(num_nodes + 1, 0);
+    graph.neighbors.reserve(element_nodes.size() * 3);
+    std::vector<std::size_t> marker(num_nodes, kNoIndex);
+    for (std::size_t i = 0; i < num_nodes; ++i) {
+        graph.offsets[i] = graph.neighbors.size();
+        marker[i] = i;
+        for (std::size_t k = incidence_offsets[i]; k < incidence_offsets[i + 1]; ++k) {
+            std::size_t e = incidence[k];
+            for (std::size_t m = element_offsets[e]; m < element_offsets[e + 1]; ++m) {
+                std::size_t j = element_nodes[m];
+                if (marker[j] != i) {
+                    marker[j] = i;
+                    graph.neighbors.push_back(j);
+                }
+            }
+        }
+    }
+    graph.offsets[num_nodes] = graph.neighbors.size();
+    return graph;
+}
+
+std::vector<std::size_t> NodeRenumberer::reverseCuthillMcKee(const Graph& graph) {
+    std::size_t n = graph.offsets.size() - 1;
+    auto degree = [&graph](std::size_t v) { return graph.offsets[v + 1] - graph.offsets[v]; };
+
+    std::vector<std::size_t> candidates(n);
+    std::iota(candidates.begin(), candidates.end(), 0);
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&degree](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+
+    std::vector<bool> visited(n, false);
+    std::vector<std::size_t> level(n, kNoIndex);
+    std::vector<std::size_t> last_level;
+    std::vector<std::size_t> order;
+    order.reserve(n);
+
+    for (std::size_t candidate : candidates) {
+        if (visited[candidate]) continue;
+
+        // Pseudo-peripheral start node (George-Liu)
+        std::size_t root = candidate;
+        std::size_t eccentricity = bfsLastLevel(graph.offsets, graph.neighbors, root, level, last_level);
+        for (int iteration = 0; iteration < 8 && eccentricity > 0; ++iteration) {
+            std::size_t next = *std::min_element(last_level.begin(), last_level.end(),
+                                                 [&degree](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+            std::vector<std::size_t> next_last_level;
+            std::size_t next_eccentricity = bfsLastLevel(graph.offsets, graph.neighbors, next, level, next_last_level);
+            if (next_eccentricity <= eccentricity) break;
+            root = next;
+            eccentricity = next_eccentricity;
+            last_level.swap(next_last_level);
+        }
+
+        // Cuthill-McKee sweep, neighbours in order of increasing degree
+        std::size_t head = order.size();
+        order.push_back(root);
+        visited[root] = true;
+        std::vector<std::size_t> adjacent;
+        for (; head < order.size(); ++head) {
+            std::size_t v = order[head];
+            adjacent.clear();
+            for (std::size_t k = graph.offsets[v]; k < graph.offsets[v + 1]; ++k) {
+                std::size_t w = graph.neighbors[k];
+                if (!visited[w]) {
+                    visited[w] = true;
+                    adjacent.push_back(w);
+                }
+            }
+            std::stable_sort(adjacent.begin(), adjacent.end(),
+                             [&degree](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+            order.insert(order.end(), adjacent.begin(), adjacent.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<std::size_t> NodeRenumberer::hilbertOrder(const std::vector<double>& coords) {
+    const int bits = 21;
+    std::size_t n = coords.size() / 3;
+
+    double lo[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    double hi[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int d = 0; d < 3; ++d) {
+            lo[d] = std::min(lo[d], coords[3 * i + d]);
+            hi[d] = std::max(hi[d], coords[3 * i + d]);
+        }
+    }
+    double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2], 1e-300});
+    double scale = static_cast<double>((1u << bits) - 1) / extent;
+
+    std::vector<std::uint64_t> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint32_t x[3];
+        for (int d = 0; d < 3; ++d) {
+            x[d] = static_cast<std::uint32_t>((coords[3 * i + d] - lo[d]) * scale);
+        }
+        keys[i] = hilbertKey(x, bits);
+    }
+
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+    return order;
+}
+
+BandwidthStatistics NodeRenumberer::computeStatistics(const Graph& graph, const std::vector<std::size_t>& position) {
+    BandwidthStatistics stats{0, 0};
+    std::size_t n = graph.offsets.size() - 1;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t row = position[i];
+        std::size_t first = row;
+        for (std::size_t k = graph.offsets[i]; k < graph.offsets[i + 1]; ++k) {
+            std::size_t column = position[graph.neighbors[k]];
+            stats.bandwidth = std::max(stats.bandwidth, row > column ? row - column : column - row);
+            first = std::min(first, column);
+        }
+        stats.profile += row - first;
+    }
+    return stats;
+}
+
+int NodeRenumberer::renumber() {
+    node_tags_.clear();
+    node_order_.clear();
+    node_position_.clear();
+    element_tags_.clear();
+    element_order_.clear();
+
+    if (method_ == RenumberingMethod::None) {
+        return 0;
+    }
+
+    try {
+        // All mesh nodes, sorted by their gmsh tag
+        std::vector<std::size_t> tags;
+        std::vector<double> coord, parametric_coord;
+        gmsh::model::mesh::getNodes(tags, coord, parametric_coord, -1, -1, false, false);
+
+        std::size_t num_nodes = tags.size();
+        std::vector<std::size_t> by_tag(num_nodes);
+        std::iota(by_tag.begin(), by_tag.end(), 0);
+        std::sort(by_tag.begin(), by_tag.end(),
+                  [&tags](std::size_t a, std::size_t b) { return tags[a] < tags[b]; });
+
+        node_tags_.resize(num_nodes);
+        std::vector<double> coords(3 * num_nodes);
+        for (std::size_t i = 0; i < num_nodes; ++i) {
+            node_tags_[i] = tags[by_tag[i]];
+            for (int d = 0; d < 3; ++d) {
+                coords[3 * i + d] = coord[3 * by_tag[i] + d];
+            }
+        }
+        if (num_nodes == 0) {
+            return 0;
+        }
+
+        std::vector<std::size_t> index_of_tag(node_tags_.back() + 1, kNoIndex);
+        for (std::size_t i = 0; i < num_nodes; ++i) {
+            index_of_tag[node_tags_[i]] = i;
+        }
+
+        // Volume element connectivity as node indices (the faces of a shell model)
+        std::vector<int> element_types;
+        std::vector<std::vector<std::size_t>> element_tags, element_node_tags;
+        gmsh::model::mesh::getElements(element_types, element_tags, element_node_tags, 3, -1);
+        if (element_types.empty()) {
+            gmsh::model::mesh::getElements(element_types, element_tags, element_node_tags, 2, -1);
+        }
+
+        std::vector<std::size_t> element_offsets{0};
+        std::vector<std::size_t> element_nodes;
+        std::vector<std::size_t> raw_element_tags;
+        for (std::size_t t = 0; t < element_types.size(); ++t) {
+            std::string element_name;
+            int dim, order, num_element_nodes, num_primary_nodes;
+            std::vector<double> local_coords;
+            gmsh::model::mesh::getElementProperties(element_types[t], element_name, dim, order,
+                                                    num_element_nodes, local_coords, num_primary_nodes);
+
+            for (std::size_t e = 0; e < element_tags[t].size(); ++e) {
+                raw_element_tags.push_back(element_tags[t][e]);
+                for (int k = 0; k < num_element_nodes; ++k) {
+                    element_nodes.push_back(index_of_tag[element_node_tags[t][e * num_element_nodes + k]]);
+                }
+                element_offsets.push_back(element_nodes.size());
+            }
+        }
+
+        Graph graph = buildGraph(num_nodes, element_offsets, element_nodes);
+
+        std::vector<std::size_t> identity(num_nodes);
+        std::iota(identity.begin(), identity.end(), 0);
+        stats_before_ = computeStatistics(graph, identity);
+
+        node_order_ = (method_ == RenumberingMethod::Hilbert) ? hilbertOrder(coords) : reverseCuthillMcKee(graph);
+        node_position_.resize(num_nodes);
+        for (std::size_t k = 0; k < num_nodes; ++k) {
+            node_position_[node_order_[k]] = k;
+        }
+        stats_after_ = computeStatistics(graph, node_position_);
+
+        // Elements follow their lowest renumbered node
+        std::size_t num_elements = raw_element_tags.size();
+        std::vector<std::size_t> first_position(num_elements);
+        for (std::size_t e = 0; e < num_elements; ++e) {
+            std::size_t first = kNoIndex;
+            for (std::size_t k = element_offsets[e]; k < element_offsets[e + 1]; ++k) {
+                first = std::min(first, node_position_[element_nodes[k]]);
+            }
+            first_position[e] = first;
+        }
+        std::vector<std::size_t> element_by_tag(num_elements);
+        std::iota(element_by_tag.begin(), element_by_tag.end(), 0);
+        std::sort(element_by_tag.begin(), element_by_tag.end(),
+                  [&raw_element_tags](std::size_t a, std::size_t b) { return raw_element_tags[a] < raw_element_tags[b]; });
+        element_tags_.resize(num_elements);
+        for (std::size_t i = 0; i < num_elements; ++i) {
+            element_tags_[i] = raw_element_tags[element_by_tag[i]];
+        }
+        std::vector<std::size_t> sorted_first(num_elements);
+        for (std::size_t i = 0; i < num_elements; ++i) {
+            sorted_first[i] = first_position[element_by_tag[i]];
+        }
+        element_order_.resize(num_elements);
+        std::iota(element_order_.begin(), element_order_.end(), 0);
+        std::stable_sort(element_order_.begin(), element_order_.end(),
+                         [&sorted_first](std::size_t a, std::size_t b) { return sorted_first[a] < sorted_first[b]; });
+
+        // Apply to the gmsh model; NSETs and CLOADs queried afterwards use the new tags
+        std::vector<std::size_t> old_node_tags(num_nodes), new_node_tags(num_nodes);
+        for (std::size_t k = 0; k < num_nodes; ++k) {
+            old_node_tags[k] = node_tags_[node_order_[k]];
+            new_node_tags[k] = node_tags_[k];
+        }
+        gmsh::model::mesh::renumberNodes(old_node_tags, new_node_tags);
+
+        std::vector<std::size_t> old_element_tags(num_elements), new_element_tags(num_elements);
+        for (std::size_t k = 0; k < num_elements; ++k) {
+            old_element_tags[k] = element_tags_[element_order_[k]];
+            new_element_tags[k] = element_tags_[k];
+        }
+        gmsh::model::mesh::renumberElements(old_element_tags, new_element_tags);
+
+        LOG_INFO("節点番号を付け替えました ("
+                 << (method_ == RenumberingMethod::Hilbert ? "Hilbert" : "RCM") << ", "
+                 << num_nodes << " 節点, " << num_elements << " 要素)");
+        LOG_INFO("  バンド幅: " << stats_before_.bandwidth << " -> " << stats_after_.bandwidth);
+        LOG_INFO("  プロファイル: " << stats_before_.profile << " -> " << stats_after_.profile);
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "節点番号付け替えエラー: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int NodeRenumberer::writeTagMap(const std::string& filename) const {
+    std::ofstream f(filename);
+    if (!f.is_open()) {
+        std::cerr << "エラー: ファイルを開けませんでした: " << filename << std::endl;
+        return 1;
+    }
+
+    f << "# kind,new_tag,original_tag\n";
+    for (std::size_t k = 0; k < node_order_.size(); ++k) {
+        f << "N," << node_tags_[k] << "," << node_tags_[node_order_[k]] << "\n";
+    }
+    for (std::size_t k = 0; k < element_order_.size(); ++k) {
+        f << "E," << element_tags_[k] << "," << element_tags_[element_order_[k]] << "\n";
+    }
+    return 0;
+}
+
+std::size_t NodeRenumberer::getNewNodeTag(std::size_t original_tag) const {
+    auto it = std::lower_bound(node_tags_.begin(), node_tags_.end(), original_tag);
+    if (it == node_tags_.end() || *it != original_tag) {
+        return original_tag;
+    }
+    return node_tags_[node_position_[it - node_tags_.begin()]];
+}
+
+std::size_t NodeRenumberer::getOriginalNodeTag(std::size_t new_tag) const {
+    auto it = std::lower_bound(node_tags_.begin(), node_tags_.end(), new_tag);
+    if (it == node_tags_.end() || *it != new_tag) {
+        return new_tag;
+    }
+    return node_tags_[node_order_[it - node_tags_.begin()]];
+}
+
+std::size_t NodeRenumberer::getOriginalElementTag(std::size_t new_tag) const {
+    auto it = std::lower_bound(element_tags_.begin(), element_tags_.end(), new_tag);
+    if (it == element_tags_.end() || *it != new_tag) {
+        return new_tag;
+    }
+    return element_tags_[element_order_[it - element_tags_.begin()]];
+}
+
+const BandwidthStatistics& NodeRenumberer::getStatisticsBefore() const {
+    return stats_before_;
+}
+
+const BandwidthStatistics& NodeRenumberer::getStatisticsAfter() const {
+    return stats_after_;
+}
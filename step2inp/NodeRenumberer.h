@@ -0,0 +1,74 @@
+#ifndef NODE_RENUMBERER_H
+#define NODE_RENUMBERER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+enum class RenumberingMethod {
+    None,
+    ReverseCuthillMcKee,
+    Hilbert
+};
+
+// Envelope statistics of the node adjacency graph for a given ordering
+struct BandwidthStatistics {
+    std::size_t bandwidth;
+    std::size_t profile;
+};
+
+class NodeRenumberer {
+public:
+    NodeRenumberer();
+    ~NodeRenumberer();
+
+    // Set renumbering method
+    void setMethod(RenumberingMethod method);
+    RenumberingMethod getMethod() const;
+
+    // Renumber nodes and volume elements of the current gmsh mesh
+    int renumber();
+
+    // Write old<->new tag map to file
+    int writeTagMap(const std::string& filename) const;
+
+    // Translate tags across the renumbering (identity if nothing was renumbered)
+    std::size_t getNewNodeTag(std::size_t original_tag) const;
+    std::size_t getOriginalNodeTag(std::size_t new_tag) const;
+    std::size_t getOriginalElementTag(std::size_t new_tag) const;
+
+    // Statistics of the original and the renumbered ordering
+    const BandwidthStatistics& getStatisticsBefore() const;
+    const BandwidthStatistics& getStatisticsAfter() const;
+
+    // Parse method name ("none", "rcm", "hilbert")
+    static bool parseMethod(const std::string& name, RenumberingMethod& method);
+
+private:
+    // Node adjacency graph in compressed row form, indices into node_tags_
+    struct Graph {
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> neighbors;
+    };
+
+    static Graph buildGraph(std::size_t num_nodes,
+                            const std::vector<std::size_t>& element_offsets,
+                            const std::vector<std::size_t>& element_nodes);
+    static std::vector<std::size_t> reverseCuthillMcKee(const Graph& graph);
+    static std::vector<std::size_t> hilbertOrder(const std::vector<double>& coords);
+    static BandwidthStatistics computeStatistics(const Graph& graph, const std::vector<std::size_t>& position);
+
+    RenumberingMethod method_;
+
+    // Sorted original tags; the renumbering permutes tags within these sets
+    std::vector<std::size_t> node_tags_;
+    std::vector<std::size_t> node_order_;      // node index placed at each new position
+    std::vector<std::size_t> node_position_;   // new position of each node index
+    std::vector<std::size_t> element_tags_;
+    std::vector<std::size_t> element_order_;
+
+    BandwidthStatistics stats_before_;
+    BandwidthStatistics stats_after_;
+};
+
+#endif // NODE_RENUMBERER_H
@@ -0,0 +1,186 @@
+#include "ResourceEstimator.h"
+#include <gmsh.h>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include "logging/Logger.h"
+
+namespace {
+
+// Average nodes coupled to a node of a quadratic tetrahedral mesh (including itself)
+const double kQuadraticCoupling = 27.0;
+
+// Factor nonzeros of a 3D mesh under nested dissection ~ kFactorFill * n^(4/3)
+const double kFactorFill = 6.0;
+
+// Factorization work ~ kFactorFlops * n^2
+const double kFactorFlops = 1.0;
+
+// Bytes per stored nonzero (value and index) and fixed solver overhead
+const double kBytesPerNonzero = 12.0;
+const double kBaseMemoryMb = 64.0;
+
+// Shells are expanded by CalculiX into one layer of solid elements (S8 -> C3D20R,
+// S6 -> C3D15, S4 -> C3D8I, S3 -> C3D6). Average nodes coupled to an expanded node:
+const double kShellQuadraticCoupling = 45.0;
+const double kShellLinearCoupling = 14.0;
+
+// The matrix graph of a shell is two-dimensional: under nested dissection the
+// factor holds ~ kShellFactorFill * n log2 n nonzeros and takes ~ kShellFactorFlops * n^1.5
+const double kShellFactorFill = 8.0;
+const double kShellFactorFlops = 30.0;
+
+// Coarsest element sizes the planner may choose, relative to the configured ones
+const double kMaxSizeScale = 3.0;
+
+} // namespace
+
+ResourceEstimator::ResourceEstimator()
+    : flops_per_second_(2e9)
+{
+}
+
+ResourceEstimator::~ResourceEstimator() {
+}
+
+void ResourceEstimator::setThroughput(double flops_per_second) {
+    flops_per_second_ = flops_per_second;
+}
+
+int ResourceEstimator::collectStatistics(MeshStatistics& statistics, bool shell) {
+    statistics = MeshStatistics();
+    statistics.shell = shell;
+    try {
+        std::vector<std::size_t> node_tags;
+        std::vector<double> coords, parametric_coords;
+        gmsh::model::mesh::getNodes(node_tags, coords, parametric_coords, -1, -1, false, false);
+        statistics.nodes = node_tags.size();
+
+        // Unique edges of the 4-node tetrahedra, or of the 3-node triangles and
+        // 4-node quadrilaterals of a shell, as sorted node pairs
+        static const int kTetraEdges[6][2] = {{0, 1}, {1, 2}, {2, 0}, {0, 3}, {1, 3}, {2, 3}};
+        static const int kTriangleEdges[3][2] = {{0, 1}, {1, 2}, {2, 0}};
+        static const int kQuadrangleEdges[4][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}};
+        struct ElementEdges {
+            int type;
+            int nodes;
+            int count;
+            const int (*edges)[2];
+        };
+        std::vector<ElementEdges> element_kinds;
+        if (shell) {
+            element_kinds = {{2, 3, 3, kTriangleEdges}, {3, 4, 4, kQuadrangleEdges}};
+        } else {
+            element_kinds = {{4, 4, 6, kTetraEdges}};
+        }
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        for (const ElementEdges& kind : element_kinds) {
+            std::vector<std::size_t> element_tags, element_nodes;
+            gmsh::model::mesh::getElementsByType(kind.type, element_tags, element_nodes);
+            statistics.elements += element_tags.size();
+            for (std::size_t e = 0; e < element_tags.size(); ++e) {
+                const std::size_t* nodes = &element_nodes[kind.nodes * e];
+                for (int k = 0; k < kind.count; ++k) {
+                    edges.push_back(std::minmax(nodes[kind.edges[k][0]], nodes[kind.edges[k][1]]));
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        statistics.edges = static_cast<std::size_t>(std::unique(edges.begin(), edges.end()) - edges.begin());
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "メッシュ統計の取得エラー: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+ResourceEstimate ResourceEstimator::estimate(const MeshStatistics& statistics, int order, double size_scale) const {
+    // Entity counts scale with the inverse cube of the element size (square for shells)
+    double density = statistics.shell ? 1.0 / (size_scale * size_scale)
+                                      : 1.0 / (size_scale * size_scale * size_scale);
+    double nodes = statistics.nodes * density;
+    double elements = statistics.elements * density;
+    double edges = statistics.edges * density;
+
+    ResourceEstimate estimate;
+    estimate.order = order;
+    estimate.size_scale = size_scale;
+    double coupled_nodes;
+    if (statistics.shell) {
+        // Expanded through the thickness: corner nodes into three, midside nodes into two
+        nodes = order == 2 ? 3.0 * nodes + 2.0 * edges : 2.0 * nodes;
+        double dofs = 3.0 * nodes;
+        double nonzeros = 9.0 * nodes * (order == 2 ? kShellQuadraticCoupling : kShellLinearCoupling);
+        double factor_nonzeros = std::max(nonzeros, kShellFactorFill * dofs * std::log2(std::max(dofs, 2.0)));
+
+        estimate.nodes = static_cast<std::size_t>(nodes);
+        estimate.elements = static_cast<std::size_t>(elements);
+        estimate.dofs = static_cast<std::size_t>(dofs);
+        estimate.nonzeros = static_cast<std::size_t>(nonzeros);
+        estimate.memory_mb = kBaseMemoryMb + (factor_nonzeros + nonzeros) * kBytesPerNonzero / (1024.0 * 1024.0);
+        estimate.solve_seconds = kShellFactorFlops * std::pow(dofs, 1.5) / flops_per_second_;
+        return estimate;
+    }
+    if (order == 2) {
+        nodes += edges;  // One midside node per edge
+        coupled_nodes = nodes * kQuadraticCoupling;
+    } else {
+        coupled_nodes = nodes + 2.0 * edges;
+    }
+    double dofs = 3.0 * nodes;
+    double nonzeros = 9.0 * coupled_nodes;
+    double factor_nonzeros = std::max(nonzeros, kFactorFill * std::pow(dofs, 4.0 / 3.0));
+
+    estimate.nodes = static_cast<std::size_t>(nodes);
+    estimate.elements = static_cast<std::size_t>(elements);
+    estimate.dofs = static_cast<std::size_t>(dofs);
+    estimate.nonzeros = static_cast<std::size_t>(nonzeros);
+    estimate.memory_mb = kBaseMemoryMb + (factor_nonzeros + nonzeros) * kBytesPerNonzero / (1024.0 * 1024.0);
+    estimate.solve_seconds = kFactorFlops * dofs * dofs / flops_per_second_;
+    return estimate;
+}
+
+bool ResourceEstimator::fits(const ResourceEstimate& estimate, const ResourceBudget& budget) const {
+    return (budget.memory_mb <= 0.0 || estimate.memory_mb <= budget.memory_mb) &&
+           (budget.time_seconds <= 0.0 || estimate.solve_seconds <= budget.time_seconds);
+}
+
+ResourceEstimate ResourceEstimator::plan(const MeshStatistics& statistics, const ResourceBudget& budget) const {
+    std::vector<int> orders = budget.order == 0 ? std::vector<int>{2, 1} : std::vector<int>{budget.order};
+    for (int order : orders) {
+        ResourceEstimate finest = estimate(statistics, order, 1.0);
+        if (fits(finest, budget)) {
+            return finest;
+        }
+        if (!fits(estimate(statistics, order, kMaxSizeScale), budget)) {
+            continue;
+        }
+        // Both resources fall monotonically with the element size
+        double low = 1.0, high = kMaxSizeScale;
+        for (int i = 0; i < 30; ++i) {
+            double middle = 0.5 * (low + high);
+            if (fits(estimate(statistics, order, middle), budget)) {
+                high = middle;
+            } else {
+                low = middle;
+            }
+        }
+        return estimate(statistics, order, high);
+    }
+
+    ResourceEstimate coarsest = estimate(statistics, orders.back(), kMaxSizeScale);
+    coarsest.fits = false;
+    return coarsest;
+}
+
+void ResourceEstimator::print(const ResourceEstimate& estimate) {
+    LOG_INFO("リソース見積もり: " << estimate.order << "次要素, 要素サイズ x" << estimate.size_scale
+             << ", 節点 " << estimate.nodes << ", 要素 " << estimate.elements
+             << ", 自由度 " << estimate.dofs << ", 非ゼロ " << estimate.nonzeros
+             << ", メモリ " << static_cast<long>(estimate.memory_mb) << " MB"
+             << ", 求解 " << estimate.solve_seconds << " 秒"
+             << (estimate.fits ? "" : " (予算超過)"));
+}
@@ -0,0 +1,65 @@
+#ifndef RESOURCE_ESTIMATOR_H
+#define RESOURCE_ESTIMATOR_H
+
+#include <cstddef>
+
+// First-order mesh statistics the estimate is extrapolated from: tetrahedra,
+// or the triangles and quadrilaterals of a shell model
+struct MeshStatistics {
+    std::size_t nodes = 0;
+    std::size_t elements = 0;
+    std::size_t edges = 0;
+    bool shell = false;
+};
+
+// Limits a job has to fit; 0 disables a limit. order 0 lets the planner choose.
+struct ResourceBudget {
+    double memory_mb = 0.0;
+    double time_seconds = 0.0;
+    int order = 2;
+
+    bool empty() const { return memory_mb <= 0.0 && time_seconds <= 0.0; }
+};
+
+struct ResourceEstimate {
+    int order = 2;
+    double size_scale = 1.0;   // Element sizes relative to the configured ones
+    std::size_t nodes = 0;
+    std::size_t elements = 0;
+    std::size_t dofs = 0;
+    std::size_t nonzeros = 0;  // Assembled stiffness matrix, both triangles
+    double memory_mb = 0.0;    // Peak solver memory with a sparse direct solver
+    double solve_seconds = 0.0;
+    bool fits = true;
+};
+
+// Predicts DOFs, matrix nonzeros, direct-solver memory and solve time of a job
+// from its first-order mesh, before the expensive order elevation, and picks
+// the finest order and element size that fit a budget. The constants are rough
+// calibrations against CalculiX with SPOOLES/PARDISO on solid tetrahedra.
+class ResourceEstimator {
+public:
+    ResourceEstimator();
+    ~ResourceEstimator();
+
+    // Sustained factorization speed of the target machine
+    void setThroughput(double flops_per_second);
+
+    // Statistics of the linear tetrahedra, or shell faces, in the current gmsh model
+    static int collectStatistics(MeshStatistics& statistics, bool shell = false);
+
+    // Resources of the mesh elevated to order, with element sizes scaled by size_scale
+    ResourceEstimate estimate(const MeshStatistics& statistics, int order, double size_scale) const;
+
+    // Second order if it fits at all (coarsened if needed), first order otherwise
+    ResourceEstimate plan(const MeshStatistics& statistics, const ResourceBudget& budget) const;
+
+    static void print(const ResourceEstimate& estimate);
+
+private:
+    bool fits(const ResourceEstimate& estimate, const ResourceBudget& budget) const;
+
+    double flops_per_second_;
+};
+
+#endif // RESOURCE_ESTIMATOR_H
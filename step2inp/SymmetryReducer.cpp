@@ -0,0 +1,389 @@
+#include "SymmetryReducer.h"
+#include <gmsh.h>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <array>
+#include <set>
+#include <cmath>
+#include "logging/Logger.h"
+
+namespace {
+
+const char kAxisNames[] = "xyz";
+
+// Parametric samples (fractions of the bounds) tried for a point inside a face
+const double kSamples[9][2] = {{0.5, 0.5}, {0.25, 0.25}, {0.75, 0.25}, {0.25, 0.75}, {0.75, 0.75},
+                               {0.5, 0.25}, {0.5, 0.75}, {0.25, 0.5}, {0.75, 0.5}};
+
+// Size, centre and extent of a body or face
+struct EntityShape {
+    int tag;
+    double mass;  // Volume or area
+    double centre[3];
+    double box[6];
+};
+
+std::vector<EntityShape> getShapes(int dim) {
+    std::vector<std::pair<int, int>> entities;
+    gmsh::model::getEntities(entities, dim);
+    std::vector<EntityShape> shapes;
+    for (const auto& entity : entities) {
+        EntityShape shape;
+        shape.tag = entity.second;
+        gmsh::model::occ::getMass(dim, shape.tag, shape.mass);
+        gmsh::model::occ::getCenterOfMass(dim, shape.tag, shape.centre[0], shape.centre[1], shape.centre[2]);
+        gmsh::model::getBoundingBox(dim, shape.tag, shape.box[0], shape.box[1], shape.box[2],
+                                    shape.box[3], shape.box[4], shape.box[5]);
+        shapes.push_back(shape);
+    }
+    return shapes;
+}
+
+// Tag of the entity equal to the mirror image of shape, or -1
+int findMirror(const std::vector<EntityShape>& shapes, const EntityShape& shape,
+               int axis, double position, double distance_tolerance, double tolerance) {
+    double centre[3] = {shape.centre[0], shape.centre[1], shape.centre[2]};
+    double box[6] = {shape.box[0], shape.box[1], shape.box[2], shape.box[3], shape.box[4], shape.box[5]};
+    centre[axis] = 2.0 * position - shape.centre[axis];
+    box[axis] = 2.0 * position - shape.box[axis + 3];
+    box[axis + 3] = 2.0 * position - shape.box[axis];
+
+    for (const EntityShape& other : shapes) {
+        if (std::abs(other.mass - shape.mass) > tolerance * shape.mass) continue;
+        bool equal = true;
+        for (int a = 0; equal && a < 3; ++a) {
+            equal = std::abs(other.centre[a] - centre[a]) <= distance_tolerance;
+        }
+        for (int k = 0; equal && k < 6; ++k) {
+            equal = std::abs(other.box[k] - box[k]) <= distance_tolerance;
+        }
+        if (equal) return other.tag;
+    }
+    return -1;
+}
+
+// Force vector of a load
+std::vector<double> forceOf(const LoadCondition& load) {
+    double norm = 0.0;
+    for (double component : load.direction) norm += component * component;
+    norm = std::sqrt(norm);
+    std::vector<double> force(3, 0.0);
+    for (std::size_t a = 0; a < 3 && a < load.direction.size(); ++a) {
+        force[a] = norm > 0 ? load.magnitude * load.direction[a] / norm : 0.0;
+    }
+    return force;
+}
+
+// A point inside a face, away from its edges
+bool getInteriorPoint(int surface, std::vector<double>& point) {
+    std::vector<double> param_min, param_max;
+    gmsh::model::getParametrizationBounds(2, surface, param_min, param_max);
+    for (const auto& sample : kSamples) {
+        std::vector<double> param = {param_min[0] + sample[0] * (param_max[0] - param_min[0]),
+                                     param_min[1] + sample[1] * (param_max[1] - param_min[1])};
+        if (gmsh::model::isInside(2, surface, param, true) == 0) continue;
+        gmsh::model::getValue(2, surface, param, point);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+SymmetryReducer::SymmetryReducer()
+    : tolerance_(1e-4)
+    , max_planes_(2)
+{
+}
+
+SymmetryReducer::~SymmetryReducer() {
+}
+
+void SymmetryReducer::setTolerance(double tolerance) {
+    tolerance_ = tolerance;
+}
+
+void SymmetryReducer::setMaxPlanes(int max_planes) {
+    max_planes_ = max_planes;
+}
+
+const std::vector<SymmetryPlane>& SymmetryReducer::getPlanes() const {
+    return planes_;
+}
+
+const std::vector<std::vector<int>>& SymmetryReducer::getPlaneSurfaces() const {
+    return plane_surfaces_;
+}
+
+int SymmetryReducer::detect(const std::vector<ConstraintCondition>& constraints,
+                            const std::vector<LoadCondition>& loads,
+                            const MaterialSetter& materials) {
+    planes_.clear();
+    plane_surfaces_.clear();
+    try {
+        std::vector<EntityShape> volumes = getShapes(3);
+        std::vector<EntityShape> surfaces = getShapes(2);
+        double bounds[6];
+        gmsh::model::getBoundingBox(-1, -1, bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+        double size = std::sqrt((bounds[3] - bounds[0]) * (bounds[3] - bounds[0]) +
+                                (bounds[4] - bounds[1]) * (bounds[4] - bounds[1]) +
+                                (bounds[5] - bounds[2]) * (bounds[5] - bounds[2]));
+        double distance_tolerance = tolerance_ * size;
+
+        // A mirror plane of the whole model passes through its centre of mass
+        double mass = 0.0, centre[3] = {0.0, 0.0, 0.0};
+        for (const EntityShape& volume : volumes) {
+            mass += volume.mass;
+            for (int a = 0; a < 3; ++a) centre[a] += volume.mass * volume.centre[a];
+        }
+        if (mass <= 0) return 0;
+        for (double& c : centre) c /= mass;
+
+        std::set<int> fixed;
+        for (const auto& constraint : constraints) {
+            fixed.insert(constraint.surface_number);
+        }
+
+        for (int axis = 0; axis < 3 && static_cast<int>(planes_.size()) < max_planes_; ++axis) {
+            double position = centre[axis];
+            bool symmetric = true;
+            for (const EntityShape& volume : volumes) {
+                int mirror = findMirror(volumes, volume, axis, position, distance_tolerance, tolerance_);
+                symmetric = mirror > 0 &&
+                            materials.getVolumeMaterial(mirror).name == materials.getVolumeMaterial(volume.tag).name;
+                if (!symmetric) break;
+            }
+
+            std::map<int, int> surface_mirror;
+            for (std::size_t i = 0; symmetric && i < surfaces.size(); ++i) {
+                int mirror = findMirror(surfaces, surfaces[i], axis, position, distance_tolerance, tolerance_);
+                symmetric = mirror > 0;
+                surface_mirror[surfaces[i].tag] = mirror;
+            }
+            if (!symmetric) continue;
+
+            // Fixed faces map onto fixed faces, loads onto equal mirrored loads
+            for (int surface : fixed) {
+                symmetric = symmetric && fixed.count(surface_mirror[surface]) > 0;
+            }
+            for (std::size_t i = 0; symmetric && i < loads.size(); ++i) {
+                std::vector<double> force = forceOf(loads[i]);
+                force[axis] = -force[axis];
+                double force_tolerance = tolerance_ * std::abs(loads[i].magnitude);
+                symmetric = std::any_of(loads.begin(), loads.end(), [&](const LoadCondition& other) {
+                    if (other.surface_number != surface_mirror[loads[i].surface_number] ||
+                        other.pressure != loads[i].pressure) {
+                        return false;
+                    }
+                    std::vector<double> other_force = forceOf(other);
+                    for (int a = 0; a < 3; ++a) {
+                        if (std::abs(other_force[a] - force[a]) > force_tolerance) return false;
+                    }
+                    return true;
+                });
+            }
+            if (!symmetric) {
+                LOG_INFO("形状は " << kAxisNames[axis] << " = " << position
+                         << " について対称ですが、境界条件が対称ではありません");
+                continue;
+            }
+            planes_.push_back({axis, position});
+            LOG_INFO("対称面を検出しました: " << kAxisNames[axis] << " = " << position);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "対称性検出エラー: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (planes_.empty()) {
+        LOG_INFO("対称面は見つかりませんでした。全体モデルを解析します");
+    }
+    return 0;
+}
+
+int SymmetryReducer::reduce(MeshGenerator& generator, MaterialSetter& materials,
+                            std::vector<ConstraintCondition>& constraints,
+                            std::vector<LoadCondition>& loads) {
+    if (planes_.empty()) {
+        return 0;
+    }
+
+    std::map<int, std::vector<int>> surface_map;  // Original face -> faces of the cut model
+    std::map<int, std::vector<int>> volume_map;   // Original body -> bodies of the cut model
+    std::map<int, double> areas;  // Of the original and of the cut faces
+    try {
+        double bounds[6];
+        gmsh::model::getBoundingBox(-1, -1, bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+        double margin = std::max({bounds[3] - bounds[0], bounds[4] - bounds[1], bounds[5] - bounds[2]});
+        double distance_tolerance = tolerance_ * margin;
+
+        // Free copies of the original faces tell which original face each cut face
+        // comes from; the cut renumbers the faces it touches
+        std::vector<std::pair<int, int>> faces, copies;
+        gmsh::model::getEntities(faces, 2);
+        for (const auto& face : faces) {
+            gmsh::model::occ::getMass(2, face.second, areas[face.second]);
+        }
+        gmsh::model::occ::copy(faces, copies);
+
+        std::vector<std::pair<int, int>> volumes;
+        gmsh::model::getEntities(volumes, 3);
+        for (const auto& volume : volumes) {
+            volume_map[volume.second] = {volume.second};
+        }
+        auto follow = [&volume_map](const std::vector<std::pair<int, int>>& inputs,
+                                    const std::vector<std::vector<std::pair<int, int>>>& results) {
+            std::map<int, std::vector<int>> next;
+            for (std::size_t i = 0; i < inputs.size() && i < results.size(); ++i) {
+                for (const auto& result : results[i]) {
+                    if (result.first == 3) next[inputs[i].second].push_back(result.second);
+                }
+            }
+            for (auto& [original, tags] : volume_map) {
+                std::vector<int> mapped;
+                for (int tag : tags) {
+                    mapped.insert(mapped.end(), next[tag].begin(), next[tag].end());
+                }
+                std::sort(mapped.begin(), mapped.end());
+                mapped.erase(std::unique(mapped.begin(), mapped.end()), mapped.end());
+                tags = mapped;
+            }
+        };
+
+        // Remove the negative side of each plane with a box around it
+        for (const SymmetryPlane& plane : planes_) {
+            double corner[3], extent[3];
+            for (int a = 0; a < 3; ++a) {
+                corner[a] = bounds[a] - margin;
+                extent[a] = bounds[a + 3] - bounds[a] + 2.0 * margin;
+            }
+            extent[plane.axis] = plane.position - corner[plane.axis];
+            int box = gmsh::model::occ::addBox(corner[0], corner[1], corner[2], extent[0], extent[1], extent[2]);
+
+            std::vector<std::pair<int, int>> kept;
+            std::vector<std::vector<std::pair<int, int>>> kept_map;
+            gmsh::model::occ::cut(volumes, {{3, box}}, kept, kept_map);
+            follow(volumes, kept_map);
+            volumes.clear();
+            for (const auto& entity : kept) {
+                if (entity.first == 3) volumes.push_back(entity);
+            }
+        }
+
+        // Touching bodies share their interface faces again
+        if (volumes.size() > 1) {
+            std::vector<std::pair<int, int>> fragments;
+            std::vector<std::vector<std::pair<int, int>>> fragment_map;
+            gmsh::model::occ::fragment(volumes, {}, fragments, fragment_map);
+            follow(volumes, fragment_map);
+        }
+        gmsh::model::occ::synchronize();
+
+        // Each face of the cut model lies on an original face or in a plane
+        std::vector<std::array<double, 6>> copy_bounds(copies.size());
+        std::set<int> copy_tags;
+        for (std::size_t i = 0; i < copies.size(); ++i) {
+            std::array<double, 6>& box = copy_bounds[i];
+            gmsh::model::getBoundingBox(2, copies[i].second, box[0], box[1], box[2], box[3], box[4], box[5]);
+            copy_tags.insert(copies[i].second);
+        }
+        plane_surfaces_.assign(planes_.size(), std::vector<int>());
+        std::vector<std::pair<int, int>> cut_faces;
+        gmsh::model::getEntities(cut_faces, 2);
+        for (const auto& face : cut_faces) {
+            if (copy_tags.count(face.second)) continue;
+            std::vector<double> point;
+            if (!getInteriorPoint(face.second, point)) {
+                std::cerr << "警告: 切断後の Surface " << face.second << " の内点が見つかりません" << std::endl;
+                continue;
+            }
+
+            int original = -1;
+            double best = distance_tolerance;
+            for (std::size_t i = 0; i < copies.size(); ++i) {
+                const std::array<double, 6>& box = copy_bounds[i];
+                bool near = true;
+                for (int a = 0; near && a < 3; ++a) {
+                    near = point[a] >= box[a] - distance_tolerance && point[a] <= box[a + 3] + distance_tolerance;
+                }
+                if (!near) continue;
+                std::vector<double> closest, parametric_coord;
+                gmsh::model::getClosestPoint(2, copies[i].second, point, closest, parametric_coord);
+                double distance = std::sqrt((closest[0] - point[0]) * (closest[0] - point[0]) +
+                                            (closest[1] - point[1]) * (closest[1] - point[1]) +
+                                            (closest[2] - point[2]) * (closest[2] - point[2]));
+                if (distance <= best) {
+                    best = distance;
+                    original = faces[i].second;
+                }
+            }
+            if (original > 0) {
+                surface_map[original].push_back(face.second);
+                gmsh::model::occ::getMass(2, face.second, areas[face.second]);
+                continue;
+            }
+            for (std::size_t p = 0; p < planes_.size(); ++p) {
+                if (std::abs(point[planes_[p].axis] - planes_[p].position) <= distance_tolerance) {
+                    plane_surfaces_[p].push_back(face.second);
+                }
+            }
+        }
+        gmsh::model::occ::remove(copies, true);
+        gmsh::model::occ::synchronize();
+    } catch (const std::exception& e) {
+        std::cerr << "対称モデル作成エラー: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (generator.reindexGeometry() != 0) {
+        return 1;
+    }
+    generator.renumberSurfaces(surface_map);
+    materials.renumberVolumes(volume_map);
+
+    // Conditions on removed faces are represented by their mirror images
+    std::vector<ConstraintCondition> kept_constraints;
+    for (const auto& constraint : constraints) {
+        for (int surface : surface_map[constraint.surface_number]) {
+            kept_constraints.push_back({surface});
+        }
+    }
+    std::vector<LoadCondition> kept_loads;
+    for (const auto& load : loads) {
+        double area = areas[load.surface_number];
+        for (int surface : surface_map[load.surface_number]) {
+            LoadCondition kept = load;
+            kept.surface_number = surface;
+            kept.magnitude = load.magnitude * (area > 0 ? areas[surface] / area : 1.0);
+            kept_loads.push_back(kept);
+        }
+    }
+    constraints = kept_constraints;
+    loads = kept_loads;
+
+    std::ostringstream summary;
+    for (std::size_t p = 0; p < planes_.size(); ++p) {
+        summary << " " << kAxisNames[planes_[p].axis] << " = " << planes_[p].position
+                << " (" << plane_surfaces_[p].size() << " 面)";
+    }
+    LOG_INFO("対称性を利用して 1/" << (1 << planes_.size()) << " モデルを解析します:" << summary.str());
+    return 0;
+}
+
+int SymmetryReducer::writePlanes(const std::string& filename) const {
+    std::ofstream f(filename);
+    if (!f.is_open()) {
+        std::cerr << "エラー: ファイルを開けませんでした: " << filename << std::endl;
+        return 1;
+    }
+    f << "# symmetry planes: axis position\n";
+    f << std::setprecision(17);
+    for (const SymmetryPlane& plane : planes_) {
+        f << kAxisNames[plane.axis] << " " << plane.position << "\n";
+    }
+    return f.good() ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+#ifndef SYMMETRY_REDUCER_H
+#define SYMMETRY_REDUCER_H
+
+#include <string>
+#include <vector>
+#include "ConstraintSetter.h"
+#include "LoadConditionSetter.h"
+#include "MaterialSetter.h"
+#include "MeshGenerator.h"
+
+// Mirror plane x[axis] = position of a symmetric model
+struct SymmetryPlane {
+    int axis;         // 0 = x, 1 = y, 2 = z
+    double position;
+};
+
+// Finds mirror symmetry of the geometry and of the boundary conditions and cuts
+// the model down to a half or a quarter. Only the kept part is meshed and solved,
+// with symmetry conditions on the cut faces; frd2vtu mirrors the results back.
+class SymmetryReducer {
+public:
+    SymmetryReducer();
+    ~SymmetryReducer();
+
+    // Matching tolerance relative to the model size and to areas and volumes
+    void setTolerance(double tolerance);
+
+    // 1 allows a half model only, 2 also a quarter model
+    void setMaxPlanes(int max_planes);
+
+    // Planes normal to the global axes through the centre of mass of the current
+    // gmsh model that map every body (with its material), face, fixed face and
+    // load onto an equal one
+    int detect(const std::vector<ConstraintCondition>& constraints,
+               const std::vector<LoadCondition>& loads,
+               const MaterialSetter& materials);
+
+    // Cut the bodies to the positive side of the detected planes and move the
+    // conditions, refinements and materials to the faces and bodies of the cut
+    // model. A load on a face split by a plane keeps the force of the kept part.
+    int reduce(MeshGenerator& generator, MaterialSetter& materials,
+               std::vector<ConstraintCondition>& constraints,
+               std::vector<LoadCondition>& loads);
+
+    const std::vector<SymmetryPlane>& getPlanes() const;
+
+    // Faces of the cut model lying in each plane
+    const std::vector<std::vector<int>>& getPlaneSurfaces() const;
+
+    // Plane list kept next to the INP file, for mirroring the results
+    int writePlanes(const std::string& filename) const;
+
+private:
+    double tolerance_;
+    int max_planes_;
+    std::vector<SymmetryPlane> planes_;
+    std::vector<std::vector<int>> plane_surfaces_;
+};
+
+#endif // SYMMETRY_REDUCER_H
@@ -0,0 +1,169 @@
+#include "TestCheck.h"
+#include "frd2vtu/FrdIndex.h"
+#include "frd2vtu/FrdResults.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 100C header of a result block; the output number is the I5 field at columns 59-63
+std::string resultHeader(int output) {
+    std::string header = "  100CL  101 1.00000000000";
+    header.resize(58, ' ');
+    std::string number = std::to_string(output);
+    header += std::string(5 - number.size(), ' ') + number;
+    return header + "    1           1";
+}
+
+struct NodalRecord {
+    int node;
+    std::vector<double> values;
+};
+
+std::string resultBlock(const std::string& type, int output, int increment, int step,
+                        const std::vector<NodalRecord>& records) {
+    std::ostringstream block;
+    block << "    1PSTEP " << output << " " << increment << " " << step << "\n";
+    block << resultHeader(output) << "\n";
+    block << " -4  " << type << "        " << records.size() << "    1\n";
+    for (const NodalRecord& record : records) {
+        block << " -1 " << record.node;
+        for (double value : record.values) block << " " << value;
+        block << "\n";
+    }
+    block << " -3\n";
+    return block.str();
+}
+
+// Two tetrahedra on nodes numbered 10..50, the second one sharing a face with the
+// first; a third element refers to node 99, which does not exist
+std::string meshBlocks() {
+    return
+        "    1C\n"
+        "    2C                             5                                     1\n"
+        " -1 10 0 0 0\n"
+        " -1 20 1 0 0\n"
+        " -1 30 0 1 0\n"
+        " -1 40 0 0 1\n"
+        " -1 50 1 1 1\n"
+        " -3\n"
+        "    3C                             3                                     1\n"
+        " -1 1 3 0 1\n"
+        " -2 10 20 30 40\n"
+        " -1 2 3 0 1\n"
+        " -2 20 30 40 50\n"
+        " -1 3 3 0 1\n"
+        " -2 20 30 40 99\n"
+        " -3\n";
+}
+
+void writeFile(const std::string& filename, const std::string& text) {
+    std::ofstream file(filename);
+    file << text;
+}
+
+void testNodeNumbers(const TempDirectory& directory) {
+    // Records in reverse node order, one node without a record
+    std::string frd_file = directory.file("numbers.frd");
+    writeFile(frd_file, meshBlocks() +
+              resultBlock("DISP", 1, 1, 1, {{50, {5, 5.5, 5.25}}, {40, {4, 4.5, 4.25}}, {30, {3, 3.5, 3.25}},
+                                            {10, {1, 1.5, 1.25}}}) +
+              "9999\n");
+
+    FrdReadOptions options;
+    options.fields = {"DISP"};
+    FrdResults results;
+    CHECK(readFrd(frd_file, options, results) == 0);
+    CHECK(results.getNumberOfNodes() == 5);
+    CHECK(results.node_ids == std::vector<int>({10, 20, 30, 40, 50}));
+
+    // The element on the missing node is dropped; the others map ids to positions
+    CHECK(results.getNumberOfCells() == 2);
+    CHECK(results.cell_ids == std::vector<int>({1, 2}));
+    CHECK(results.cell_connectivity == std::vector<std::int64_t>({0, 1, 2, 3, 1, 2, 3, 4}));
+
+    const FrdField* disp = results.findField("DISP");
+    CHECK(disp != nullptr);
+    if (!disp) return;
+    CHECK(disp->components == 3);
+    CHECK(disp->values.size() == 15);
+    const double expected[] = {1, 1.5, 1.25, 0, 0, 0, 3, 3.5, 3.25, 4, 4.5, 4.25, 5, 5.5, 5.25};
+    for (std::size_t i = 0; i < disp->values.size() && i < 15; ++i) {
+        CHECK_NEAR(disp->values[i], expected[i], 1e-12);
+    }
+}
+
+void testIndex(const TempDirectory& directory) {
+    // Step 1 takes two increments (outputs 1 and 2), step 2 one (output 3)
+    std::string frd_file = directory.file("index.frd");
+    writeFile(frd_file, meshBlocks() +
+              resultBlock("DISP", 1, 1, 1, {{10, {1, 0, 0}}}) +
+              resultBlock("DISP", 2, 2, 1, {{10, {2, 0, 0}}}) +
+              resultBlock("DISP", 3, 1, 2, {{10, {3, 0, 0}}}) +
+              "9999\n");
+
+    FrdIndex index;
+    CHECK(index.build(frd_file) == 0);
+    CHECK(index.getBlocks().size() == 5);
+    CHECK(index.getLastStep() == 3);
+    const FrdBlock* nodes = index.findBlock("NODES");
+    CHECK(nodes != nullptr && nodes->records == 5);
+    const FrdBlock* last = index.findBlock("DISP");
+    CHECK(last != nullptr && last->step == 3 && last->analysis_step == 2);
+    const FrdBlock* step1 = index.findAnalysisStepBlock("DISP", 1);
+    CHECK(step1 != nullptr && step1->step == 2);
+    CHECK(index.findAnalysisStepBlock("DISP", 3) == nullptr);
+
+    // The sidecar index round-trips
+    std::string index_file = FrdIndex::getIndexFilename(frd_file);
+    CHECK(index.save(index_file) == 0);
+    FrdIndex loaded;
+    CHECK(loaded.load(index_file, frd_file) == 0);
+    CHECK(loaded.getBlocks().size() == index.getBlocks().size());
+    const FrdBlock* reloaded = loaded.findAnalysisStepBlock("DISP", 1);
+    CHECK(reloaded != nullptr && reloaded->offset == step1->offset && reloaded->size == step1->size);
+}
+
+void testSuperposition(const TempDirectory& directory) {
+    // Cases name *STEPs of the deck: step 1 uses its last increment (output 2),
+    // not output 1; records come in any node order
+    std::string frd_file = directory.file("cases.frd");
+    writeFile(frd_file, meshBlocks() +
+              resultBlock("DISP", 1, 1, 1, {{10, {100, 100, 100}}}) +
+              resultBlock("DISP", 2, 2, 1, {{20, {0, 1, 0}}, {10, {1, 0, 0}}}) +
+              resultBlock("DISP", 3, 1, 2, {{10, {0, 0, 1}}, {20, {1, 1, 1}}}) +
+              "9999\n");
+
+    FrdReadOptions options;
+    options.fields = {"DISP", "ERROR"};
+    options.load_cases = {{1, 2.0}, {2, -1.0}};
+    FrdResults results;
+    CHECK(readFrd(frd_file, options, results) == 0);
+    const FrdField* disp = results.findField("DISP");
+    CHECK(disp != nullptr && results.fields.size() == 1);  // ERROR is not linear in the load
+    if (!disp) return;
+    CHECK(disp->values.size() == 15);
+    const double expected[] = {2, 0, -1, -1, 1, -1};  // Nodes 10 and 20; the others are 0
+    for (std::size_t i = 0; i < 6 && i < disp->values.size(); ++i) {
+        CHECK_NEAR(disp->values[i], expected[i], 1e-12);
+    }
+    for (std::size_t i = 6; i < disp->values.size(); ++i) {
+        CHECK(disp->values[i] == 0.0);
+    }
+
+    // A step that wrote no output is an error, not another step's results
+    options.load_cases = {{1, 1.0}, {3, 1.0}};
+    CHECK(readFrd(frd_file, options, results) != 0);
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("strecsfem_frd_results_test");
+    testNodeNumbers(directory);
+    testIndex(directory);
+    testSuperposition(directory);
+    return testResult("FrdResultsTest");
+}
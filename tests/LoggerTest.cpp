@@ -0,0 +1,98 @@
+#include "TestCheck.h"
+#include "logging/Logger.h"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::size_t countLines(const std::string& text, const std::string& prefix) {
+    std::istringstream stream(text);
+    std::size_t count = 0;
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.compare(0, prefix.size(), prefix) == 0) ++count;
+    }
+    return count;
+}
+
+void testParseLevel() {
+    LogLevel level = LogLevel::Info;
+    CHECK(parseLogLevel("trace", level) && level == LogLevel::Trace);
+    CHECK(parseLogLevel("warning", level) && level == LogLevel::Warning);
+    CHECK(parseLogLevel("off", level) && level == LogLevel::Off);
+    CHECK(!parseLogLevel("verbose", level) && level == LogLevel::Off);
+    CHECK(!parseLogLevel("INFO", level));
+}
+
+void testLevels() {
+    Logger& logger = Logger::instance();
+    logger.setLevel(LogLevel::Warning);
+    CHECK(logger.getLevel() == LogLevel::Warning);
+    CHECK(!logger.isEnabled(LogLevel::Info));
+    CHECK(logger.isEnabled(LogLevel::Warning));
+    CHECK(logger.isEnabled(LogLevel::Error));
+    logger.setLevel(LogLevel::Off);
+    CHECK(!logger.isEnabled(LogLevel::Error));
+    CHECK(!logger.isEnabled(LogLevel::Off));
+}
+
+void testConcurrentWriters() {
+    // More messages than the ring holds, from several threads: none may be lost,
+    // and each goes to the stream of its level
+    std::ostringstream out, err;
+    std::streambuf* cout_buffer = std::cout.rdbuf(out.rdbuf());
+    std::streambuf* cerr_buffer = std::cerr.rdbuf(err.rdbuf());
+
+    Logger& logger = Logger::instance();
+    logger.setLevel(LogLevel::Debug);
+    const int kThreads = 8;
+    const int kMessages = 5000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([t]() {
+            for (int i = 0; i < kMessages; ++i) {
+                LOG_INFO("info " << t << " " << i);
+                if (i % 500 == 0) LOG_WARNING("warning " << t << " " << i);
+            }
+            LOG_TRACE("trace " << t);  // Below the level
+        });
+    }
+    for (std::thread& writer : writers) writer.join();
+    logger.flush();
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+    logger.setLevel(LogLevel::Info);
+
+    CHECK(countLines(out.str(), "info ") == static_cast<std::size_t>(kThreads * kMessages));
+    CHECK(countLines(err.str(), "warning ") == static_cast<std::size_t>(kThreads * kMessages / 500));
+    CHECK(countLines(out.str(), "warning ") == 0);
+    CHECK(countLines(err.str(), "info ") == 0);
+    CHECK(countLines(out.str(), "trace ") == 0);
+
+    // Each writer's lines stay in the order it logged them
+    std::vector<int> next(kThreads, 0);
+    bool ordered = true;
+    std::istringstream lines(out.str());
+    std::string word;
+    int thread = 0, index = 0;
+    while (lines >> word >> thread >> index) {
+        if (thread < 0 || thread >= kThreads || index != next[thread]) {
+            ordered = false;
+            break;
+        }
+        ++next[thread];
+    }
+    CHECK(ordered);
+}
+
+} // namespace
+
+int main() {
+    testParseLevel();
+    testLevels();
+    testConcurrentWriters();
+    return testResult("LoggerTest");
+}
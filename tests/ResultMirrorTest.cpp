@@ -0,0 +1,121 @@
+#include "TestCheck.h"
+#include "frd2vtu/ResultMirror.h"
+#include <fstream>
+#include <vector>
+
+namespace {
+
+// Six times the signed volume of the tetrahedron on the first four nodes of cell c
+double tetraVolume(const FrdResults& results, std::size_t c) {
+    const std::int64_t* nodes = &results.cell_connectivity[results.cell_offsets[c]];
+    const double* p0 = &results.coordinates[3 * nodes[0]];
+    double edges[3][3];
+    for (int e = 0; e < 3; ++e) {
+        for (int a = 0; a < 3; ++a) edges[e][a] = results.coordinates[3 * nodes[e + 1] + a] - p0[a];
+    }
+    return edges[0][0] * (edges[1][1] * edges[2][2] - edges[1][2] * edges[2][1]) -
+           edges[0][1] * (edges[1][0] * edges[2][2] - edges[1][2] * edges[2][0]) +
+           edges[0][2] * (edges[1][0] * edges[2][1] - edges[1][1] * edges[2][0]);
+}
+
+// One 10-node tetrahedron with three corners in the plane x = 0
+FrdResults halfModel() {
+    FrdResults results;
+    const double corners[4][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    const int edges[6][2] = {{0, 1}, {1, 2}, {2, 0}, {0, 3}, {1, 3}, {2, 3}};  // FRD mid-side node order
+    for (int i = 0; i < 4; ++i) {
+        results.node_ids.push_back(i + 1);
+        results.coordinates.insert(results.coordinates.end(), corners[i], corners[i] + 3);
+    }
+    for (int i = 0; i < 6; ++i) {
+        results.node_ids.push_back(i + 5);
+        for (int a = 0; a < 3; ++a) {
+            results.coordinates.push_back(0.5 * (corners[edges[i][0]][a] + corners[edges[i][1]][a]));
+        }
+    }
+    results.cell_ids = {1};
+    results.cell_types = {6};
+    results.cell_offsets = {0, 10};
+    for (std::int64_t i = 0; i < 10; ++i) results.cell_connectivity.push_back(i);
+
+    FrdField disp;
+    disp.type = "DISP";
+    disp.components = 3;
+    FrdField stress;
+    stress.type = "STRESS";
+    stress.components = 6;
+    for (int i = 0; i < 10; ++i) {
+        disp.values.insert(disp.values.end(), {1.0 + i, 2.0, 3.0});
+        stress.values.insert(stress.values.end(), {1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+    }
+    results.fields = {disp, stress};
+    return results;
+}
+
+void testMirror() {
+    FrdResults results = halfModel();
+    CHECK(tetraVolume(results, 0) > 0);
+    mirrorResults(results, {{0, 0.0}});
+
+    // Nodes in the plane are shared; node 2 (x = 1) and the mid-side nodes of its three edges are copied
+    CHECK(results.getNumberOfNodes() == 14);
+    CHECK(results.getNumberOfCells() == 2);
+    CHECK(results.cell_ids == std::vector<int>({1, 2}));
+    CHECK(tetraVolume(results, 1) > 0);
+
+    // Every node of the image cell lies at the reflection of its counterpart
+    const int kTetra10Mirror[] = {0, 2, 1, 3, 6, 5, 4, 7, 9, 8};
+    for (int k = 0; k < 10; ++k) {
+        std::int64_t image = results.cell_connectivity[10 + k];
+        std::int64_t source = results.cell_connectivity[kTetra10Mirror[k]];
+        CHECK_NEAR(results.coordinates[3 * image], -results.coordinates[3 * source], 1e-12);
+        CHECK_NEAR(results.coordinates[3 * image + 1], results.coordinates[3 * source + 1], 1e-12);
+        CHECK_NEAR(results.coordinates[3 * image + 2], results.coordinates[3 * source + 2], 1e-12);
+        CHECK((image == source) == (results.coordinates[3 * source] == 0.0));
+    }
+
+    // The x component of vectors and the xy and zx shears change sign
+    const FrdField& disp = results.fields[0];
+    const FrdField& stress = results.fields[1];
+    CHECK(disp.values.size() == 3 * 14);
+    CHECK(stress.values.size() == 6 * 14);
+    std::int64_t copy = results.cell_connectivity[10 + 2];  // Image of node 2
+    CHECK(copy >= 10);
+    CHECK_NEAR(disp.values[3 * copy], -2.0, 1e-12);
+    CHECK_NEAR(disp.values[3 * copy + 1], 2.0, 1e-12);
+    const double flipped[] = {1, 2, 3, -4, 5, -6};
+    for (int c = 0; c < 6; ++c) {
+        CHECK_NEAR(stress.values[6 * copy + c], flipped[c], 1e-12);
+    }
+}
+
+void testPlanesFile() {
+    TempDirectory directory("strecsfem_result_mirror_test");
+    std::vector<MirrorPlane> planes;
+    CHECK(readMirrorPlanes(directory.file("missing.sym"), planes) == 0 && planes.empty());
+
+    {
+        std::ofstream file(directory.file("model.sym"));
+        file << "# symmetry planes\nx 0\nz 2.5\n";
+    }
+    CHECK(readMirrorPlanes(directory.file("model.sym"), planes) == 0);
+    CHECK(planes.size() == 2);
+    if (planes.size() == 2) {
+        CHECK(planes[0].axis == 0 && planes[0].position == 0.0);
+        CHECK(planes[1].axis == 2 && planes[1].position == 2.5);
+    }
+
+    {
+        std::ofstream file(directory.file("bad.sym"));
+        file << "w 1\n";
+    }
+    CHECK(readMirrorPlanes(directory.file("bad.sym"), planes) != 0);
+}
+
+} // namespace
+
+int main() {
+    testMirror();
+    testPlanesFile();
+    return testResult("ResultMirrorTest");
+}
@@ -0,0 +1,129 @@
+#include "TestCheck.h"
+#include "solver/SolverCache.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// Like the pipeline, unlink an output before writing it anew: it may be a hard
+// link into the cache
+void writeFile(const std::string& filename, const std::string& text) {
+    std::filesystem::remove(filename);
+    std::ofstream file(filename);
+    file << text;
+}
+
+std::string readFile(const std::string& filename) {
+    std::ifstream file(filename);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+void testKeys(const TempDirectory& directory) {
+    // The key covers the deck, the files it includes and the solver
+    std::string mesh = directory.file("mesh_a.inp");
+    std::string deck = directory.file("part.inp");
+    writeFile(mesh, "*NODE\n1, 0, 0, 0\n");
+    writeFile(deck, "*INCLUDE, INPUT=" + mesh + "\n*STEP\n*END STEP\n");
+
+    std::string key = SolverCache::computeKey(deck, "ccx 2.21");
+    CHECK(key.size() == 32);
+    CHECK(SolverCache::computeKey(deck, "ccx 2.21") == key);
+    CHECK(SolverCache::computeKey(deck, "ccx 2.22") != key);
+
+    writeFile(mesh, "*NODE\n1, 0, 0, 1\n");
+    CHECK(SolverCache::computeKey(deck, "ccx 2.21") != key);
+
+    // A missing include cannot be hashed
+    writeFile(deck, "*INCLUDE, INPUT=" + directory.file("missing.inp") + "\n");
+    CHECK(SolverCache::computeKey(deck, "ccx 2.21").empty());
+}
+
+void testStoreAndFetch(const TempDirectory& directory) {
+    std::string cache_dir = directory.file("cache");
+    std::string base = directory.file("job");
+    SolverCache cache;
+    CHECK(cache.open(cache_dir, 1 << 20) == 0);
+
+    CHECK(!cache.fetch("k1", base));
+    CHECK(cache.getStatistics().misses == 1);
+
+    writeFile(base + ".frd", "results 1");
+    writeFile(base + ".dat", "dat 1");
+    CHECK(cache.store("k1", base) == 0);
+    writeFile(base + ".frd", "results 2");
+    std::filesystem::remove(base + ".dat");
+    CHECK(cache.store("k2", base) == 0);
+    CHECK(cache.getStatistics().entries == 2);
+
+    CHECK(cache.fetch("k1", base));
+    CHECK(readFile(base + ".frd") == "results 1");
+    CHECK(readFile(base + ".dat") == "dat 1");
+
+    // An entry without a .dat leaves no .dat of an earlier run behind
+    CHECK(cache.fetch("k2", base));
+    CHECK(readFile(base + ".frd") == "results 2");
+    CHECK(!std::filesystem::exists(base + ".dat"));
+    CHECK(cache.getStatistics().hits == 2);
+}
+
+void testEviction(const TempDirectory& directory) {
+    std::string cache_dir = directory.file("small");
+    std::string base = directory.file("evict");
+    SolverCache cache;
+    CHECK(cache.open(cache_dir, 15) == 0);
+
+    writeFile(base + ".frd", "0123456789");
+    CHECK(cache.store("old", base) == 0);
+    writeFile(base + ".frd", "abcdefghij");
+    CHECK(cache.store("new", base) == 0);
+
+    // The bound keeps only the entry just stored
+    CHECK(cache.getStatistics().entries == 1);
+    CHECK(cache.getStatistics().evictions == 1);
+    CHECK(!cache.fetch("old", base));
+    CHECK(cache.fetch("new", base));
+    CHECK(readFile(base + ".frd") == "abcdefghij");
+}
+
+void testSharedIndex(const TempDirectory& directory) {
+    // Two caches open on one directory, as two pipelines would be, keep each other's entries
+    std::string cache_dir = directory.file("shared");
+    std::string base = directory.file("shared_job");
+    SolverCache first, second;
+    CHECK(first.open(cache_dir, 1 << 20) == 0);
+    CHECK(second.open(cache_dir, 1 << 20) == 0);
+
+    writeFile(base + ".frd", "first");
+    CHECK(first.store("a", base) == 0);
+    writeFile(base + ".frd", "second");
+    CHECK(second.store("b", base) == 0);
+    CHECK(!second.fetch("c", base));
+
+    SolverCache reopened;
+    CHECK(reopened.open(cache_dir, 1 << 20) == 0);
+    CHECK(reopened.getStatistics().entries == 2);
+    CHECK(reopened.getStatistics().misses == 1);
+    CHECK(reopened.fetch("a", base));
+    CHECK(readFile(base + ".frd") == "first");
+    CHECK(reopened.fetch("b", base));
+
+    // No temporary index is left behind
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+        CHECK(entry.path().extension() != ".tmp");
+    }
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("strecsfem_solver_cache_test");
+    testKeys(directory);
+    testStoreAndFetch(directory);
+    testEviction(directory);
+    testSharedIndex(directory);
+    return testResult("SolverCacheTest");
+}
@@ -0,0 +1,124 @@
+#include "TestCheck.h"
+#include "parallel/TaskScheduler.h"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+void testParallelFor(TaskScheduler& scheduler) {
+    // Every index is visited exactly once, also from nested loops
+    const std::size_t count = 100000;
+    std::vector<std::atomic<int>> visits(count);
+    for (auto& visit : visits) visit.store(0);
+    scheduler.parallelFor(0, count, 64, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) visits[i].fetch_add(1);
+    });
+    bool once = true;
+    for (const auto& visit : visits) once = once && visit.load() == 1;
+    CHECK(once);
+
+    std::atomic<long> sum(0);
+    scheduler.parallelFor(0, 100, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            scheduler.parallelFor(0, 100, 8, [&](std::size_t inner_first, std::size_t inner_last) {
+                long partial = 0;
+                for (std::size_t j = inner_first; j < inner_last; ++j) partial += static_cast<long>(i * j);
+                sum.fetch_add(partial);
+            });
+        }
+    });
+    CHECK(sum.load() == 4950L * 4950L);
+
+    // An empty range runs nothing
+    bool called = false;
+    scheduler.parallelFor(5, 5, 1, [&](std::size_t, std::size_t) { called = true; });
+    CHECK(!called);
+}
+
+void testGroupException(TaskScheduler& scheduler) {
+    // The other tasks still finish before wait rethrows
+    std::atomic<int> finished(0);
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 16; ++i) {
+        group.run([&finished, i]() {
+            if (i == 7) throw std::runtime_error("task 7");
+            finished.fetch_add(1);
+        });
+    }
+    bool thrown = false;
+    try {
+        group.wait();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(finished.load() == 15);
+}
+
+void testGraphOrder(TaskScheduler& scheduler) {
+    // Diamonds chained one after another: each join runs after both of its branches
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) {
+        return [&mutex, &order, id]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+        };
+    };
+
+    TaskGraph graph;
+    std::vector<std::vector<TaskGraph::NodeId>> dependencies;
+    TaskGraph::NodeId join = graph.add(record(0));
+    dependencies.push_back({});
+    for (int level = 0; level < 20; ++level) {
+        TaskGraph::NodeId left = graph.add(record(static_cast<int>(dependencies.size())), {join});
+        dependencies.push_back({join});
+        TaskGraph::NodeId right = graph.add(record(static_cast<int>(dependencies.size())), {join});
+        dependencies.push_back({join});
+        join = graph.add(record(static_cast<int>(dependencies.size())), {left, right});
+        dependencies.push_back({left, right});
+    }
+    graph.run(scheduler);
+
+    CHECK(order.size() == dependencies.size());
+    std::vector<std::size_t> position(dependencies.size(), order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) position[order[i]] = i;
+    for (std::size_t node = 0; node < dependencies.size(); ++node) {
+        CHECK(position[node] < order.size());
+        for (TaskGraph::NodeId dependency : dependencies[node]) {
+            CHECK(position[dependency] < position[node]);
+        }
+    }
+
+    // A failing task stops its successors and is rethrown
+    TaskGraph failing;
+    bool successor_ran = false;
+    TaskGraph::NodeId first = failing.add([]() { throw std::runtime_error("first"); });
+    failing.add([&successor_ran]() { successor_ran = true; }, {first});
+    bool thrown = false;
+    try {
+        failing.run(scheduler);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(!successor_ran);
+}
+
+} // namespace
+
+int main() {
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    for (unsigned threads : {1u, 4u}) {
+        SchedulerOptions options;
+        options.threads = threads;
+        scheduler.configure(options);
+        CHECK(scheduler.getThreadCount() == threads);
+        testParallelFor(scheduler);
+        testGroupException(scheduler);
+        testGraphOrder(scheduler);
+    }
+    return testResult("TaskSchedulerTest");
+}
@@ -0,0 +1,59 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <cmath>
+#include <unistd.h>
+
+// Minimal checks for the unit tests: a failed check is reported with its
+// location and makes the test exit with 1
+
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            ++testFailures();                                                                 \
+        }                                                                                     \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) CHECK(std::abs((a) - (b)) <= (tolerance))
+
+// Exit status of a test program
+inline int testResult(const char* name) {
+    if (testFailures() > 0) {
+        std::cerr << name << ": " << testFailures() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << name << ": OK" << std::endl;
+    return 0;
+}
+
+// Empty directory of its own under the system temp directory, removed on scope exit
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() / (name + "_" + std::to_string(getpid()))) {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+    ~TempDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    std::string file(const std::string& name) const {
+        return (path_ / name).string();
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+#endif // TEST_CHECK_H